@@ -0,0 +1,198 @@
+#include "BenchCommon.hpp"
+#include "SmallArray.hpp"
+
+#include <vector>
+
+// Adds elements one at a time to Array, SmallArray and std::vector.
+// The element counts are the ones the compiler sees: long token and line arrays, and many short lists that are
+// made and thrown away, like a procedure's argument types.
+
+// Not trivially copyable, so growing has to move each one instead of realloc
+struct Owned {
+    u64* Value;
+
+    explicit Owned(u64 value) : Value(new u64(value)) {}
+    Owned(const Owned& other) : Value(new u64(*other.Value)) {}
+    Owned(Owned&& other) noexcept : Value(other.Value) {
+        other.Value = nullptr;
+    }
+    ~Owned() {
+        delete this->Value;
+    }
+};
+
+static_assert(!ArrayRelocatable<Owned>::value, "Owned has to take the moving path");
+
+static u64 Checksum = 0;
+
+template<typename T>
+static T MakeElement(u64 i) {
+    return (T)i;
+}
+
+template<>
+Owned MakeElement<Owned>(u64 i) {
+    return Owned(i);
+}
+
+static u64 ElementValue(u32 value) {
+    return value;
+}
+
+static u64 ElementValue(void* value) {
+    return (u64)value;
+}
+
+static u64 ElementValue(const Owned& value) {
+    return *value.Value;
+}
+
+template<typename T>
+static void PushArray(u64 count, bool reserve) {
+    Array<T> array = Array_Create<T>(reserve ? count : 0);
+    for (u64 i = 0; i < count; i++) {
+        Array_Emplace(array, MakeElement<T>(i));
+    }
+    Checksum += ElementValue(array[count / 2]) + array.Length;
+    Array_Destroy(array);
+}
+
+template<typename T>
+static void PushVector(u64 count, bool reserve) {
+    std::vector<T> vector;
+    if (reserve) {
+        vector.reserve(count);
+    }
+    for (u64 i = 0; i < count; i++) {
+        vector.emplace_back(MakeElement<T>(i));
+    }
+    Checksum += ElementValue(vector[count / 2]) + vector.size();
+}
+
+template<typename T>
+static void PushArena(u64 count, bool reserve) {
+    Arena arena    = Arena_Create(MemoryCategory::Arrays);
+    Array<T> array = Array_Create<T>(arena, reserve ? count : 0);
+    for (u64 i = 0; i < count; i++) {
+        Array_Emplace(array, MakeElement<T>(i));
+    }
+    Checksum += ElementValue(array[count / 2]) + array.Length;
+    Arena_Destroy(arena);
+}
+
+// 'count' lists of 0 to 4 elements each, 'lengths' picks how long
+static void SmallArrays(u64 count, const Array<u8>& lengths) {
+    for (u64 i = 0; i < count; i++) {
+        Array<u32> array = Array_Create<u32>();
+        for (u32 j = 0; j < lengths[i]; j++) {
+            Array_Add(array, j);
+        }
+        Checksum += array.Length;
+        Array_Destroy(array);
+    }
+}
+
+static void SmallSmallArrays(u64 count, const Array<u8>& lengths) {
+    for (u64 i = 0; i < count; i++) {
+        SmallArray<u32, 4> array = SmallArray_Create<u32, 4>();
+        for (u32 j = 0; j < lengths[i]; j++) {
+            SmallArray_Add(array, j);
+        }
+        Checksum += array.Length;
+        SmallArray_Destroy(array);
+    }
+}
+
+static void SmallVectors(u64 count, const Array<u8>& lengths) {
+    for (u64 i = 0; i < count; i++) {
+        std::vector<u32> vector;
+        for (u32 j = 0; j < lengths[i]; j++) {
+            vector.push_back(j);
+        }
+        Checksum += vector.size();
+    }
+}
+
+static void SmallArenaArrays(u64 count, const Array<u8>& lengths) {
+    Arena arena = Arena_Create(MemoryCategory::Arrays);
+    for (u64 i = 0; i < count; i++) {
+        Array<u32> array = Array_Create<u32>(arena);
+        for (u32 j = 0; j < lengths[i]; j++) {
+            Array_Add(array, j);
+        }
+        Checksum += array.Length;
+    }
+    Arena_Destroy(arena);
+}
+
+template<typename Function>
+static f64 Bench_Best(u64 repetitions, Function function) {
+    f64 best = 1e30;
+    for (u64 repetition = 0; repetition <= repetitions; repetition++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        f64 time = Bench_Seconds(start);
+
+        // The first run faults the pages in
+        if (repetition != 0 && time < best) {
+            best = time;
+        }
+    }
+    return best;
+}
+
+static void PrintRow(const char* name, u64 count, f64 array, f64 arena, f64 vector) {
+    f64 scale = 1e9 / (f64)count;
+    Print("%-24s %12.2f %12.2f %12.2f\n", name, array * scale, arena * scale, vector * scale);
+}
+
+template<typename T>
+static void BenchPush(const char* name, u64 count, u64 repetitions, bool reserve) {
+    f64 array  = Bench_Best(repetitions, [&] { PushArray<T>(count, reserve); });
+    f64 arena  = Bench_Best(repetitions, [&] { PushArena<T>(count, reserve); });
+    f64 vector = Bench_Best(repetitions, [&] { PushVector<T>(count, reserve); });
+    PrintRow(name, count, array, arena, vector);
+}
+
+int main(int argc, char** argv) {
+    u64 count       = 4 * 1024 * 1024;
+    u64 repetitions = 10;
+    if (argc > 1) {
+        count = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        repetitions = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    Print("%llu elements, best of %llu, ns per element\n\n", (unsigned long long)count, (unsigned long long)repetitions);
+    Print("%-24s %12s %12s %12s\n", "push", "Array", "arena Array", "std::vector");
+    BenchPush<u32>("u32", count, repetitions, false);
+    BenchPush<void*>("pointer", count, repetitions, false);
+    BenchPush<Owned>("moved only when growing", count / 4, repetitions, false);
+    BenchPush<u32>("u32 reserved", count, repetitions, true);
+    BenchPush<Owned>("moved, reserved", count / 4, repetitions, true);
+
+    // Mostly empty or one element, the way argument lists are
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> lengths  = Array_Create<u8>(count);
+    for (u64 i = 0; i < count; i++) {
+        u64 roll = BenchRandom_Below(random, 10);
+        Array_Add(lengths, (u8)(roll < 4 ? 0 : roll < 7 ? 1 : roll < 9 ? 2 : 4));
+    }
+
+    f64 array      = Bench_Best(repetitions, [&] { SmallArrays(count, lengths); });
+    f64 arena      = Bench_Best(repetitions, [&] { SmallArenaArrays(count, lengths); });
+    f64 vector     = Bench_Best(repetitions, [&] { SmallVectors(count, lengths); });
+    f64 smallArray = Bench_Best(repetitions, [&] { SmallSmallArrays(count, lengths); });
+
+    Print("\n%-24s %12s %12s %12s %12s\n", "short lists, per list", "Array", "arena Array", "std::vector", "SmallArray<4>");
+    f64 scale = 1e9 / (f64)count;
+    Print("%-24s %12.2f %12.2f %12.2f %12.2f\n", "0 to 4 elements", array * scale, arena * scale, vector * scale,
+          smallArray * scale);
+
+    // Keeps the loops from being optimized out
+    Print("\nchecksum %llu\n", (unsigned long long)Checksum);
+
+    Array_Destroy(lengths);
+    return 0;
+}
@@ -0,0 +1,243 @@
+#include "BenchCommon.hpp"
+#include "Parser.hpp"
+#include "Resolver.hpp"
+#include "FlatAst.hpp"
+
+// Resolves and walks the same program as pointer linked Ast nodes and as a FlatAst.
+// The program is one procedure holding many small procedures, so name lookups stay short and the time goes to
+// visiting nodes. Printing is left out, it is all stdio, the two printers are compared by 'TestLang --flat-ast'.
+
+static Array<u8> GenerateProgram(u64 targetSize) {
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> source   = Array_Create<u8>();
+
+    Bench_Append(source, "main :: () {\n");
+    for (u64 i = 0; source.Length < targetSize; i++) {
+        Bench_Append(source, "    p%llu :: () -> int {\n", (unsigned long long)i);
+        Bench_Append(source, "        a :: %llu;\n", (unsigned long long)BenchRandom_Below(random, 100000));
+        Bench_Append(source, "        b :: a;\n");
+        Bench_Append(source, "        c : int : %llu;\n", (unsigned long long)BenchRandom_Below(random, 100000));
+        Bench_Append(source, "        d :: %llu.5;\n", (unsigned long long)BenchRandom_Below(random, 1000));
+        Bench_Append(source, "        e : int : b;\n");
+        Bench_Append(source, "        f :: () { g :: b; h : int : g; }\n");
+        Bench_Append(source, "    }\n");
+    }
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+static u64 WalkAst(Ast* ast) {
+    if (ast == nullptr) {
+        return 0;
+    }
+
+    u64 sum = (u64)ast->Kind;
+    switch (ast->Kind) {
+        case AstKind::File: {
+            sum += WalkAst(ast->File().Scope);
+        } break;
+
+        case AstKind::Scope: {
+            for (u64 i = 0; i < ast->Scope().Statements.Length; i++) {
+                sum += WalkAst(ast->Scope().Statements[i]);
+            }
+        } break;
+
+        case AstKind::Declaration: {
+            sum += WalkAst(ast->Declaration().Name) + WalkAst(ast->Declaration().Type) + WalkAst(ast->Declaration().Value);
+        } break;
+
+        case AstKind::IntegerLiteral: {
+            sum += ast->IntegerLiteral().Value;
+        } break;
+
+        case AstKind::Unary: {
+            sum += WalkAst(ast->Unary().Operand);
+        } break;
+
+        case AstKind::Binary: {
+            sum += WalkAst(ast->Binary().Left) + WalkAst(ast->Binary().Right);
+        } break;
+
+        case AstKind::Procedure: {
+            for (u64 i = 0; i < ast->Procedure().Arguments.Length; i++) {
+                sum += WalkAst(ast->Procedure().Arguments[i]);
+            }
+            sum += WalkAst(ast->Procedure().ReturnType) + WalkAst(ast->Procedure().Body);
+        } break;
+
+        case AstKind::TypePointer: {
+            sum += WalkAst(ast->TypePointer().PointerTo);
+        } break;
+
+        case AstKind::TypeDeref: {
+            sum += WalkAst(ast->TypeDeref().DerefedType);
+        } break;
+
+        case AstKind::TypeProcedure: {
+            for (u64 i = 0; i < ast->TypeProcedure().Arguments.Length; i++) {
+                sum += WalkAst(ast->TypeProcedure().Arguments[i]);
+            }
+            sum += WalkAst(ast->TypeProcedure().ReturnType);
+        } break;
+
+        default:
+            break;
+    }
+    return sum;
+}
+
+static u64 WalkFlatAst(const FlatAst& flat, AstHandle node) {
+    if (node == AST_HANDLE_NONE) {
+        return 0;
+    }
+
+    u64 sum = (u64)flat.Kinds[node];
+    if (flat.Kinds[node] == AstKind::IntegerLiteral) {
+        sum += flat.Values[node];
+    }
+
+    // A scope's ExtraVariablesInScope belong to its procedure, they are walked there
+    u32 first = flat.Kinds[node] == AstKind::Scope ? (u32)flat.Values[node] : 0;
+    for (u32 i = first; i < flat.ChildCount[node]; i++) {
+        sum += WalkFlatAst(flat, FlatAst_GetChild(flat, node, i));
+    }
+    return sum;
+}
+
+// The nodes are stored in walk order, so the whole tree can also be gone over without following a single child
+static u64 ScanFlatAst(const FlatAst& flat, AstHandle root) {
+    u64 sum = 0;
+    for (u64 node = root; node < flat.Kinds.Length; node++) {
+        sum += (u64)flat.Kinds[node];
+        if (flat.Kinds[node] == AstKind::IntegerLiteral) {
+            sum += flat.Values[node];
+        }
+    }
+    return sum;
+}
+
+static u64 FlatAst_GetBytes(const FlatAst& flat) {
+    u64 perNode = sizeof(AstKind) + sizeof(AstCompletion) + sizeof(AstHandle) * 3 + sizeof(u32) * 2 + sizeof(u64);
+    return flat.Kinds.Length * perNode + flat.Children.Length * sizeof(AstHandle) + flat.Symbols.Length * sizeof(FlatAstSymbol);
+}
+
+struct Timings {
+    f64 Build;
+    f64 Resolve;
+    f64 Walk;
+    f64 Scan;
+};
+
+static void Timings_Keep(f64& best, f64 time) {
+    best = time < best ? time : best;
+}
+
+int main(int argc, char** argv) {
+    u64 targetSize  = 8 * 1024 * 1024;
+    u64 repetitions = 10;
+    if (argc > 1) {
+        targetSize = std::strtoull(argv[1], nullptr, 10) * 1024 * 1024;
+    }
+    if (argc > 2) {
+        repetitions = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    Array<u8> source = GenerateProgram(targetSize);
+    String text      = String(source.Data, source.Length);
+
+    Timings pointer  = { 0.0, 1e30, 1e30, 0.0 };
+    Timings flat     = { 1e30, 1e30, 1e30, 1e30 };
+    u64 nodeCount    = 0;
+    u64 pointerBytes = 0;
+    u64 flatBytes    = 0;
+    u64 checksum     = 0;
+
+    // Resolving changes the tree, so every repetition starts from a fresh parse
+    for (u64 repetition = 0; repetition <= repetitions; repetition++) {
+        Arena nodes = Arena_Create(MemoryCategory::Ast);
+        Parser parser(text, nodes);
+        Ast* root = parser.ParseStatement();
+        if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+            Error("The generated program should parse without errors");
+        }
+
+        FlatAst flatAst = FlatAst_Create();
+
+        auto start       = std::chrono::steady_clock::now();
+        AstHandle handle = FlatAst_Build(flatAst, root);
+        f64 buildTime    = Bench_Seconds(start);
+
+        nodeCount    = flatAst.Kinds.Length - handle;
+        pointerBytes = nodes.Stats.BytesAllocated;
+        flatBytes    = FlatAst_GetBytes(flatAst);
+
+        // Walked before resolving, which points declarations at types outside of the tree
+        start               = std::chrono::steady_clock::now();
+        u64 pointerSum      = WalkAst(root);
+        f64 pointerWalkTime = Bench_Seconds(start);
+
+        start            = std::chrono::steady_clock::now();
+        u64 flatSum      = WalkFlatAst(flatAst, handle);
+        f64 flatWalkTime = Bench_Seconds(start);
+
+        start            = std::chrono::steady_clock::now();
+        u64 scanSum      = ScanFlatAst(flatAst, handle);
+        f64 flatScanTime = Bench_Seconds(start);
+
+        if (pointerSum != flatSum || flatSum != scanSum) {
+            Error("The walks should see the same tree");
+        }
+        checksum += pointerSum;
+
+        start = std::chrono::steady_clock::now();
+        ResolveAst(root);
+        f64 pointerResolveTime = Bench_Seconds(start);
+
+        start = std::chrono::steady_clock::now();
+        FlatAst_Resolve(flatAst, handle);
+        f64 flatResolveTime = Bench_Seconds(start);
+
+        // The first run warms the caches and the interner
+        if (repetition != 0) {
+            Timings_Keep(flat.Build, buildTime);
+            Timings_Keep(pointer.Resolve, pointerResolveTime);
+            Timings_Keep(flat.Resolve, flatResolveTime);
+            Timings_Keep(pointer.Walk, pointerWalkTime);
+            Timings_Keep(flat.Walk, flatWalkTime);
+            Timings_Keep(flat.Scan, flatScanTime);
+        }
+
+        FlatAst_Destroy(flatAst);
+        Arena_Destroy(nodes);
+    }
+
+    f64 count = (f64)nodeCount;
+    Print("%llu nodes from %.1f MB of source, best of %llu\n\n",
+          (unsigned long long)nodeCount,
+          (f64)source.Length / 1e6,
+          (unsigned long long)repetitions);
+    Print("%-10s %12s %12s %12s %12s %12s\n", "layout", "bytes/node", "build ns", "resolve ns", "walk ns", "scan ns");
+    Print("%-10s %12.1f %12s %12.2f %12.2f %12s\n",
+          "pointer",
+          (f64)pointerBytes / count,
+          "-",
+          pointer.Resolve * 1e9 / count,
+          pointer.Walk * 1e9 / count,
+          "-");
+    Print("%-10s %12.1f %12.2f %12.2f %12.2f %12.2f\n",
+          "flat",
+          (f64)flatBytes / count,
+          flat.Build * 1e9 / count,
+          flat.Resolve * 1e9 / count,
+          flat.Walk * 1e9 / count,
+          flat.Scan * 1e9 / count);
+
+    // Keeps the walks from being optimized out
+    Print("\nchecksum %llu\n", (unsigned long long)checksum);
+
+    Array_Destroy(source);
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Array.hpp"
+#include "SourceFile.hpp"
+
+#include <chrono>
+#include <cstdarg>
+
+// xorshift64, every benchmark seeds it the same way so the corpora are identical between runs and versions
+struct BenchRandom {
+    u64 State;
+};
+
+inline BenchRandom BenchRandom_Create(u64 seed) {
+    BenchRandom random = {};
+    random.State       = seed != 0 ? seed : 0x9E3779B97F4A7C15;
+    return random;
+}
+
+inline u64 BenchRandom_Next(BenchRandom& random) {
+    random.State ^= random.State << 13;
+    random.State ^= random.State >> 7;
+    random.State ^= random.State << 17;
+    return random.State;
+}
+
+// In [0, bound), the modulo bias does not matter for generating text
+inline u64 BenchRandom_Below(BenchRandom& random, u64 bound) {
+    return BenchRandom_Next(random) % bound;
+}
+
+inline void Bench_Append(Array<u8>& buffer, const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+
+    for (int i = 0; i < length && i < (int)sizeof(text) - 1; i++) {
+        Array_Add(buffer, (u8)text[i]);
+    }
+}
+
+// The lexer needs the same zero padding that SourceFile_Open gives, it is not counted in 'Length'
+inline void Bench_PadSource(Array<u8>& source) {
+    for (u64 i = 0; i < SOURCE_PADDING; i++) {
+        Array_Add(source, (u8)0);
+    }
+    source.Length -= SOURCE_PADDING;
+}
+
+inline f64 Bench_Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,156 @@
+#include "BenchCommon.hpp"
+#include "Parser.hpp"
+#include "Resolver.hpp"
+
+// Resolves a large library of procedures from a few entry points, the way a build that only uses part of a generated
+// library does, and compares that with resolving all of it. Each procedure refers to one earlier procedure and to a
+// constant, so an entry point reaches a short chain of others. The library is parsed again for every run, both modes
+// leave their types in the tree. The entry points have to get the same types either way.
+
+#define BENCH_PROCEDURES_PER_CONSTANT 64
+
+static Array<u8> GenerateProgram(u64 procedureCount) {
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> source   = Array_Create<u8>();
+
+    Bench_Append(source, "main :: () {\n");
+    for (u64 i = 0; i < procedureCount; i++) {
+        u64 constant = i / BENCH_PROCEDURES_PER_CONSTANT * BENCH_PROCEDURES_PER_CONSTANT;
+        if (i == constant) {
+            u64 value = BenchRandom_Below(random, 1000);
+            Bench_Append(source, "    k%llu :: %llu;\n", (unsigned long long)i, (unsigned long long)value);
+        }
+
+        Bench_Append(source, "    p%llu :: (x : int) -> int {\n", (unsigned long long)i);
+        Bench_Append(source, "        a : int : %llu;\n", (unsigned long long)BenchRandom_Below(random, 1000));
+        if (i != 0) {
+            Bench_Append(source, "        b :: p%llu;\n", (unsigned long long)BenchRandom_Below(random, i));
+        }
+        Bench_Append(source, "        c :: k%llu + a;\n", (unsigned long long)constant);
+        Bench_Append(source, "        f :: (z : int) -> int { g :: a; h : int : z; }\n");
+        Bench_Append(source, "    }\n");
+    }
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+static Ast* Bench_Parse(const String& source, Arena& nodes) {
+    Arena_Reset(nodes);
+    Parser parser(source, nodes);
+    Ast* root = parser.ParseStatement();
+    if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+        Error("The generated program should parse without errors");
+    }
+    return root;
+}
+
+// Every 'every'th procedure, spread over the whole library
+static Array<Symbol> Bench_Roots(u64 procedureCount, u64 every) {
+    Array<Symbol> roots = Array_Create<Symbol>();
+    for (u64 i = every - 1; i < procedureCount; i += every) {
+        char name[32];
+        int length = std::snprintf(name, sizeof(name), "p%llu", (unsigned long long)i);
+        Array_Add(roots, Interner_Intern(GlobalInterner, String((u8*)name, (u64)length)));
+    }
+    return roots;
+}
+
+// The type each entry point resolved to
+static void Bench_RootTypes(Ast* ast, const Array<Symbol>& roots, Array<AstType*>& types) {
+    Array_Clear(types);
+    AstScope* topLevel = Resolve_FindTopLevelScope(ast);
+    for (u64 i = 0; i < roots.Length; i++) {
+        Array_Add(types, AstScope_FindSymbol(topLevel, roots[i])->Declaration->Declaration().Type);
+    }
+}
+
+int main(int argc, char** argv) {
+    u64 procedureCount = 100000;
+    u64 repetitions    = 3;
+    if (argc > 1) {
+        procedureCount = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        repetitions = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    Array<u8> program = GenerateProgram(procedureCount);
+    String source     = String(program.Data, program.Length);
+    Arena nodes       = Arena_Create(MemoryCategory::Ast);
+    Print("%llu procedures in %.1f MB, best of %llu\n\n",
+          (unsigned long long)procedureCount,
+          (f64)program.Length / (1024.0 * 1024.0),
+          (unsigned long long)repetitions);
+    Print("%-8s %10s %10s %12s %10s %10s %12s\n",
+          "roots",
+          "resolved",
+          "skipped",
+          "all ms",
+          "demand ms",
+          "check ms",
+          "estimate ms");
+
+    const u64 everies[]         = { 1000, 100, 10, 1 };
+    Array<AstType*> typesAll    = Array_Create<AstType*>();
+    Array<AstType*> typesDemand = Array_Create<AstType*>();
+    for (u64 e = 0; e < sizeof(everies) / sizeof(everies[0]); e++) {
+        Array<Symbol> roots      = Bench_Roots(procedureCount, everies[e]);
+        ResolveDemandStats stats = {};
+        f64 bestAll              = 1e30;
+        f64 bestDemand           = 1e30;
+        f64 bestCheck            = 1e30;
+        f64 bestEstimate         = 1e30;
+
+        // The first run warms the caches and fills the type table
+        for (u64 repetition = 0; repetition <= repetitions; repetition++) {
+            Ast* all   = Bench_Parse(source, nodes);
+            auto start = std::chrono::steady_clock::now();
+            if (!ResolveAst(all)) {
+                Error("The generated program should resolve without errors");
+            }
+            f64 allSeconds = Bench_Seconds(start);
+            Bench_RootTypes(all, roots, typesAll);
+
+            Ast* demand = Bench_Parse(source, nodes);
+            start       = std::chrono::steady_clock::now();
+            if (!ResolveAstOnDemand(demand, roots, stats)) {
+                Error("The generated program should resolve without errors");
+            }
+            f64 demandSeconds = Bench_Seconds(start);
+            Bench_RootTypes(demand, roots, typesDemand);
+
+            if (std::memcmp(typesAll.Data, typesDemand.Data, roots.Length * sizeof(AstType*)) != 0) {
+                Error("Resolving on demand should give the entry points the same types");
+            }
+            if (repetition != 0) {
+                f64 estimate = 0.0;
+                if (!ResolveDemandStats_EstimateSaved(stats, estimate)) {
+                    Error("The entry points are top level declarations, so there should be an estimate");
+                }
+                bestAll      = allSeconds < bestAll ? allSeconds : bestAll;
+                bestDemand   = demandSeconds < bestDemand ? demandSeconds : bestDemand;
+                bestCheck    = stats.CheckSeconds < bestCheck ? stats.CheckSeconds : bestCheck;
+                bestEstimate = estimate < bestEstimate ? estimate : bestEstimate;
+            }
+        }
+
+        // What was saved is the difference of the two, the estimate is what --on-demand prints without resolving it all
+        Print("%-8llu %10llu %10llu %12.2f %10.2f %10.2f %12.2f\n",
+              (unsigned long long)roots.Length,
+              (unsigned long long)stats.DeclarationsResolved,
+              (unsigned long long)stats.DeclarationsSkipped,
+              bestAll * 1e3,
+              bestDemand * 1e3,
+              bestCheck * 1e3,
+              bestEstimate * 1e3);
+        Array_Destroy(roots);
+    }
+
+    Array_Destroy(typesAll);
+    Array_Destroy(typesDemand);
+    Arena_Destroy(nodes);
+    Array_Destroy(program);
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include "BenchCommon.hpp"
+#include "Evaluator.hpp"
+#include "Parser.hpp"
+
+// Evaluates a program of many constants, each derived from two earlier ones, the way generated configuration is.
+// Once in source order, where every constant finds the ones it needs known already, and once starting from the last,
+// which has to go through all of them first. Both should cost the same per constant: each is only evaluated once, and
+// going deep only makes the work stack longer. Without the memo the second would take exponential time.
+
+static Array<u8> GenerateProgram(u64 count) {
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> source   = Array_Create<u8>();
+
+    Bench_Append(source, "main :: () {\n");
+    Bench_Append(source, "    c0 :: %llu;\n", (unsigned long long)BenchRandom_Below(random, 1000));
+    for (u64 i = 1; i < count; i++) {
+        Bench_Append(source,
+                     "    c%llu :: (c%llu + c%llu * %llu) %% 1000003 - %llu;\n",
+                     (unsigned long long)i,
+                     (unsigned long long)i - 1,
+                     (unsigned long long)BenchRandom_Below(random, i),
+                     (unsigned long long)BenchRandom_Below(random, 100),
+                     (unsigned long long)BenchRandom_Below(random, 1000));
+    }
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+// The constants in source order, and a checksum of their values so both orders can be compared
+static f64 Bench_Evaluate(Evaluator& evaluator, AstList<AstStatement*> constants, bool lastFirst, u64& checksum) {
+    Evaluator_Reset(evaluator);
+    auto start = std::chrono::steady_clock::now();
+    checksum   = 0;
+    for (u64 i = 0; i < constants.Length; i++) {
+        ConstValue value = {};
+        u64 index        = lastFirst ? constants.Length - 1 - i : i;
+        if (Evaluator_Evaluate(evaluator, constants[index], value) != EvalStatus::Done) {
+            Error("The generated constants should all evaluate");
+        }
+        checksum = checksum * 31 + (u64)value.Integer;
+    }
+    return Bench_Seconds(start);
+}
+
+int main(int argc, char** argv) {
+    u64 count       = 200000;
+    u64 repetitions = 5;
+    if (argc > 1) {
+        count = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        repetitions = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    Array<u8> source = GenerateProgram(count);
+    Arena nodes      = Arena_Create(MemoryCategory::Ast);
+    Parser parser(String(source.Data, source.Length), nodes);
+    Ast* root = parser.ParseStatement();
+    if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+        Error("The generated program should parse without errors");
+    }
+    AstList<AstStatement*> constants = root->Declaration().Value->Procedure().Body->Scope().Statements;
+
+    // Starting from the last constant puts every one before it on the stack, a few frames each
+    Evaluator evaluator  = Evaluator_Create();
+    evaluator.StackLimit = count * 16;
+    Print("%llu constants, best of %llu\n\n", (unsigned long long)count, (unsigned long long)repetitions);
+    Print("%-12s %12s %12s %12s\n", "order", "ns/constant", "steps", "max stack");
+
+    u64 checksums[2] = {};
+    for (u64 order = 0; order < 2; order++) {
+        // The first run warms the caches
+        f64 best = 1e30;
+        for (u64 repetition = 0; repetition <= repetitions; repetition++) {
+            f64 time = Bench_Evaluate(evaluator, constants, order == 1, checksums[order]);
+            best     = repetition != 0 && time < best ? time : best;
+        }
+        Print("%-12s %12.2f %12llu %12llu\n",
+              order == 0 ? "in order" : "last first",
+              best * 1e9 / (f64)count,
+              (unsigned long long)evaluator.Stats.Steps,
+              (unsigned long long)evaluator.Stats.MaxStack);
+    }
+
+    // The same values either way, only the order they are summed in differs
+    u64 check = 0;
+    for (u64 i = 0; i < constants.Length; i++) {
+        ConstValue value = {};
+        Evaluator_Evaluate(evaluator, constants[i], value);
+        check = check * 31 + (u64)value.Integer;
+    }
+    if (check != checksums[0]) {
+        Error("Evaluating the last constant first should give the same values");
+    }
+
+    Evaluator_Destroy(evaluator);
+    Arena_Destroy(nodes);
+    Array_Destroy(source);
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "BenchCommon.hpp"
+#include "Incremental.hpp"
+#include "Parser.hpp"
+#include "Resolver.hpp"
+
+// Rechecks a large program after a single edit, the way an editor asks for it on every keystroke, and compares that
+// with resolving the edited program from scratch. Procedures refer to earlier procedures and to constants, so one edit
+// can invalidate the ones that refer to what changed:
+//
+//     body       a literal inside one procedure, its type stays the same and nothing else is rechecked
+//     signature  one procedure takes another argument, the ones that refer to it are rechecked but not their callers
+//     constant   one constant changes its value, the procedures that use it are rechecked
+//
+// Parsing is timed on its own, the whole revision is still parsed. Each recheck is compared node by node with the
+// tree resolved from scratch, the types are canonical so the same type has to be the same pointer.
+
+enum struct BenchEdit {
+    None,
+    Body,
+    Signature,
+    Constant,
+};
+
+#define BENCH_LINES_PER_PROCEDURE 7
+#define BENCH_PROCEDURES_PER_CONSTANT 64
+
+static Array<u8> GenerateProgram(u64 procedureCount, BenchEdit edit) {
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> source   = Array_Create<u8>();
+    u64 edited         = procedureCount / 2;
+    u64 editedConstant = edited / BENCH_PROCEDURES_PER_CONSTANT * BENCH_PROCEDURES_PER_CONSTANT;
+
+    Bench_Append(source, "main :: () {\n");
+    for (u64 i = 0; i < procedureCount; i++) {
+        u64 constant = i / BENCH_PROCEDURES_PER_CONSTANT * BENCH_PROCEDURES_PER_CONSTANT;
+        u64 value    = BenchRandom_Below(random, 1000);
+        if (i == constant) {
+            value = edit == BenchEdit::Constant && i == editedConstant ? value + 1 : value;
+            Bench_Append(source, "    k%llu :: %llu;\n", (unsigned long long)i, (unsigned long long)value);
+        }
+
+        const char* arguments = edit == BenchEdit::Signature && i == edited ? "x : int, e : int" : "x : int";
+        Bench_Append(source, "    p%llu :: (%s) -> int {\n", (unsigned long long)i, arguments);
+        value = BenchRandom_Below(random, 1000);
+        value = edit == BenchEdit::Body && i == edited ? value + 1 : value;
+        Bench_Append(source, "        a : int : %llu;\n", (unsigned long long)value);
+        if (i != 0) {
+            Bench_Append(source, "        b :: p%llu;\n", (unsigned long long)BenchRandom_Below(random, i));
+        }
+        Bench_Append(source, "        c :: k%llu + a;\n", (unsigned long long)constant);
+        Bench_Append(source, "        f :: (z : int) -> int { g :: a; h : int : z; }\n");
+        Bench_Append(source, "    }\n");
+    }
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+static Ast* Bench_Parse(const String& source, Arena& nodes, f64& seconds) {
+    auto start = std::chrono::steady_clock::now();
+    Parser parser(source, nodes);
+    Ast* root = parser.ParseStatement();
+    if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+        Error("The generated program should parse without errors");
+    }
+    seconds = Bench_Seconds(start);
+    return root;
+}
+
+// Every node's kind and type in walk order, folded nodes have no children left
+struct TypesPass : AstVisitor<TypesPass> {
+    Array<u64> Types = Array_Create<u64>();
+
+    void EnterNode(Ast* node) {
+        Array_Add(this->Types, (u64)node->Kind);
+        Array_Add(this->Types, (u64)node->Type);
+    }
+};
+
+static bool Bench_SameTypes(Ast* a, Ast* b) {
+    TypesPass typesA;
+    TypesPass typesB;
+    typesA.Walk(a);
+    typesB.Walk(b);
+    bool same = typesA.Types.Length == typesB.Types.Length &&
+                std::memcmp(typesA.Types.Data, typesB.Types.Data, typesA.Types.Length * sizeof(u64)) == 0;
+    Array_Destroy(typesA.Types);
+    Array_Destroy(typesB.Types);
+    return same;
+}
+
+int main(int argc, char** argv) {
+    u64 lineCount   = 1000000;
+    u64 repetitions = 3;
+    if (argc > 1) {
+        lineCount = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        repetitions = std::strtoull(argv[2], nullptr, 10);
+    }
+    u64 procedureCount = lineCount / BENCH_LINES_PER_PROCEDURE + 1;
+
+    Array<u8> original = GenerateProgram(procedureCount, BenchEdit::None);
+    Print("%llu procedures in %.1f MB, best of %llu\n\n",
+          (unsigned long long)procedureCount,
+          (f64)original.Length / (1024.0 * 1024.0),
+          (unsigned long long)repetitions);
+    Print("%-10s %10s %12s %12s %10s %10s %10s\n",
+          "edit",
+          "parse ms",
+          "recheck ms",
+          "scratch ms",
+          "reused",
+          "rechecked",
+          "cut off");
+
+    const BenchEdit edits[]         = { BenchEdit::Body, BenchEdit::Signature, BenchEdit::Constant };
+    const char* editNames[]         = { "body", "signature", "constant" };
+    String originalSource           = String(original.Data, original.Length);
+    IncrementalResolver incremental = IncrementalResolver_Create();
+    Arena nodes                     = Arena_Create(MemoryCategory::Ast);
+    Arena scratchNodes              = Arena_Create(MemoryCategory::Ast);
+    for (u64 e = 0; e < sizeof(edits) / sizeof(edits[0]); e++) {
+        Array<u8> edited    = GenerateProgram(procedureCount, edits[e]);
+        String editedSource = String(edited.Data, edited.Length);
+        f64 bestParse       = 1e30;
+        f64 bestRecheck     = 1e30;
+        f64 bestScratch     = 1e30;
+
+        // The first run warms the caches and fills the type table
+        for (u64 repetition = 0; repetition <= repetitions; repetition++) {
+            Arena_Reset(nodes);
+            Arena_Reset(scratchNodes);
+            IncrementalResolver_Reset(incremental);
+
+            f64 parse = 0.0;
+            if (!IncrementalResolver_Resolve(incremental, Bench_Parse(originalSource, nodes, parse), originalSource)) {
+                Error("The generated program should resolve without errors");
+            }
+
+            Ast* revision = Bench_Parse(editedSource, nodes, parse);
+            auto start    = std::chrono::steady_clock::now();
+            if (!IncrementalResolver_Resolve(incremental, revision, editedSource)) {
+                Error("The edited program should resolve without errors");
+            }
+            f64 recheck = Bench_Seconds(start);
+
+            f64 scratchParse = 0.0;
+            Ast* scratch     = Bench_Parse(editedSource, scratchNodes, scratchParse);
+            start            = std::chrono::steady_clock::now();
+            if (!ResolveAst(scratch)) {
+                Error("The edited program should resolve without errors");
+            }
+            f64 fromScratch = Bench_Seconds(start);
+
+            if (!Bench_SameTypes(revision, scratch)) {
+                Error("Rechecking after a %s edit should give the same types as resolving from scratch", editNames[e]);
+            }
+            if (repetition != 0) {
+                bestParse   = parse < bestParse ? parse : bestParse;
+                bestRecheck = recheck < bestRecheck ? recheck : bestRecheck;
+                bestScratch = fromScratch < bestScratch ? fromScratch : bestScratch;
+            }
+        }
+
+        const IncrementalStats& stats = incremental.Stats;
+        Print("%-10s %10.2f %12.2f %12.2f %10llu %10llu %10llu\n",
+              editNames[e],
+              bestParse * 1e3,
+              bestRecheck * 1e3,
+              bestScratch * 1e3,
+              (unsigned long long)stats.Reused,
+              (unsigned long long)(stats.Edited + stats.Invalidated),
+              (unsigned long long)stats.CutOff);
+        Array_Destroy(edited);
+    }
+
+    IncrementalResolver_Destroy(incremental);
+    Arena_Destroy(nodes);
+    Arena_Destroy(scratchNodes);
+    Array_Destroy(original);
+    return 0;
+}
@@ -0,0 +1,614 @@
+#include "BenchCommon.hpp"
+#include "Lexer.hpp"
+#include "Parser.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <thread>
+
+// Lexer throughput over deterministic synthetic corpora, printed as a table and written as JSON
+// so the numbers can be compared between versions.
+//
+// Usage: TestLang_bench_lexer [--size=MB] [--repetitions=N] [--warmup=N] [--threads=N] [--json=path]
+
+static std::atomic<u64> AllocationCount(0);
+
+#if defined(__GLIBC__)
+// Arrays of plain data grow with realloc, so on glibc the C allocator itself is wrapped and every heap allocation in
+// the process is counted, operator new included since it ends up in malloc
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pointer, size_t size);
+void __libc_free(void* pointer);
+
+void* malloc(size_t size) {
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) {
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) {
+    __libc_free(pointer);
+}
+}
+#else
+// Every operator new in the process goes through here, so a run's allocations can be counted.
+// Alloc() and the realloc growth of plain data arrays go straight to the C allocator and are missed
+void* operator new(std::size_t size) {
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* pointer = std::malloc(size != 0 ? size : 1)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept {
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t size) noexcept {
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t size) noexcept {
+    std::free(pointer);
+}
+#endif
+
+struct Corpus {
+    const char* Name;
+    Array<u8> Source;
+};
+
+// A pool of names that repeat the way names in real code do, a few hot ones and a long tail
+static const char* const NameWords[] = {
+    "index", "count", "value", "result", "buffer", "length", "node", "next", "parent", "child", "left", "right",
+    "size", "data", "offset", "start", "end", "first", "last", "item", "entry", "table", "key", "hash",
+};
+
+static void AppendName(Array<u8>& source, BenchRandom& random) {
+    const char* word = NameWords[BenchRandom_Below(random, sizeof(NameWords) / sizeof(NameWords[0]))];
+    switch (BenchRandom_Below(random, 4)) {
+        case 0: {
+            Bench_Append(source, "%s", word);
+        } break;
+
+        case 1: {
+            Bench_Append(source, "%s%llu", word, (unsigned long long)BenchRandom_Below(random, 16));
+        } break;
+
+        default: {
+            Bench_Append(source, "%s%llu", word, (unsigned long long)BenchRandom_Below(random, 4096));
+        } break;
+    }
+}
+
+static void AppendOperator(Array<u8>& source, BenchRandom& random) {
+    static const char* const operators[] = {
+        "+", "-", "*", "/", "%", "=", "!", "<", ">", "^", "+=", "-=", "*=", "/=", "%=", "==", "!=", "<=", ">=",
+        "(", ")", "{", "}", "[", "]", ":", ";", ",",
+    };
+    Bench_Append(source, "%s", operators[BenchRandom_Below(random, sizeof(operators) / sizeof(operators[0]))]);
+}
+
+static void AppendLiteral(Array<u8>& source, BenchRandom& random) {
+    switch (BenchRandom_Below(random, 4)) {
+        case 0: {
+            Bench_Append(source, "%llu", (unsigned long long)BenchRandom_Below(random, 1000));
+        } break;
+
+        case 1: {
+            Bench_Append(source, "%llu", (unsigned long long)BenchRandom_Next(random));
+        } break;
+
+        case 2: {
+            Bench_Append(source, "0x%llX", (unsigned long long)BenchRandom_Below(random, 1ULL << 32));
+        } break;
+
+        default: {
+            Bench_Append(source, "%.6f", (f64)BenchRandom_Below(random, 100000000) / 1000.0);
+        } break;
+    }
+}
+
+static void GenerateIdentifiers(Array<u8>& source, BenchRandom& random) {
+    for (u64 i = 0; i < 12; i++) {
+        AppendName(source, random);
+        Bench_Append(source, " ");
+    }
+    Bench_Append(source, "\n");
+}
+
+static void GenerateOperators(Array<u8>& source, BenchRandom& random) {
+    for (u64 i = 0; i < 24; i++) {
+        AppendOperator(source, random);
+        // Mostly glued together, '==' next to '=' has to be split the same way either way
+        if (BenchRandom_Below(random, 3) == 0) {
+            Bench_Append(source, " ");
+        }
+    }
+    Bench_Append(source, "\n");
+}
+
+static void GenerateLiterals(Array<u8>& source, BenchRandom& random) {
+    for (u64 i = 0; i < 12; i++) {
+        AppendLiteral(source, random);
+        Bench_Append(source, ", ");
+    }
+    Bench_Append(source, "\n");
+}
+
+static void GenerateWhitespace(Array<u8>& source, BenchRandom& random) {
+    u64 indent = BenchRandom_Below(random, 12);
+    for (u64 i = 0; i < indent; i++) {
+        Bench_Append(source, BenchRandom_Below(random, 4) == 0 ? "\t" : "    ");
+    }
+    AppendName(source, random);
+    for (u64 i = BenchRandom_Below(random, 40); i > 0; i--) {
+        Bench_Append(source, " ");
+    }
+    Bench_Append(source, BenchRandom_Below(random, 2) == 0 ? "\n\n\n" : "\r\n");
+}
+
+// Procedures like the ones in test.lang, this is also the corpus the parser benchmarks read
+static void GenerateMixed(Array<u8>& source, BenchRandom& random) {
+    Bench_Append(source, "    proc%llu :: (", (unsigned long long)BenchRandom_Below(random, 100000));
+    u64 arguments = BenchRandom_Below(random, 4);
+    for (u64 i = 0; i < arguments; i++) {
+        Bench_Append(source, i == 0 ? "" : ", ");
+        AppendName(source, random);
+        Bench_Append(source, BenchRandom_Below(random, 3) == 0 ? ": ^int" : ": int");
+    }
+    Bench_Append(source, ") -> int {\n");
+
+    u64 statements = 1 + BenchRandom_Below(random, 6);
+    for (u64 i = 0; i < statements; i++) {
+        Bench_Append(source, "        ");
+        AppendName(source, random);
+        Bench_Append(source, BenchRandom_Below(random, 2) == 0 ? ": int = " : " := ");
+
+        u64 terms = 1 + BenchRandom_Below(random, 4);
+        for (u64 j = 0; j < terms; j++) {
+            if (j != 0) {
+                static const char* const operators[] = { " + ", " - ", " * ", " / ", " < " };
+                Bench_Append(source, "%s", operators[BenchRandom_Below(random, 5)]);
+            }
+            if (BenchRandom_Below(random, 2) == 0) {
+                AppendName(source, random);
+            } else {
+                AppendLiteral(source, random);
+            }
+        }
+        Bench_Append(source, ";\n");
+    }
+    Bench_Append(source, "    }\n\n");
+}
+
+static Corpus Corpus_Create(const char* name, u64 targetSize, void (*generate)(Array<u8>& source, BenchRandom& random)) {
+    Corpus corpus      = {};
+    corpus.Name        = name;
+    corpus.Source      = Array_Create<u8>();
+    BenchRandom random = BenchRandom_Create(0);
+
+    Array_Reserve(corpus.Source, targetSize + 4096);
+    while (corpus.Source.Length < targetSize) {
+        generate(corpus.Source, random);
+    }
+    Bench_PadSource(corpus.Source);
+    return corpus;
+}
+
+// The parser needs the procedures inside a scope
+static Corpus Corpus_CreateParsable(u64 targetSize) {
+    Corpus corpus      = {};
+    corpus.Name        = "mixed";
+    corpus.Source      = Array_Create<u8>();
+    BenchRandom random = BenchRandom_Create(0);
+
+    Bench_Append(corpus.Source, "{\n");
+    while (corpus.Source.Length < targetSize) {
+        GenerateMixed(corpus.Source, random);
+    }
+    Bench_Append(corpus.Source, "}\n");
+    Bench_PadSource(corpus.Source);
+    return corpus;
+}
+
+// A copy of 'corpus' with mistakes spread evenly over it, so what lexing reports can be compared as well. There are
+// more than DIAGNOSTIC_DEFAULT_LIMIT of them, so some are only counted
+static Corpus Corpus_CreateWithErrors(const Corpus& corpus) {
+    Corpus broken = {};
+    broken.Name   = corpus.Name;
+    broken.Source = Array_Create<u8>(corpus.Source.Length + SOURCE_PADDING);
+
+    u64 lines = 0;
+    for (u64 i = 0; i < corpus.Source.Length; i++) {
+        lines += corpus.Source[i] == '\n';
+    }
+
+    // Each one is an unknown character, a digit too big for its base and a base without digits
+    u64 every = lines / 40 + 1;
+    u64 line  = 0;
+    for (u64 i = 0; i < corpus.Source.Length; i++) {
+        Array_Add(broken.Source, corpus.Source[i]);
+        if (corpus.Source[i] == '\n' && ++line % every == 0) {
+            Bench_Append(broken.Source, "@ 0b12 0x;\n");
+        }
+    }
+    Bench_PadSource(broken.Source);
+    return broken;
+}
+
+static const ScanImplementation ScanImplementations[] = {
+#define SCAN_IMPLEMENTATION(name) ScanImplementation::name,
+    SCAN_IMPLEMENTATIONS
+#undef SCAN_IMPLEMENTATION
+};
+
+struct BenchResult {
+    const char* Corpus;
+    char Mode[32];
+    u64 Bytes;
+    u64 Tokens;
+    f64 MinSeconds;
+    f64 MedianSeconds;
+    u64 Allocations; // In one repetition
+};
+
+struct BenchOptions {
+    u64 Size;
+    u64 Repetitions;
+    u64 Warmup;
+    u32 Threads;
+    const char* JsonPath;
+};
+
+// Runs 'run' warmup + repetitions times, 'run' returns the number of tokens it saw
+template<typename F>
+static BenchResult Bench_Run(const BenchOptions& options, const Corpus& corpus, const char* mode, F run) {
+    BenchResult result = {};
+    result.Corpus      = corpus.Name;
+    result.Bytes       = corpus.Source.Length;
+    std::snprintf(result.Mode, sizeof(result.Mode), "%s", mode);
+
+    for (u64 i = 0; i < options.Warmup; i++) {
+        run();
+    }
+
+    Array<f64> times = Array_Create<f64>();
+    Array_Reserve(times, options.Repetitions);
+    for (u64 i = 0; i < options.Repetitions; i++) {
+        u64 allocations = AllocationCount.load(std::memory_order_relaxed);
+        auto start      = std::chrono::steady_clock::now();
+        result.Tokens   = run();
+        Array_Add(times, Bench_Seconds(start));
+        result.Allocations = AllocationCount.load(std::memory_order_relaxed) - allocations;
+    }
+
+    std::sort(times.Data, times.Data + times.Length);
+    result.MinSeconds    = times[0];
+    result.MedianSeconds = times[times.Length / 2];
+    Array_Destroy(times);
+
+    f64 seconds = result.MedianSeconds;
+    Print("%-12s %-20s %10.1f %12.2f %10.2f %12.4f\n",
+          result.Corpus,
+          result.Mode,
+          (f64)result.Bytes / seconds / 1e6,
+          (f64)result.Tokens / seconds / 1e6,
+          seconds * 1e9 / (f64)result.Tokens,
+          (f64)result.Allocations / (f64)result.Tokens);
+    return result;
+}
+
+static u64 LexNextToken(const Corpus& corpus, const Scanner* scan) {
+    Interner interner = Interner_Create();
+    Lexer lexer(String(corpus.Source.Data, corpus.Source.Length), interner, scan);
+
+    u64 tokens = 1;
+    while (!Token_IsEndOfFile(lexer.NextToken())) {
+        tokens++;
+    }
+
+    Interner_Destroy(interner);
+    return tokens;
+}
+
+static u64 LexTokenizeAll(const Corpus& corpus, const Scanner* scan, u32 threads) {
+    Interner interner   = Interner_Create();
+    Array<Token> tokens = Array_Create<Token>();
+    Lexer lexer(String(corpus.Source.Data, corpus.Source.Length), interner, scan);
+
+    if (threads > 1) {
+        lexer.TokenizeAllParallel(tokens, threads);
+    } else {
+        lexer.TokenizeAll(tokens);
+    }
+    u64 count = tokens.Length;
+
+    Array_Destroy(tokens);
+    Interner_Destroy(interner);
+    return count;
+}
+
+// What one TokenizeAll of a corpus leaves behind, so two ways of lexing it can be compared
+struct LexOutput {
+    Interner Symbols;
+    Array<Token> Tokens;
+    LexerStorage Storage;
+};
+
+static LexOutput LexOutput_Create(const Corpus& corpus, const Scanner* scan, u32 threads) {
+    LexOutput output = {};
+    output.Symbols   = Interner_Create();
+    output.Tokens    = Array_Create<Token>();
+    output.Storage   = LexerStorage_Create();
+
+    // The values and diagnostics are given back to the storage when the lexer goes away
+    {
+        Lexer lexer(String(corpus.Source.Data, corpus.Source.Length), output.Symbols, scan, &output.Storage);
+        if (threads > 1) {
+            lexer.TokenizeAllParallel(output.Tokens, threads);
+        } else {
+            lexer.TokenizeAll(output.Tokens);
+        }
+    }
+    return output;
+}
+
+static void LexOutput_Destroy(LexOutput& output) {
+    Interner_Destroy(output.Symbols);
+    Array_Destroy(output.Tokens);
+    LexerStorage_Destroy(output.Storage);
+}
+
+// Stops the bench unless 'actual' has the same tokens as 'expected', values and names included, the same symbols and
+// the same diagnostics. A faster lexer that gets something wrong would otherwise only show up as a better number
+static void LexOutput_Check(const LexOutput& expected, const LexOutput& actual, const Corpus& corpus, const char* mode) {
+    if (actual.Tokens.Length != expected.Tokens.Length) {
+        Error("%s %s: %llu tokens instead of %llu",
+              corpus.Name,
+              mode,
+              (unsigned long long)actual.Tokens.Length,
+              (unsigned long long)expected.Tokens.Length);
+    }
+
+    for (u64 i = 0; i < expected.Tokens.Length; i++) {
+        const Token& want = expected.Tokens[i];
+        const Token& got  = actual.Tokens[i];
+        bool same         = got.Kind == want.Kind && got.Position == want.Position && got.Length == want.Length;
+        if (same && Token_IsIdentifier(want)) {
+            same = got.Data.Name == want.Data.Name &&
+                   Interner_GetString(actual.Symbols, got.Data.Name) == Interner_GetString(expected.Symbols, want.Data.Name);
+        } else if (same && (Token_IsInteger(want) || Token_IsFloat(want))) {
+            // Compared as bits, so a NaN is the same as itself
+            same = std::memcmp(&actual.Storage.Values[got.Data.ValueIndex],
+                               &expected.Storage.Values[want.Data.ValueIndex],
+                               sizeof(TokenValue)) == 0;
+        }
+
+        if (!same) {
+            Error("%s %s: token %llu at position %u is not the same", corpus.Name, mode, (unsigned long long)i, want.Position);
+        }
+    }
+
+    // Parallel lexing interns each piece on its own and maps the symbols back, the ids have to come out in serial order
+    if (actual.Symbols.Strings.Length != expected.Symbols.Strings.Length) {
+        Error("%s %s: %llu symbols instead of %llu",
+              corpus.Name,
+              mode,
+              (unsigned long long)actual.Symbols.Strings.Length,
+              (unsigned long long)expected.Symbols.Strings.Length);
+    }
+    for (Symbol symbol = 0; symbol < expected.Symbols.Strings.Length; symbol++) {
+        if (Interner_GetString(actual.Symbols, symbol) != Interner_GetString(expected.Symbols, symbol)) {
+            Error("%s %s: symbol %u is not the same", corpus.Name, mode, symbol);
+        }
+    }
+
+    const DiagnosticList& wantDiagnostics = expected.Storage.Diagnostics;
+    const DiagnosticList& gotDiagnostics  = actual.Storage.Diagnostics;
+    if (gotDiagnostics.Records.Length != wantDiagnostics.Records.Length || gotDiagnostics.Dropped != wantDiagnostics.Dropped) {
+        Error("%s %s: %llu diagnostics instead of %llu",
+              corpus.Name,
+              mode,
+              (unsigned long long)DiagnosticList_Count(gotDiagnostics),
+              (unsigned long long)DiagnosticList_Count(wantDiagnostics));
+    }
+    for (u64 i = 0; i < wantDiagnostics.Records.Length; i++) {
+        const Diagnostic& want = wantDiagnostics.Records[i];
+        const Diagnostic& got  = gotDiagnostics.Records[i];
+        bool same              = got.Kind == want.Kind && got.Position == want.Position && got.Length == want.Length;
+        for (u64 j = 0; j < 2; j++) {
+            // The widest member of the union, the rest of it is zeroed when an argument is made
+            same = same && got.Arguments[j].Kind == want.Arguments[j].Kind &&
+                   got.Arguments[j].IntegerValue == want.Arguments[j].IntegerValue;
+        }
+
+        if (!same) {
+            Error("%s %s: diagnostic %llu at position %u is not the same",
+                  corpus.Name,
+                  mode,
+                  (unsigned long long)i,
+                  want.Position);
+        }
+    }
+}
+
+static void WriteJson(const BenchOptions& options, const Array<BenchResult>& results) {
+    FILE* file = std::fopen(options.JsonPath, "wb");
+    if (file == nullptr) {
+        Error("Unable to write '%s'", options.JsonPath);
+    }
+
+    String scan = GetScanImplementationName(Scanner_GetBest()->Implementation);
+    std::fprintf(file, "{\n");
+    std::fprintf(file, "  \"benchmark\": \"lexer\",\n");
+    std::fprintf(file, "  \"scan\": \"%.*s\",\n", (u32)scan.Length, scan.Data);
+    std::fprintf(file, "  \"size\": %llu,\n", (unsigned long long)options.Size);
+    std::fprintf(file, "  \"repetitions\": %llu,\n", (unsigned long long)options.Repetitions);
+    std::fprintf(file, "  \"warmup\": %llu,\n", (unsigned long long)options.Warmup);
+    std::fprintf(file, "  \"results\": [\n");
+    for (u64 i = 0; i < results.Length; i++) {
+        const BenchResult& result = results[i];
+        f64 seconds               = result.MedianSeconds;
+        std::fprintf(file,
+                     "    {\"corpus\": \"%s\", \"mode\": \"%s\", \"bytes\": %llu, \"tokens\": %llu, "
+                     "\"min_seconds\": %.9f, \"median_seconds\": %.9f, \"mb_per_second\": %.3f, "
+                     "\"tokens_per_second\": %.1f, \"ns_per_token\": %.4f, \"allocations_per_token\": %.6f}%s\n",
+                     result.Corpus,
+                     result.Mode,
+                     (unsigned long long)result.Bytes,
+                     (unsigned long long)result.Tokens,
+                     result.MinSeconds,
+                     result.MedianSeconds,
+                     (f64)result.Bytes / seconds / 1e6,
+                     (f64)result.Tokens / seconds,
+                     seconds * 1e9 / (f64)result.Tokens,
+                     (f64)result.Allocations / (f64)result.Tokens,
+                     i + 1 < results.Length ? "," : "");
+    }
+    std::fprintf(file, "  ]\n}\n");
+    std::fclose(file);
+}
+
+int main(int argc, char** argv) {
+    BenchOptions options = {};
+    options.Size         = 8 * 1024 * 1024;
+    options.Repetitions  = 10;
+    options.Warmup       = 2;
+    options.Threads      = std::thread::hardware_concurrency();
+    options.JsonPath     = "bench_lexer.json";
+
+    for (int i = 1; i < argc; i++) {
+        if (std::strncmp(argv[i], "--size=", 7) == 0) {
+            options.Size = std::strtoull(argv[i] + 7, nullptr, 10) * 1024 * 1024;
+        } else if (std::strncmp(argv[i], "--repetitions=", 14) == 0) {
+            options.Repetitions = std::strtoull(argv[i] + 14, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--warmup=", 9) == 0) {
+            options.Warmup = std::strtoull(argv[i] + 9, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--threads=", 10) == 0) {
+            options.Threads = (u32)std::strtoul(argv[i] + 10, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--json=", 7) == 0) {
+            options.JsonPath = argv[i] + 7;
+        } else {
+            Error("Usage: %s [--size=MB] [--repetitions=N] [--warmup=N] [--threads=N] [--json=path]", argv[0]);
+        }
+    }
+    if (options.Size == 0 || options.Repetitions == 0) {
+        Error("The size and repetitions must not be 0");
+    }
+    if (options.Threads == 0) {
+        options.Threads = 1;
+    }
+
+    Corpus corpora[] = {
+        Corpus_Create("identifiers", options.Size, GenerateIdentifiers),
+        Corpus_Create("operators", options.Size, GenerateOperators),
+        Corpus_Create("literals", options.Size, GenerateLiterals),
+        Corpus_Create("whitespace", options.Size, GenerateWhitespace),
+        Corpus_Create("mixed", options.Size, GenerateMixed),
+    };
+
+    Print("%-12s %-20s %10s %12s %10s %12s\n", "corpus", "mode", "MB/s", "Mtokens/s", "ns/token", "allocs/token");
+
+    Array<BenchResult> results = Array_Create<BenchResult>();
+    for (Corpus& corpus : corpora) {
+        const Scanner* best = Scanner_GetBest();
+        LexOutput scalar    = LexOutput_Create(corpus, Scanner_Get(ScanImplementation::Scalar), 1);
+        Array_Add(results, Bench_Run(options, corpus, "next-token", [&]() -> u64 {
+                      return LexNextToken(corpus, best);
+                  }));
+
+        for (ScanImplementation implementation : ScanImplementations) {
+            const Scanner* scan = Scanner_Get(implementation);
+            if (scan == nullptr) {
+                continue;
+            }
+
+            String name = GetScanImplementationName(implementation);
+            char mode[32];
+            std::snprintf(mode, sizeof(mode), "tokenize-all-%.*s", (u32)name.Length, name.Data);
+
+            LexOutput output = LexOutput_Create(corpus, scan, 1);
+            LexOutput_Check(scalar, output, corpus, mode);
+            LexOutput_Destroy(output);
+
+            Array_Add(results, Bench_Run(options, corpus, mode, [&]() -> u64 {
+                          return LexTokenizeAll(corpus, scan, 1);
+                      }));
+        }
+        LexOutput_Destroy(scalar);
+    }
+
+    // How --lex-threads scales, only on the realistic corpus
+    Corpus& mixed          = corpora[4];
+    Corpus broken          = Corpus_CreateWithErrors(mixed);
+    LexOutput serial       = LexOutput_Create(mixed, Scanner_GetBest(), 1);
+    LexOutput brokenSerial = LexOutput_Create(broken, Scanner_GetBest(), 1);
+    for (u32 threads = 2; threads <= options.Threads; threads *= 2) {
+        char mode[32];
+        std::snprintf(mode, sizeof(mode), "parallel-%u", threads);
+
+        LexOutput output = LexOutput_Create(mixed, Scanner_GetBest(), threads);
+        LexOutput_Check(serial, output, mixed, mode);
+        LexOutput_Destroy(output);
+
+        output = LexOutput_Create(broken, Scanner_GetBest(), threads);
+        LexOutput_Check(brokenSerial, output, broken, mode);
+        LexOutput_Destroy(output);
+
+        Array_Add(results, Bench_Run(options, mixed, mode, [&]() -> u64 {
+                      return LexTokenizeAll(mixed, Scanner_GetBest(), threads);
+                  }));
+    }
+    LexOutput_Destroy(serial);
+    LexOutput_Destroy(brokenSerial);
+    Array_Destroy(broken.Source);
+
+    // Streaming against batched parsing, on a smaller corpus of code the parser accepts
+    Corpus parsable = Corpus_CreateParsable(options.Size < 1024 * 1024 ? options.Size : 1024 * 1024);
+    u64 parseTokens = LexTokenizeAll(parsable, Scanner_GetBest(), 1);
+    for (ParserMode mode : { ParserMode::Streaming, ParserMode::Batched }) {
+        const char* name = mode == ParserMode::Streaming ? "parse-streaming" : "parse-batched";
+        Array_Add(results, Bench_Run(options, parsable, name, [&]() -> u64 {
+                      Arena nodes = Arena_Create(MemoryCategory::Ast);
+                      Parser parser(String(parsable.Source.Data, parsable.Source.Length), nodes, mode);
+                      parser.ParseScope();
+                      if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+                          Error("The parser corpus should parse without errors");
+                      }
+                      Arena_Destroy(nodes);
+                      return parseTokens;
+                  }));
+    }
+
+    WriteJson(options, results);
+    Print("\nWrote %s\n", options.JsonPath);
+
+    for (Corpus& corpus : corpora) {
+        Array_Destroy(corpus.Source);
+    }
+    Array_Destroy(parsable.Source);
+    Array_Destroy(results);
+    return 0;
+}
@@ -0,0 +1,198 @@
+#include "BenchCommon.hpp"
+#include "Lexer.hpp"
+
+// Literal heavy inputs shaped like the data tables we generate, every corpus is lexed whole
+// and compared against converting the same literals with strtoull/strtod.
+// The lexer times include the names and separators around the literals, the libc ones do not.
+
+enum struct LiteralKind : u8 {
+    Decimal,
+    Hex,
+    Binary,
+    Float,
+};
+
+struct Literal {
+    u32 Position;
+    LiteralKind Kind;
+};
+
+struct Corpus {
+    const char* Name;
+    Array<u8> Source;
+    Array<Literal> Literals;
+};
+
+static BenchRandom Random = BenchRandom_Create(0);
+
+// Writes a table row of 'columns' literals, each made by 'generate'
+template<typename F>
+static void Corpus_AddRow(Corpus& corpus, u64 row, u64 columns, F generate) {
+    Bench_Append(corpus.Source, "row%llu :: [", (unsigned long long)row);
+    for (u64 i = 0; i < columns; i++) {
+        Literal literal  = {};
+        literal.Position = (u32)corpus.Source.Length;
+        literal.Kind     = generate(corpus.Source);
+        Array_Add(corpus.Literals, literal);
+        Bench_Append(corpus.Source, i + 1 < columns ? ", " : "];\n");
+    }
+}
+
+static Corpus Corpus_Create(const char* name, u64 targetSize, LiteralKind (*generate)(Array<u8>& source)) {
+    Corpus corpus   = {};
+    corpus.Name     = name;
+    corpus.Source   = Array_Create<u8>();
+    corpus.Literals = Array_Create<Literal>();
+
+    for (u64 row = 0; corpus.Source.Length < targetSize; row++) {
+        Corpus_AddRow(corpus, row, 16, generate);
+    }
+
+    Bench_PadSource(corpus.Source);
+    return corpus;
+}
+
+static LiteralKind GenerateSmallInteger(Array<u8>& source) {
+    Bench_Append(source, "%llu", (unsigned long long)BenchRandom_Below(Random, 100000));
+    return LiteralKind::Decimal;
+}
+
+static LiteralKind GenerateLargeInteger(Array<u8>& source) {
+    Bench_Append(source, "%llu", (unsigned long long)BenchRandom_Below(Random, 10000000000000000000ULL));
+    return LiteralKind::Decimal;
+}
+
+static LiteralKind GenerateHex(Array<u8>& source) {
+    if (BenchRandom_Below(Random, 4) == 0) {
+        u64 bits = BenchRandom_Below(Random, 1 << 12);
+        Bench_Append(source, "0b");
+        for (u64 i = 0; i < 12; i++) {
+            Bench_Append(source, (bits >> i) & 1 ? "1" : "0");
+        }
+        return LiteralKind::Binary;
+    }
+    Bench_Append(source, "0x%llX", (unsigned long long)(BenchRandom_Next(Random) >> BenchRandom_Below(Random, 48)));
+    return LiteralKind::Hex;
+}
+
+static LiteralKind GenerateShortFloat(Array<u8>& source) {
+    Bench_Append(source, "%.3f", (f64)BenchRandom_Below(Random, 10000000) / 1000.0);
+    return LiteralKind::Float;
+}
+
+static LiteralKind GenerateLongFloat(Array<u8>& source) {
+    f64 value = (f64)(BenchRandom_Next(Random) >> 11) / (f64)(1ULL << 53);
+    Bench_Append(source, "%.17e", value * (f64)(BenchRandom_Below(Random, 1000) + 1));
+    return LiteralKind::Float;
+}
+
+static LiteralKind GenerateMixed(Array<u8>& source) {
+    switch (BenchRandom_Below(Random, 4)) {
+        case 0:
+            return GenerateSmallInteger(source);
+        case 1:
+            return GenerateHex(source);
+        case 2:
+            return GenerateShortFloat(source);
+        default:
+            return GenerateLongFloat(source);
+    }
+}
+
+static f64 BenchLexer(const Corpus& corpus, u64 repetitions, u64& checksum) {
+    Array<Token> tokens = Array_Create<Token>();
+    Interner interner   = Interner_Create();
+
+    f64 best = 1e30;
+    for (u64 i = 0; i < repetitions; i++) {
+        Array_Clear(tokens);
+
+        auto start = std::chrono::steady_clock::now();
+        Lexer lexer(String(corpus.Source.Data, corpus.Source.Length), interner);
+        lexer.TokenizeAll(tokens);
+        f64 time = Bench_Seconds(start);
+        best     = time < best ? time : best;
+
+        if (DiagnosticList_Count(lexer.Diagnostics) != 0) {
+            Error("The '%s' corpus should lex without errors", corpus.Name);
+        }
+        checksum += lexer.Values.Length;
+    }
+
+    Interner_Destroy(interner);
+    Array_Destroy(tokens);
+    return best;
+}
+
+static f64 BenchLibC(const Corpus& corpus, u64 repetitions, u64& checksum) {
+    f64 best = 1e30;
+    for (u64 i = 0; i < repetitions; i++) {
+        auto start = std::chrono::steady_clock::now();
+        for (u64 j = 0; j < corpus.Literals.Length; j++) {
+            const char* text = (const char*)&corpus.Source[corpus.Literals[j].Position];
+            switch (corpus.Literals[j].Kind) {
+                case LiteralKind::Decimal: {
+                    checksum += std::strtoull(text, nullptr, 10);
+                } break;
+
+                case LiteralKind::Hex: {
+                    checksum += std::strtoull(text + 2, nullptr, 16);
+                } break;
+
+                case LiteralKind::Binary: {
+                    checksum += std::strtoull(text + 2, nullptr, 2);
+                } break;
+
+                case LiteralKind::Float: {
+                    checksum += (u64)std::strtod(text, nullptr);
+                } break;
+            }
+        }
+        f64 time = Bench_Seconds(start);
+        best     = time < best ? time : best;
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    u64 targetSize  = 16 * 1024 * 1024;
+    u64 repetitions = 10;
+    if (argc > 1) {
+        targetSize = std::strtoull(argv[1], nullptr, 10) * 1024 * 1024;
+    }
+
+    Corpus corpora[] = {
+        Corpus_Create("small integers", targetSize, GenerateSmallInteger),
+        Corpus_Create("large integers", targetSize, GenerateLargeInteger),
+        Corpus_Create("hex and binary", targetSize, GenerateHex),
+        Corpus_Create("short floats", targetSize, GenerateShortFloat),
+        Corpus_Create("long floats", targetSize, GenerateLongFloat),
+        Corpus_Create("mixed table", targetSize, GenerateMixed),
+    };
+
+    Print("%-16s %10s %12s %12s %16s\n", "corpus", "MB/s", "Mliterals/s", "ns/literal", "libc ns/literal");
+
+    u64 checksum = 0;
+    for (Corpus& corpus : corpora) {
+        // The first run warms the caches and the interner
+        BenchLexer(corpus, 1, checksum);
+
+        f64 lexTime  = BenchLexer(corpus, repetitions, checksum);
+        f64 libcTime = BenchLibC(corpus, repetitions, checksum);
+        f64 count    = (f64)corpus.Literals.Length;
+
+        Print("%-16s %10.1f %12.1f %12.2f %16.2f\n",
+              corpus.Name,
+              (f64)corpus.Source.Length / lexTime / 1e6,
+              count / lexTime / 1e6,
+              lexTime * 1e9 / count,
+              libcTime * 1e9 / count);
+
+        Array_Destroy(corpus.Source);
+        Array_Destroy(corpus.Literals);
+    }
+
+    // Keeps the libc calls from being optimized out
+    Print("checksum %llu\n", (unsigned long long)checksum);
+    return 0;
+}
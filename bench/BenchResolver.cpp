@@ -0,0 +1,114 @@
+#include "BenchCommon.hpp"
+#include "Parser.hpp"
+#include "Resolver.hpp"
+#include "TypeTable.hpp"
+
+// Resolves a program of many small procedures, and one where every procedure refers to the next one, so resolving the
+// first has to go through all of them before it can finish. The second would need one C++ stack frame per procedure if
+// the resolver recursed. Neither should allocate per node, only the work stack grows now and then.
+
+static Array<u8> GenerateProcedures(u64 targetSize) {
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> source   = Array_Create<u8>();
+
+    Bench_Append(source, "main :: () {\n");
+    for (u64 i = 0; source.Length < targetSize; i++) {
+        Bench_Append(source, "    p%llu :: (x : int, y : ^int) -> int {\n", (unsigned long long)i);
+        Bench_Append(source, "        a :: %llu;\n", (unsigned long long)BenchRandom_Below(random, 1000));
+        Bench_Append(source, "        b : int : a;\n");
+        Bench_Append(source, "        c : ^int : y;\n");
+        Bench_Append(source, "        f :: (z : int) -> int { g :: b; h : int : z; }\n");
+        Bench_Append(source, "    }\n");
+    }
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+static Array<u8> GenerateChain(u64 depth) {
+    Array<u8> source = Array_Create<u8>();
+
+    Bench_Append(source, "main :: () {\n");
+    for (u64 i = 0; i < depth; i++) {
+        Bench_Append(source, "    p%llu :: () { x :: p%llu; }\n", (unsigned long long)i, (unsigned long long)i + 1);
+    }
+    Bench_Append(source, "    p%llu :: () {}\n", (unsigned long long)depth);
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+static void BenchResolve(const char* name, const Array<u8>& source, u64 repetitions) {
+    f64 best         = 1e30;
+    u64 nodeCount    = 0;
+    u64 allocations  = 0;
+    u64 allocatedFor = 0;
+
+    // Resolving changes the tree, so every repetition starts from a fresh parse
+    for (u64 repetition = 0; repetition <= repetitions; repetition++) {
+        Arena nodes = Arena_Create(MemoryCategory::Ast);
+        Parser parser(String(source.Data, source.Length), nodes);
+        Ast* root = parser.ParseStatement();
+        if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+            Error("The generated program should parse without errors");
+        }
+
+        AstStats stats = {};
+        Ast_CollectStats(root, stats);
+        nodeCount = 0;
+        for (u64 i = 0; i < AstKindCount; i++) {
+            nodeCount += stats.Kinds[i].Count;
+        }
+
+        // Counts the type table's pages too, those are per distinct type and not per node
+        u64 allocationsBefore = GlobalMemoryStats.Total.Allocations.load(std::memory_order_relaxed);
+        auto start            = std::chrono::steady_clock::now();
+        if (!ResolveAst(root)) {
+            Error("The generated program should resolve without errors");
+        }
+        f64 time = Bench_Seconds(start);
+
+        // The first run warms the caches and fills the type table
+        if (repetition != 0) {
+            best = time < best ? time : best;
+            allocations += GlobalMemoryStats.Total.Allocations.load(std::memory_order_relaxed) - allocationsBefore;
+            allocatedFor += nodeCount;
+        }
+        Arena_Destroy(nodes);
+    }
+
+    Print("%-12s %12llu %12.2f %18.6f\n",
+          name,
+          (unsigned long long)nodeCount,
+          best * 1e9 / (f64)nodeCount,
+          allocatedFor == 0 ? 0.0 : (f64)allocations / (f64)allocatedFor);
+}
+
+int main(int argc, char** argv) {
+    u64 targetSize  = 8 * 1024 * 1024;
+    u64 depth       = 100000;
+    u64 repetitions = 5;
+    if (argc > 1) {
+        targetSize = std::strtoull(argv[1], nullptr, 10) * 1024 * 1024;
+    }
+    if (argc > 2) {
+        depth = std::strtoull(argv[2], nullptr, 10);
+    }
+    if (argc > 3) {
+        repetitions = std::strtoull(argv[3], nullptr, 10);
+    }
+
+    Array<u8> procedures = GenerateProcedures(targetSize);
+    Array<u8> chain      = GenerateChain(depth);
+
+    Print("best of %llu, a chain %llu procedures deep\n\n", (unsigned long long)repetitions, (unsigned long long)depth);
+    Print("%-12s %12s %12s %18s\n", "program", "nodes", "ns/node", "allocations/node");
+    BenchResolve("procedures", procedures, repetitions);
+    BenchResolve("chain", chain, repetitions);
+
+    Array_Destroy(chain);
+    Array_Destroy(procedures);
+    return 0;
+}
@@ -0,0 +1,125 @@
+#include "BenchCommon.hpp"
+#include "Parser.hpp"
+#include "Resolver.hpp"
+#include "TypeTable.hpp"
+
+#include <cstring>
+#include <thread>
+
+// Resolves the same program with 1, 2, 4 ... threads. Every procedure refers to a few earlier ones anywhere in the
+// program, so threads keep running into declarations another one is in the middle of. A procedure's type needs its body
+// resolved, so referring to later ones as well would make cycles. Each run is checked against a serial one node by
+// node, the types are canonical so the same type has to be the same pointer.
+
+static Array<u8> GenerateProgram(u64 targetSize) {
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> source   = Array_Create<u8>();
+
+    u64 procedureCount = targetSize / 160 + 1;
+    Bench_Append(source, "main :: () {\n");
+    for (u64 i = 0; i < procedureCount; i++) {
+        Bench_Append(source, "    p%llu :: (x : int, y : ^int) -> int {\n", (unsigned long long)i);
+        Bench_Append(source, "        a : int : %llu;\n", (unsigned long long)BenchRandom_Below(random, 1000));
+        if (i != 0) {
+            Bench_Append(source, "        b :: p%llu;\n", (unsigned long long)BenchRandom_Below(random, i));
+            Bench_Append(source, "        c :: p%llu;\n", (unsigned long long)BenchRandom_Below(random, i));
+        }
+        Bench_Append(source, "        f :: (z : int) -> int { g :: a; h : int : z; }\n");
+        Bench_Append(source, "    }\n");
+    }
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+// Every node's type in walk order, and the declared type of declarations
+struct TypesPass : AstVisitor<TypesPass> {
+    Array<AstType*> Types = Array_Create<AstType*>();
+
+    void EnterNode(Ast* node) {
+        Array_Add(this->Types, node->Type);
+    }
+
+    void EnterDeclaration(AstDeclaration* node) {
+        Array_Add(this->Types, node->Declaration().Type);
+    }
+};
+
+struct BenchRun {
+    f64 Seconds;
+    u64 NodeCount;
+    Array<AstType*> Types;
+};
+
+static BenchRun Bench_Resolve(const Array<u8>& source, u32 threadCount) {
+    Arena nodes = Arena_Create(MemoryCategory::Ast);
+    Parser parser(String(source.Data, source.Length), nodes);
+    Ast* root = parser.ParseStatement();
+    if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+        Error("The generated program should parse without errors");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    if (!ResolveAstParallel(root, threadCount)) {
+        Error("The generated program should resolve without errors");
+    }
+
+    BenchRun run = {};
+    run.Seconds  = Bench_Seconds(start);
+    TypesPass types;
+    types.Walk(root);
+    run.Types     = types.Types;
+    run.NodeCount = types.Types.Length;
+
+    // The canonical types live in the type table, not in the tree, so they outlive it
+    Arena_Destroy(nodes);
+    return run;
+}
+
+int main(int argc, char** argv) {
+    u64 targetSize  = 8 * 1024 * 1024;
+    u32 maxThreads  = std::thread::hardware_concurrency();
+    u64 repetitions = 5;
+    if (argc > 1) {
+        targetSize = std::strtoull(argv[1], nullptr, 10) * 1024 * 1024;
+    }
+    if (argc > 2) {
+        maxThreads = (u32)std::strtoul(argv[2], nullptr, 10);
+    }
+    if (argc > 3) {
+        repetitions = std::strtoull(argv[3], nullptr, 10);
+    }
+    maxThreads = maxThreads != 0 ? maxThreads : 1;
+
+    Array<u8> source = GenerateProgram(targetSize);
+
+    // Also warms the caches and fills the type table
+    BenchRun serial = Bench_Resolve(source, 1);
+
+    Print("%.1f MB of source, best of %llu\n\n", (f64)source.Length / (1024.0 * 1024.0), (unsigned long long)repetitions);
+    Print("%-8s %12s %12s\n", "threads", "ns/node", "speedup");
+    f64 single = 0.0;
+    for (u32 threadCount = 1;; threadCount = threadCount * 2 < maxThreads ? threadCount * 2 : maxThreads) {
+        f64 best = 1e30;
+        for (u64 repetition = 0; repetition < repetitions; repetition++) {
+            BenchRun run = Bench_Resolve(source, threadCount);
+            if (run.Types.Length != serial.Types.Length ||
+                std::memcmp(run.Types.Data, serial.Types.Data, run.Types.Length * sizeof(AstType*)) != 0) {
+                Error("Resolving with %u threads should give the same types as resolving serially", threadCount);
+            }
+            best = run.Seconds < best ? run.Seconds : best;
+            Array_Destroy(run.Types);
+        }
+
+        single = threadCount == 1 ? best : single;
+        Print("%-8u %12.2f %12.2f\n", threadCount, best * 1e9 / (f64)serial.NodeCount, single / best);
+        if (threadCount == maxThreads) {
+            break;
+        }
+    }
+
+    Array_Destroy(serial.Types);
+    Array_Destroy(source);
+    return 0;
+}
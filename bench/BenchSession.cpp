@@ -0,0 +1,131 @@
+#include "BenchCommon.hpp"
+#include "CompilationSession.hpp"
+#include "Resolver.hpp"
+#include "TypeTable.hpp"
+
+// Parses and resolves many small files in one process, the way a build server or language server would.
+// Once with everything made and given back for every file, once in a CompilationSession that is reset between them.
+// The session should be faster, and its live memory should stop growing after the biggest file has been seen.
+
+// Files of a few to a few hundred procedures, all different so the names and types change from file to file
+static Array<Array<u8>> GeneratePrograms(u64 count) {
+    BenchRandom random        = BenchRandom_Create(0);
+    Array<Array<u8>> programs = Array_Create<Array<u8>>(count);
+
+    for (u64 program = 0; program < count; program++) {
+        Array<u8> source = Array_Create<u8>();
+        u64 procedures   = 1 + BenchRandom_Below(random, program % 8 == 0 ? 400 : 40);
+
+        Bench_Append(source, "main :: () {\n");
+        for (u64 i = 0; i < procedures; i++) {
+            u64 name = BenchRandom_Below(random, 1000000);
+            Bench_Append(source, "    p%llux%llu :: () -> int {\n", (unsigned long long)program, (unsigned long long)i);
+            Bench_Append(source, "        v%llu :: %llu;\n", (unsigned long long)name, (unsigned long long)i);
+            Bench_Append(source, "        w : int : v%llu;\n", (unsigned long long)name);
+            Bench_Append(source, "        x :: %llu.5;\n", (unsigned long long)BenchRandom_Below(random, 1000));
+            Bench_Append(source, "        f :: () { g :: w; h : int : g; }\n");
+            Bench_Append(source, "    }\n");
+        }
+        Bench_Append(source, "}\n");
+
+        Bench_PadSource(source);
+        Array_AddMove(programs, std::move(source));
+    }
+    return programs;
+}
+
+static u64 CompileProgram(const Array<u8>& program, Arena& nodes, ParserStorage* storage) {
+    Parser parser(String(program.Data, program.Length), nodes, ParserMode::Batched, 1, storage);
+    AstStatement* statement = parser.ParseStatement();
+    if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+        Error("The generated programs should parse without errors");
+    }
+    if (!ResolveAst(statement)) {
+        Error("The generated programs should resolve without errors");
+    }
+    return nodes.Stats.BytesAllocated;
+}
+
+// Everything is made for the file and given back after it, names and types included
+static u64 CompileFresh(const Array<u8>& program) {
+    Interner_Destroy(GlobalInterner);
+    TypeTable_Destroy(GlobalTypes);
+    GlobalInterner = Interner_Create();
+    GlobalTypes    = TypeTable_Create();
+
+    Arena nodes = Arena_Create(MemoryCategory::Ast);
+    u64 bytes   = CompileProgram(program, nodes, nullptr);
+    Arena_Destroy(nodes);
+    return bytes;
+}
+
+static u64 CompileInSession(CompilationSession& session, const Array<u8>& program) {
+    CompilationSession_Reset(session);
+    return CompileProgram(program, session.Nodes, &session.Parsing);
+}
+
+static void PrintMemory(const char* mode, u64 files) {
+    Print("%-10s %8llu files %14llu live bytes %10.1f MB peak resident\n",
+          mode,
+          (unsigned long long)files,
+          (unsigned long long)GlobalMemoryStats.Total.LiveBytes.load(std::memory_order_relaxed),
+          (f64)Memory_GetPeakResidentBytes() / (1024.0 * 1024.0));
+}
+
+int main(int argc, char** argv) {
+    u64 files    = 10000;
+    u64 distinct = 256;
+    if (argc > 1) {
+        files = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        distinct = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    Array<Array<u8>> programs = GeneratePrograms(distinct);
+    u64 sourceBytes           = 0;
+    for (u64 i = 0; i < files; i++) {
+        sourceBytes += programs[i % distinct].Length;
+    }
+    Print("%llu files, %llu different ones, %.1f MB of source\n\n",
+          (unsigned long long)files,
+          (unsigned long long)distinct,
+          (f64)sourceBytes / (1024.0 * 1024.0));
+
+    u64 checksum = 0;
+
+    // Live memory goes back down after every file, the cost is in mapping and faulting the pages in again
+    auto start = std::chrono::steady_clock::now();
+    for (u64 i = 0; i < files; i++) {
+        checksum += CompileFresh(programs[i % distinct]);
+    }
+    f64 freshTime = Bench_Seconds(start);
+    PrintMemory("fresh", files);
+
+    CompilationSession session = CompilationSession_Create();
+    start                      = std::chrono::steady_clock::now();
+    for (u64 i = 0; i < files; i++) {
+        checksum += CompileInSession(session, programs[i % distinct]);
+
+        // Every program has been seen once by the first checkpoint, after that this should not move
+        u64 done = i + 1;
+        if (done == distinct || done == files || done % (files / 4 != 0 ? files / 4 : 1) == 0) {
+            PrintMemory("session", done);
+        }
+    }
+    f64 sessionTime = Bench_Seconds(start);
+    CompilationSession_Destroy(session);
+
+    Print("\n%-10s %12s %12s\n", "", "us per file", "MB/s");
+    Print("%-10s %12.2f %12.1f\n", "fresh", freshTime * 1e6 / (f64)files, (f64)sourceBytes / freshTime / 1e6);
+    Print("%-10s %12.2f %12.1f\n", "session", sessionTime * 1e6 / (f64)files, (f64)sourceBytes / sessionTime / 1e6);
+
+    // Keeps the loops from being optimized out
+    Print("\nchecksum %llu\n", (unsigned long long)checksum);
+
+    for (u64 i = 0; i < programs.Length; i++) {
+        Array_Destroy(programs[i]);
+    }
+    Array_Destroy(programs);
+    return 0;
+}
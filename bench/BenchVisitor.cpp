@@ -0,0 +1,245 @@
+#include "BenchCommon.hpp"
+#include "Parser.hpp"
+
+// Runs up to four independent passes over the same tree, once as a walk each and once fused into a single walk.
+// The fused walk follows every child pointer once however many passes there are, so it should cost about one walk
+// plus the work the passes do. The tree is walked as parsed, nothing here needs it resolved.
+
+static Array<u8> GenerateProgram(u64 targetSize) {
+    BenchRandom random = BenchRandom_Create(0);
+    Array<u8> source   = Array_Create<u8>();
+
+    Bench_Append(source, "main :: () {\n");
+    for (u64 i = 0; source.Length < targetSize; i++) {
+        Bench_Append(source, "    p%llu :: () -> int {\n", (unsigned long long)i);
+        Bench_Append(source,
+                     "        a :: %llu + %llu * 2;\n",
+                     (unsigned long long)BenchRandom_Below(random, 1000),
+                     (unsigned long long)BenchRandom_Below(random, 1000));
+        Bench_Append(source, "        b :: a - 1;\n");
+        Bench_Append(source, "        c : int : -%llu;\n", (unsigned long long)BenchRandom_Below(random, 100000));
+        Bench_Append(source, "        d :: (a + b) * %llu;\n", (unsigned long long)BenchRandom_Below(random, 100));
+        Bench_Append(source, "        e : ^int : %llu.5;\n", (unsigned long long)BenchRandom_Below(random, 1000));
+        Bench_Append(source, "        f :: (x : int) -> int { g :: b; h : int : g; }\n");
+        Bench_Append(source, "    }\n");
+    }
+    Bench_Append(source, "}\n");
+
+    Bench_PadSource(source);
+    return source;
+}
+
+// Visits nothing, what the walk costs by itself
+struct EmptyPass : AstVisitor<EmptyPass> {};
+
+// How deep the tree goes
+struct DepthPass : AstVisitor<DepthPass> {
+    u64 Depth    = 0;
+    u64 MaxDepth = 0;
+
+    void EnterNode(Ast* node) {
+        this->Depth++;
+        this->MaxDepth = this->Depth > this->MaxDepth ? this->Depth : this->MaxDepth;
+    }
+
+    void LeaveNode(Ast* node) {
+        this->Depth--;
+    }
+};
+
+// What a constant folder looks for, operators with only literals under them
+struct ConstantPass : AstVisitor<ConstantPass> {
+    u64 Foldable = 0;
+    u64 Sum      = 0;
+
+    void LeaveUnary(AstUnary* node) {
+        Ast* operand = node->Unary().Operand;
+        if (Ast_IsIntegerLiteral(operand) && node->Unary().Operator.Kind == TokenKind::Minus) {
+            this->Foldable++;
+            this->Sum += 0 - operand->IntegerLiteral().Value;
+        }
+    }
+
+    void LeaveBinary(AstBinary* node) {
+        Ast* left  = node->Binary().Left;
+        Ast* right = node->Binary().Right;
+        if (!Ast_IsIntegerLiteral(left) || !Ast_IsIntegerLiteral(right)) {
+            return;
+        }
+
+        u64 a = left->IntegerLiteral().Value;
+        u64 b = right->IntegerLiteral().Value;
+        switch (node->Binary().Operator.Kind) {
+            case TokenKind::Plus: {
+                this->Sum += a + b;
+            } break;
+
+            case TokenKind::Minus: {
+                this->Sum += a - b;
+            } break;
+
+            case TokenKind::Asterisk: {
+                this->Sum += a * b;
+            } break;
+
+            default:
+                return;
+        }
+        this->Foldable++;
+    }
+};
+
+// Checks that every child is of a kind that is allowed where it is
+struct ValidatePass : AstVisitor<ValidatePass> {
+    u64 Problems = 0;
+
+    void EnterScope(AstScope* node) {
+        for (u64 i = 0; i < node->Scope().Statements.Length; i++) {
+            this->Problems += !Ast_IsStatement(node->Scope().Statements[i]);
+        }
+    }
+
+    void EnterDeclaration(AstDeclaration* node) {
+        AstDeclarationData& data = node->Declaration();
+        this->Problems += !Ast_IsName(data.Name);
+        this->Problems += data.Type != nullptr && !Ast_IsType(data.Type);
+        this->Problems += data.Value != nullptr && !Ast_IsExpression(data.Value);
+    }
+
+    void EnterProcedure(AstProcedure* node) {
+        for (u64 i = 0; i < node->Procedure().Arguments.Length; i++) {
+            this->Problems += !Ast_IsDeclaration(node->Procedure().Arguments[i]);
+        }
+        this->Problems += !Ast_IsScope(node->Procedure().Body);
+    }
+
+    void EnterNode(Ast* node) {
+        this->Problems += node->ParentScope != nullptr && !Ast_IsScope(node->ParentScope);
+    }
+};
+
+static u64 Checksum = 0;
+
+static void Passes_Keep(const AstStats& stats,
+                        const DepthPass& depth,
+                        const ConstantPass& constants,
+                        const ValidatePass& validate) {
+    if (validate.Problems != 0) {
+        Error("The generated program should be well formed, found %llu problems", validate.Problems);
+    }
+    Checksum += stats.Kinds[(u64)AstKind::Declaration].Count + depth.MaxDepth + constants.Foldable + constants.Sum;
+}
+
+template<typename Function>
+static f64 Bench_Best(u64 repetitions, Function function) {
+    f64 best = 1e30;
+    for (u64 repetition = 0; repetition <= repetitions; repetition++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        f64 time = Bench_Seconds(start);
+
+        // The first run brings the tree into the cache
+        if (repetition != 0 && time < best) {
+            best = time;
+        }
+    }
+    return best;
+}
+
+// The first 'passes' of stats, depth, constants and validation, walked one at a time
+static void RunSeparate(Ast* root, u64 passes) {
+    AstStats stats = {};
+    AstStatsPass statsPass(stats);
+    DepthPass depth;
+    ConstantPass constants;
+    ValidatePass validate;
+
+    statsPass.Walk(root);
+    if (passes > 1) {
+        depth.Walk(root);
+    }
+    if (passes > 2) {
+        constants.Walk(root);
+    }
+    if (passes > 3) {
+        validate.Walk(root);
+    }
+    Passes_Keep(stats, depth, constants, validate);
+}
+
+static void RunFused(Ast* root, u64 passes) {
+    AstStats stats = {};
+    AstStatsPass statsPass(stats);
+    DepthPass depth;
+    ConstantPass constants;
+    ValidatePass validate;
+
+    switch (passes) {
+        case 1: {
+            Ast_WalkFused(root, statsPass);
+        } break;
+
+        case 2: {
+            Ast_WalkFused(root, statsPass, depth);
+        } break;
+
+        case 3: {
+            Ast_WalkFused(root, statsPass, depth, constants);
+        } break;
+
+        default: {
+            Ast_WalkFused(root, statsPass, depth, constants, validate);
+        } break;
+    }
+    Passes_Keep(stats, depth, constants, validate);
+}
+
+int main(int argc, char** argv) {
+    u64 targetSize  = 8 * 1024 * 1024;
+    u64 repetitions = 10;
+    if (argc > 1) {
+        targetSize = std::strtoull(argv[1], nullptr, 10) * 1024 * 1024;
+    }
+    if (argc > 2) {
+        repetitions = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    Array<u8> source = GenerateProgram(targetSize);
+    Arena nodes      = Arena_Create(MemoryCategory::Ast);
+    Parser parser(String(source.Data, source.Length), nodes);
+    Ast* root = parser.ParseStatement();
+    if (DiagnosticList_Count(parser.Lexer.Diagnostics) != 0) {
+        Error("The generated program should parse without errors");
+    }
+
+    AstStats stats = {};
+    Ast_CollectStats(root, stats);
+    u64 nodeCount = 0;
+    for (u64 i = 0; i < AstKindCount; i++) {
+        nodeCount += stats.Kinds[i].Count;
+    }
+
+    EmptyPass empty;
+    f64 walk  = Bench_Best(repetitions, [&] { empty.Walk(root); });
+    f64 scale = 1e9 / (f64)nodeCount;
+
+    Print("%.1f MB of source, %llu nodes, best of %llu, ns per node\n\n",
+          (f64)source.Length / (1024.0 * 1024.0),
+          (unsigned long long)nodeCount,
+          (unsigned long long)repetitions);
+    Print("%-8s %12s %12s %14s\n", "passes", "separate", "fused", "fused / walk");
+    Print("%-8s %12.2f %12.2f %14.2f\n", "0", walk * scale, walk * scale, 1.0);
+
+    for (u64 passes = 1; passes <= 4; passes++) {
+        f64 separate = Bench_Best(repetitions, [&] { RunSeparate(root, passes); });
+        f64 fused    = Bench_Best(repetitions, [&] { RunFused(root, passes); });
+        Print("%-8llu %12.2f %12.2f %14.2f\n", (unsigned long long)passes, separate * scale, fused * scale, fused / walk);
+    }
+
+    // Keeps the passes from being optimized out
+    Print("\nchecksum %llu\n", (unsigned long long)Checksum);
+
+    Arena_Destroy(nodes);
+    Array_Destroy(source);
+    return 0;
+}
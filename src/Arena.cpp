@@ -0,0 +1,162 @@
+#include "Arena.hpp"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+#endif
+
+static u64 RoundUp(u64 value, u64 alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Pages come straight from the OS, so they are zeroed and never fragment the heap
+static void* Arena_MapPage(u64 size, bool hugePages) {
+#if defined(_WIN32)
+    if (hugePages) {
+        // Needs the 'Lock pages in memory' privilege, without it this fails and normal pages are used
+        void* pointer = VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (pointer != nullptr) {
+            return pointer;
+        }
+    }
+    return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    if (hugePages) {
+        // Transparent huge pages only back 2MB aligned ranges, so map extra and cut the ends off
+        u64 mappedSize = size + ARENA_HUGE_PAGE_SIZE;
+        void* mapped   = mmap(nullptr, (size_t)mappedSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (mapped == MAP_FAILED) {
+            return nullptr;
+        }
+
+        uintptr_t start = RoundUp((uintptr_t)mapped, ARENA_HUGE_PAGE_SIZE);
+        if (start != (uintptr_t)mapped) {
+            munmap(mapped, (size_t)(start - (uintptr_t)mapped));
+        }
+        u64 tail = (uintptr_t)mapped + mappedSize - (start + size);
+        if (tail != 0) {
+            munmap((void*)(start + size), (size_t)tail);
+        }
+
+    #if defined(MADV_HUGEPAGE)
+        madvise((void*)start, (size_t)size, MADV_HUGEPAGE);
+    #endif
+        return (void*)start;
+    }
+
+    void* pointer = mmap(nullptr, (size_t)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return pointer == MAP_FAILED ? nullptr : pointer;
+#endif
+}
+
+static void Arena_UnmapPage(ArenaPage* page) {
+#if defined(_WIN32)
+    VirtualFree(page, 0, MEM_RELEASE);
+#else
+    munmap(page, (size_t)page->Size);
+#endif
+}
+
+Arena Arena_Create(MemoryCategory category, u64 pageSize, bool hugePages) {
+    Arena arena     = {};
+    arena.Cursor    = nullptr;
+    arena.End       = nullptr;
+    arena.Pages     = nullptr;
+    arena.Spare     = nullptr;
+    arena.PageSize  = hugePages ? RoundUp(pageSize, ARENA_HUGE_PAGE_SIZE) : pageSize;
+    arena.HugePages = hugePages;
+    arena.Category  = category;
+    arena.Stats     = {};
+    return arena;
+}
+
+static void Arena_UnmapPages(Arena& arena, ArenaPage* page) {
+    while (page != nullptr) {
+        ArenaPage* previous = page->Previous;
+        Memory_Untrack(arena.Category, page->Size);
+        Arena_UnmapPage(page);
+        page = previous;
+    }
+}
+
+void Arena_Destroy(Arena& arena) {
+    Arena_UnmapPages(arena, arena.Pages);
+    Arena_UnmapPages(arena, arena.Spare);
+    arena = {};
+}
+
+void Arena_Reset(Arena& arena) {
+    ArenaPage* page = arena.Pages;
+    while (page != nullptr) {
+        ArenaPage* previous = page->Previous;
+        if (page->Size == arena.PageSize) {
+            page->Previous = arena.Spare;
+            arena.Spare    = page;
+        } else {
+            // The size is in the page, so it has to be counted before the page is gone
+            Memory_Untrack(arena.Category, page->Size);
+            arena.Stats.PageCount--;
+            arena.Stats.BytesReserved -= page->Size;
+            Arena_UnmapPage(page);
+        }
+        page = previous;
+    }
+
+    arena.Pages                = nullptr;
+    arena.Cursor               = nullptr;
+    arena.End                  = nullptr;
+    arena.Stats.Allocations    = 0;
+    arena.Stats.BytesAllocated = 0;
+}
+
+void* Arena_AllocateSlow(Arena& arena, u64 size, u64 alignment) {
+    u64 needed = sizeof(ArenaPage) + size + alignment;
+    if (needed > arena.PageSize) {
+        // Anything bigger than a page gets a page of its own, behind the current one so the rest of that still gets used
+        u64 pageSize    = RoundUp(needed, arena.HugePages ? ARENA_HUGE_PAGE_SIZE : 4096);
+        ArenaPage* page = (ArenaPage*)Arena_MapPage(pageSize, arena.HugePages);
+        if (page == nullptr) {
+            Error("Out of memory, could not get a %llu byte arena page", pageSize);
+        }
+        page->Size = pageSize;
+        Memory_Track(arena.Category, pageSize);
+        if (arena.Pages != nullptr) {
+            page->Previous        = arena.Pages->Previous;
+            arena.Pages->Previous = page;
+        } else {
+            page->Previous = nullptr;
+            arena.Pages    = page;
+        }
+        arena.Stats.Allocations++;
+        arena.Stats.BytesAllocated += size;
+        arena.Stats.PageCount++;
+        arena.Stats.BytesReserved += pageSize;
+
+        return (void*)RoundUp((uintptr_t)(page + 1), alignment);
+    }
+
+    ArenaPage* page = arena.Spare;
+    if (page != nullptr) {
+        // Still counted from before the reset, and not zeroed like a fresh one
+        arena.Spare = page->Previous;
+    } else {
+        page = (ArenaPage*)Arena_MapPage(arena.PageSize, arena.HugePages);
+        if (page == nullptr) {
+            Error("Out of memory, could not get a %llu byte arena page", arena.PageSize);
+        }
+        page->Size = arena.PageSize;
+        Memory_Track(arena.Category, arena.PageSize);
+        arena.Stats.PageCount++;
+        arena.Stats.BytesReserved += arena.PageSize;
+    }
+    page->Previous = arena.Pages;
+
+    arena.Pages  = page;
+    arena.Cursor = (u8*)(page + 1);
+    arena.End    = (u8*)page + arena.PageSize;
+
+    return Arena_Allocate(arena, size, alignment);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Memory.hpp"
+
+#define ARENA_DEFAULT_PAGE_SIZE (1024 * 1024)
+// Huge pages are 2MB on x64, pages get rounded up to this when they are asked for
+#define ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+struct ArenaPage {
+    ArenaPage* Previous;
+    u64 Size; // Including this header
+};
+
+struct ArenaStats {
+    u64 Allocations;
+    u64 BytesAllocated; // What was asked for
+    u64 BytesReserved;  // What the pages take up, the difference is padding and unused page ends
+    u64 PageCount;
+};
+
+// Bump allocator for things that all die at the same time, like the AST of a compilation.
+// Nothing is freed on its own, Arena_Destroy gives every page back at once and Arena_Reset keeps them for reuse.
+struct Arena {
+    u8* Cursor;
+    u8* End;
+    ArenaPage* Pages; // Newest first
+    ArenaPage* Spare; // Left over from before Arena_Reset, used before any new page is mapped
+    u64 PageSize;
+    bool HugePages;
+    MemoryCategory Category; // What the pages are counted as
+    ArenaStats Stats;
+};
+
+Arena Arena_Create(MemoryCategory category, u64 pageSize = ARENA_DEFAULT_PAGE_SIZE, bool hugePages = false);
+void Arena_Destroy(Arena& arena);
+
+// Forgets everything allocated, but keeps the pages so the next use does not map and fault them in again.
+// Pages bigger than 'PageSize', made for single large allocations, are given back
+void Arena_Reset(Arena& arena);
+
+// Starts a new page, only called when the current one is full
+void* Arena_AllocateSlow(Arena& arena, u64 size, u64 alignment);
+
+inline void* Arena_Allocate(Arena& arena, u64 size, u64 alignment = 8) {
+    uintptr_t start = ((uintptr_t)arena.Cursor + alignment - 1) & ~(uintptr_t)(alignment - 1);
+    if (start + size > (uintptr_t)arena.End) {
+        return Arena_AllocateSlow(arena, size, alignment);
+    }
+
+    arena.Cursor = (u8*)(start + size);
+    arena.Stats.Allocations++;
+    arena.Stats.BytesAllocated += size;
+    return (void*)start;
+}
+
+// Grows the last allocation in place when there is room after it, so growing arrays do not leave copies behind
+inline bool Arena_TryExtend(Arena& arena, void* pointer, u64 oldSize, u64 newSize) {
+    if ((u8*)pointer + oldSize != arena.Cursor || newSize - oldSize > (u64)(arena.End - arena.Cursor)) {
+        return false;
+    }
+
+    arena.Cursor += newSize - oldSize;
+    arena.Stats.BytesAllocated += newSize - oldSize;
+    return true;
+}
+
+template<typename T>
+T* Arena_AllocateArray(Arena& arena, u64 count) {
+    return (T*)Arena_Allocate(arena, count * sizeof(T), alignof(T));
+}
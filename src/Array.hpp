@@ -1,15 +1,20 @@
 #pragma once
 
 #include "Defines.hpp"
+#include "Arena.hpp"
+#include "Memory.hpp"
 
 #include <new>
+#include <type_traits>
 #include <utility>
 
 template<typename T>
 struct Array {
-    T* Data      = nullptr;
-    u64 Length   = 0;
-    u64 Capacity = 0;
+    T* Data                 = nullptr;
+    u64 Length              = 0;
+    u64 Capacity            = 0;
+    Arena* Owner            = nullptr;                // Where the elements live, the heap when null
+    MemoryCategory Category = MemoryCategory::Arrays; // What heap storage is counted as
 
     T& operator[](u64 index) {
         return this->Data[index];
@@ -20,9 +25,87 @@ struct Array {
     }
 };
 
+// Element types that can be moved to a new address with memcpy, leaving nothing to destroy behind.
+// Their heap storage grows in place with realloc. Specialize it for types that are relocatable without being trivially copyable
 template<typename T>
-Array<T> Array_Create() {
-    return {};
+struct ArrayRelocatable : std::is_trivially_copyable<T> {};
+
+// The first allocation holds at least this many bytes, so short arrays do not grow through 1, 2, 4 and 8 elements
+#define ARRAY_MINIMUM_BYTES 64
+
+template<typename T>
+T* Array_AllocateStorage(Arena* owner, MemoryCategory category, u64 capacity) {
+    if (owner != nullptr) {
+        return Arena_AllocateArray<T>(*owner, capacity);
+    }
+    return (T*)Memory_Allocate(category, capacity * sizeof(T));
+}
+
+// Arena storage is never given back on its own
+template<typename T>
+void Array_FreeStorage(Arena* owner, MemoryCategory category, T* data, u64 capacity) {
+    if (owner != nullptr) {
+        return;
+    }
+    Memory_Free(category, data, capacity * sizeof(T));
+}
+
+// Moves 'count' elements to storage that does not overlap them, the old ones are left destroyed
+template<typename T>
+void Array_Relocate(T* to, T* from, u64 count) {
+    if constexpr (ArrayRelocatable<T>::value) {
+        if (count != 0) {
+            std::memcpy((void*)to, (const void*)from, count * sizeof(T));
+        }
+        return;
+    }
+
+    for (u64 i = 0; i < count; i++) {
+        new (&to[i]) T(std::move(from[i]));
+        from[i].~T();
+    }
+}
+
+// Gives back storage for 'newCapacity' elements holding the first 'length' of 'data', which might not move
+template<typename T>
+T* Array_ResizeStorage(Arena* owner, MemoryCategory category, T* data, u64 length, u64 oldCapacity, u64 newCapacity) {
+    if (owner != nullptr) {
+        if (newCapacity <= oldCapacity ||
+            Arena_TryExtend(*owner, data, oldCapacity * sizeof(T), newCapacity * sizeof(T))) {
+            return data;
+        }
+    } else if constexpr (ArrayRelocatable<T>::value) {
+        // Big blocks can be grown in place or remapped, without copying anything
+        return (T*)Memory_Reallocate(category, (void*)data, oldCapacity * sizeof(T), newCapacity * sizeof(T));
+    }
+
+    T* newData = Array_AllocateStorage<T>(owner, category, newCapacity);
+    Array_Relocate(newData, data, length);
+    Array_FreeStorage(owner, category, data, oldCapacity);
+    return newData;
+}
+
+template<typename T>
+Array<T> Array_Create(u64 capacity = 0, MemoryCategory category = MemoryCategory::Arrays) {
+    Array<T> array = {};
+    array.Category = category;
+    if (capacity != 0) {
+        array.Data     = Array_AllocateStorage<T>(nullptr, category, capacity);
+        array.Capacity = capacity;
+    }
+    return array;
+}
+
+// The elements are never freed on their own, they go away with the arena
+template<typename T>
+Array<T> Array_Create(Arena& arena, u64 capacity = 0) {
+    Array<T> array = {};
+    array.Owner    = &arena;
+    if (capacity != 0) {
+        array.Data     = Array_AllocateStorage<T>(&arena, array.Category, capacity);
+        array.Capacity = capacity;
+    }
+    return array;
 }
 
 template<typename T>
@@ -30,33 +113,89 @@ void Array_Destroy(Array<T>& array) {
     for (u64 i = 0; i < array.Length; i++) {
         array[i].~T();
     }
-    ::operator delete(array.Data, array.Capacity * sizeof(T));
-    array = {};
+    Array_FreeStorage(array.Owner, array.Category, array.Data, array.Capacity);
+
+    MemoryCategory category = array.Category;
+    array                   = {};
+    array.Category          = category;
+}
+
+template<typename T>
+void Array_Clear(Array<T>& array) {
+    for (u64 i = 0; i < array.Length; i++) {
+        array[i].~T();
+    }
+    array.Length = 0;
 }
 
+// Makes room for exactly 'capacity' elements, it never shrinks
 template<typename T>
-void Array_Grow(Array<T>& array, u64 newCapacity) {
-    if (array.Capacity >= newCapacity) {
+void Array_Reserve(Array<T>& array, u64 capacity) {
+    if (array.Capacity >= capacity) {
         return;
     }
 
-    T* newData = (T*)::operator new(newCapacity * sizeof(T));
+    array.Data = Array_ResizeStorage(array.Owner, array.Category, array.Data, array.Length, array.Capacity, capacity);
+    array.Capacity = capacity;
+}
 
-    for (u64 i = 0; i < array.Length; i++) {
-        new (&newData[i]) T(std::move(array[i]));
+// Makes room for at least 'capacity' elements, doubling so adding one at a time stays linear
+template<typename T>
+void Array_Grow(Array<T>& array, u64 capacity) {
+    if (array.Capacity >= capacity) {
+        return;
     }
 
-    ::operator delete(array.Data, array.Capacity * sizeof(T));
-    array.Data     = newData;
-    array.Capacity = newCapacity;
+    u64 newCapacity = array.Capacity * 2;
+    if (newCapacity < (ARRAY_MINIMUM_BYTES + sizeof(T) - 1) / sizeof(T)) {
+        newCapacity = (ARRAY_MINIMUM_BYTES + sizeof(T) - 1) / sizeof(T);
+    }
+    Array_Reserve(array, newCapacity < capacity ? capacity : newCapacity);
+}
+
+// Gives back the capacity past 'Length', arena arrays keep theirs
+template<typename T>
+void Array_Shrink(Array<T>& array) {
+    if (array.Owner != nullptr || array.Capacity == array.Length) {
+        return;
+    }
+
+    if (array.Length == 0) {
+        Array_FreeStorage(array.Owner, array.Category, array.Data, array.Capacity);
+        array.Data     = nullptr;
+        array.Capacity = 0;
+        return;
+    }
+
+    array.Data = Array_ResizeStorage(array.Owner, array.Category, array.Data, array.Length, array.Capacity, array.Length);
+    array.Capacity = array.Length;
+}
+
+template<typename T, typename... Args>
+T& Array_Emplace(Array<T>& array, Args&&... args) {
+    if (array.Length >= array.Capacity) {
+        Array_Grow(array, array.Length + 1);
+    }
+
+    new (&array.Data[array.Length]) T(std::forward<Args>(args)...);
+    return array.Data[array.Length++];
+}
+
+template<typename T>
+T& Array_AddMove(Array<T>& array, T&& value) {
+    return Array_Emplace(array, std::move(value));
 }
 
 template<typename T>
 T& Array_Add(Array<T>& array, const T& value) {
     if (array.Length >= array.Capacity) {
-        Array_Grow(array, array.Capacity == 0 ? 1 : array.Capacity * 2);
+        // 'value' could be one of the elements that are about to move
+        T copy(value);
+        Array_Grow(array, array.Length + 1);
+        new (&array.Data[array.Length]) T(std::move(copy));
+        return array.Data[array.Length++];
     }
 
-    new (&array[array.Length]) T(value);
-    return array[array.Length++];
+    new (&array.Data[array.Length]) T(value);
+    return array.Data[array.Length++];
 }
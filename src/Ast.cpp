@@ -1,5 +1,42 @@
+#define KEEP_AST_KINDS
 #include "Ast.hpp"
 
+// The layout nodes had before they were sized to their kind, every node was this header plus a union of all the payloads,
+// with the lists in growable arrays of their own. Only kept so AstStats can show the difference
+namespace UnionLayout {
+    template<typename T>
+    using AstList = Array<T>;
+
+#define AST_KIND(name, str, type_data) struct Ast##name##Data type_data;
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+    AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+
+    struct Node {
+        u32 Kind;
+        ::Ast* ParentFile;
+        ::Ast* ParentScope;
+        ::Ast* ParentStatement;
+        u32 Completion;
+        ::Ast* Type;
+
+        union {
+#define AST_KIND(name, str, type_data) Ast##name##Data name;
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+            AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+        };
+    };
+}
+
+AstStats AstAllocations = {};
+
 void Ast_Print(Ast* ast, u64 indent) {
     auto PrintIndent = [&](u64 extraIndent = 0) -> void {
         for (u64 i = 0; i < (indent + extraIndent); i++) {
@@ -21,22 +58,22 @@ void Ast_Print(Ast* ast, u64 indent) {
     switch (ast->Kind) {
         case AstKind::File: {
             Print("(<File> Scope: ");
-            Ast_Print(ast->File.Scope, indent + 1);
+            Ast_Print(ast->File().Scope, indent + 1);
             Print(")");
         } break;
 
         case AstKind::Scope: {
             Print("(<Scope> (");
             PrintCategory("Statements: (");
-            for (u64 i = 0; i < ast->Scope.Statements.Length; i++) {
+            for (u64 i = 0; i < ast->Scope().Statements.Length; i++) {
                 if (i == 0) {
                     Print("\n");
                 }
 
                 PrintIndent(2);
-                Ast_Print(ast->Scope.Statements[i], indent + 2);
+                Ast_Print(ast->Scope().Statements[i], indent + 2);
 
-                if (i != ast->Scope.Statements.Length - 1) {
+                if (i != ast->Scope().Statements.Length - 1) {
                     Print(",\n");
                 }
             }
@@ -46,86 +83,88 @@ void Ast_Print(Ast* ast, u64 indent) {
         case AstKind::Declaration: {
             Print("(<Declaration>");
             PrintCategory("Constant: ");
-            Print("%s", ast->Declaration.Constant ? "true" : "false");
+            Print("%s", ast->Declaration().Constant ? "true" : "false");
             PrintCategory("Name: ");
-            Ast_Print(ast->Declaration.Name, indent + 1);
+            Ast_Print(ast->Declaration().Name, indent + 1);
             PrintCategory("Type: ");
-            Ast_Print(ast->Declaration.Type, indent + 1);
+            Ast_Print(ast->Declaration().Type, indent + 1);
             PrintCategory("Value: ");
-            Ast_Print(ast->Declaration.Value, indent + 1);
+            Ast_Print(ast->Declaration().Value, indent + 1);
             Print(")");
         } break;
 
         case AstKind::IntegerLiteral: {
             Print("(<Integer>");
             PrintCategory("Value: ");
-            Print("%llu)", ast->IntegerLiteral.IntToken.Data.IntValue);
+            Print("%lld)", (s64)ast->IntegerLiteral().Value);
         } break;
 
         case AstKind::FloatLiteral: {
             Print("(<Float>");
             PrintCategory("Value: ");
-            Print("%f)", ast->FloatLiteral.FloatToken.Data.FloatValue);
+            Print("%f)", ast->FloatLiteral().Value);
         } break;
 
         case AstKind::Name: {
             Print("(<Name>");
             PrintCategory("Value: ");
-            Print("'%.*s')", (u32)ast->Name.Identifier.Data.Name.Length, ast->Name.Identifier.Data.Name.Data);
+            String name = Interner_GetString(GlobalInterner, ast->Name().Identifier.Data.Name);
+            Print("'%.*s')", (u32)name.Length, name.Data);
         } break;
 
         case AstKind::Unary: {
             Print("(<Unary>");
             PrintCategory("Operator: ");
-            Print("'%s'", GetTokenKindName(ast->Unary.Operator.Kind).Data);
+            Print("'%s'", GetTokenKindName(ast->Unary().Operator.Kind).Data);
             PrintCategory("Operand: ");
-            Ast_Print(ast->Unary.Operand, indent + 1);
+            Ast_Print(ast->Unary().Operand, indent + 1);
             Print(")");
         } break;
 
         case AstKind::Binary: {
             Print("(<Binary>");
             PrintCategory("Operator: ");
-            Print("'%s'", GetTokenKindName(ast->Binary.Operator.Kind).Data);
+            Print("'%s'", GetTokenKindName(ast->Binary().Operator.Kind).Data);
             PrintCategory("Left: ");
-            Ast_Print(ast->Binary.Left, indent + 1);
+            Ast_Print(ast->Binary().Left, indent + 1);
             PrintCategory("Right: ");
-            Ast_Print(ast->Binary.Right, indent + 1);
+            Ast_Print(ast->Binary().Right, indent + 1);
             Print(")");
         } break;
 
         case AstKind::TypeName: {
             Print("(<Type Name>");
             PrintCategory("Value: ");
-            Print("'%.*s')", (u32)ast->TypeName.Name.Data.Name.Length, ast->TypeName.Name.Data.Name.Data);
+            String name = Interner_GetString(GlobalInterner, ast->TypeName().Name.Data.Name);
+            Print("'%.*s')", (u32)name.Length, name.Data);
         } break;
 
         case AstKind::TypePointer: {
             Print("(<Type Pointer>");
             PrintCategory("Pointer To: ");
-            Ast_Print(ast->TypePointer.PointerTo, indent + 1);
+            Ast_Print(ast->TypePointer().PointerTo, indent + 1);
             Print(")");
         } break;
 
         case AstKind::TypeDeref: {
             Print("(<Type Deref>");
             PrintCategory("Derefed Type: ");
-            Ast_Print(ast->TypeDeref.DerefedType, indent + 1);
+            Ast_Print(ast->TypeDeref().DerefedType, indent + 1);
             Print(")");
         } break;
 
         case AstKind::TypeInteger: {
             Print("(<Type Integer>");
             PrintCategory("Size: ");
-            Print("%llu", ast->TypeInteger.Size);
+            Print("%llu", ast->TypeInteger().Size);
             PrintCategory("Signed: ");
-            Print(ast->TypeInteger.Signed ? "true)" : "false)");
+            Print(ast->TypeInteger().Signed ? "true)" : "false)");
         } break;
 
         case AstKind::TypeFloat: {
             Print("(<Type Float>");
             PrintCategory("Size: ");
-            Print("%llu)", ast->TypeFloat.Size);
+            Print("%llu)", ast->TypeFloat().Size);
         } break;
 
         case AstKind::TypeVoid: {
@@ -139,44 +178,44 @@ void Ast_Print(Ast* ast, u64 indent) {
         case AstKind::TypeProcedure: {
             Print("(<Type Procedure>");
             PrintCategory("Arguments: (");
-            for (u64 i = 0; i < ast->TypeProcedure.Arguments.Length; i++) {
+            for (u64 i = 0; i < ast->TypeProcedure().Arguments.Length; i++) {
                 if (i == 0) {
                     Print("\n");
                 }
 
                 PrintIndent(2);
-                Ast_Print(ast->TypeProcedure.Arguments[i], indent + 2);
+                Ast_Print(ast->TypeProcedure().Arguments[i], indent + 2);
 
-                if (i != ast->TypeProcedure.Arguments.Length - 1) {
+                if (i != ast->TypeProcedure().Arguments.Length - 1) {
                     Print(",\n");
                 }
             }
             Print(")");
             PrintCategory("ReturnType: ");
-            Ast_Print(ast->TypeProcedure.ReturnType, indent + 1);
+            Ast_Print(ast->TypeProcedure().ReturnType, indent + 1);
             Print(")");
         } break;
 
         case AstKind::Procedure: {
             Print("(<Procedure>");
             PrintCategory("Arguments: (");
-            for (u64 i = 0; i < ast->Procedure.Arguments.Length; i++) {
+            for (u64 i = 0; i < ast->Procedure().Arguments.Length; i++) {
                 if (i == 0) {
                     Print("\n");
                 }
 
                 PrintIndent(2);
-                Ast_Print(ast->Procedure.Arguments[i], indent + 2);
+                Ast_Print(ast->Procedure().Arguments[i], indent + 2);
 
-                if (i != ast->Procedure.Arguments.Length - 1) {
+                if (i != ast->Procedure().Arguments.Length - 1) {
                     Print(",\n");
                 }
             }
             Print(")");
             PrintCategory("ReturnType: ");
-            Ast_Print(ast->Procedure.ReturnType, indent + 1);
+            Ast_Print(ast->Procedure().ReturnType, indent + 1);
             PrintCategory("Body: ");
-            Ast_Print(ast->Procedure.Body, indent + 1);
+            Ast_Print(ast->Procedure().Body, indent + 1);
             Print(")");
         } break;
 
@@ -189,3 +228,82 @@ void Ast_Print(Ast* ast, u64 indent) {
             ASSERT(false);
     }
 }
+
+static u64 GetListBytes(Ast* ast) {
+    u64 bytes = 0;
+    switch (ast->Kind) {
+#define AST_KIND(name, str, type_data)                                                                  \
+    case AstKind::name: {                                                                               \
+        Ast_ForEachList(ast->name(), [&](auto& list) { bytes += list.Length * sizeof(list.Data[0]); }); \
+    } break;
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+        AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+        default:
+            ASSERT(false);
+    }
+    return bytes;
+}
+
+void AstStats_AddNode(AstStats& stats, Ast* ast) {
+    u64 listBytes           = GetListBytes(ast);
+    AstKindStats& kindStats = stats.Kinds[(u64)ast->Kind];
+    kindStats.Count++;
+    kindStats.Bytes += Ast_GetNodeSize(ast->Kind) + listBytes;
+    kindStats.UnionBytes += sizeof(UnionLayout::Node) + listBytes;
+}
+
+// Procedure arguments are also in their body's ExtraVariablesInScope, the walk only reaches them once
+void Ast_CollectStats(Ast* ast, AstStats& stats) {
+    AstStatsPass pass(stats);
+    pass.Walk(ast);
+}
+
+void AstStats_Print(const AstStats& stats) {
+    PrintError("\nAST Stats:\n");
+    PrintError("%-16s %10s %10s %12s %12s %14s\n", "Kind", "Count", "Node Size", "Bytes", "Union Size", "Union Bytes");
+
+    AstKindStats total = {};
+    for (u64 i = 0; i < AstKindCount; i++) {
+        const AstKindStats& kindStats = stats.Kinds[i];
+        if (kindStats.Count == 0) {
+            continue;
+        }
+
+        // The sizes include the lists, so they are per node averages for the kinds that have them
+        PrintError("%-16s %10llu %10.1f %12llu %12.1f %14llu\n",
+                   GetAstKindName((AstKind)i).Data,
+                   kindStats.Count,
+                   (f64)kindStats.Bytes / (f64)kindStats.Count,
+                   kindStats.Bytes,
+                   (f64)kindStats.UnionBytes / (f64)kindStats.Count,
+                   kindStats.UnionBytes);
+
+        total.Count += kindStats.Count;
+        total.Bytes += kindStats.Bytes;
+        total.UnionBytes += kindStats.UnionBytes;
+    }
+
+    PrintError("%-16s %10llu %10s %12llu %12s %14llu\n", "Total", total.Count, "", total.Bytes, "", total.UnionBytes);
+}
+
+void AstStats_PrintAllocations(const AstStats& stats) {
+    PrintError("%-16s %10s %12s\n", "AST Kind", "Created", "Bytes");
+
+    AstKindStats total = {};
+    for (u64 i = 0; i < AstKindCount; i++) {
+        const AstKindStats& kindStats = stats.Kinds[i];
+        if (kindStats.Count == 0) {
+            continue;
+        }
+
+        PrintError("%-16s %10llu %12llu\n", GetAstKindName((AstKind)i).Data, kindStats.Count, kindStats.Bytes);
+        total.Count += kindStats.Count;
+        total.Bytes += kindStats.Bytes;
+    }
+
+    PrintError("%-16s %10llu %12llu\n", "Total", total.Count, total.Bytes);
+}
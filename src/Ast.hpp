@@ -4,71 +4,85 @@
 #include "String.hpp"
 #include "Array.hpp"
 #include "Token.hpp"
+#include "Arena.hpp"
+#include "SmallArray.hpp"
 
-#define AST_KINDS                                                         \
-    AST_KIND(File, "File", { AstScope* Scope; })                          \
-                                                                          \
-    AST_KIND_BEGIN(Statement)                                             \
-                                                                          \
-    AST_KIND(Scope, "Scope", {                                            \
-        Array<AstStatement*> Statements;                                  \
-        Array<Ast*> ExtraVariablesInScope; /* e.g. Function parameters */ \
-    })                                                                    \
-                                                                          \
-    AST_KIND(Declaration, "Declaration", {                                \
-        bool Constant;                                                    \
-        AstName* Name;                                                    \
-        AstType* Type;                                                    \
-        AstExpression* Value;                                             \
-    })                                                                    \
-                                                                          \
-    AST_KIND_BEGIN(Expression)                                            \
-                                                                          \
-    AST_KIND(IntegerLiteral, "Integer Literal", { Token IntToken; })      \
-    AST_KIND(FloatLiteral, "Float Literal", { Token FloatToken; })        \
-    AST_KIND(Name, "Name", { Token Identifier; })                         \
-                                                                          \
-    AST_KIND(Unary, "Unary", {                                            \
-        Token Operator;                                                   \
-        AstExpression* Operand;                                           \
-    })                                                                    \
-                                                                          \
-    AST_KIND(Binary, "Binary", {                                          \
-        AstExpression* Left;                                              \
-        Token Operator;                                                   \
-        AstExpression* Right;                                             \
-    })                                                                    \
-                                                                          \
-    AST_KIND(Procedure, "Procedure", {                                    \
-        Array<AstDeclaration*> Arguments;                                 \
-        AstType* ReturnType;                                              \
-        AstScope* Body;                                                   \
-    })                                                                    \
-                                                                          \
-    AST_KIND_BEGIN(Type)                                                  \
-                                                                          \
-    AST_KIND(TypeType, "Type Type", {})                                   \
-    AST_KIND(TypeName, "Type Name", { Token Name; })                      \
-    AST_KIND(TypePointer, "Type Pointer", { AstType* PointerTo; })        \
-    AST_KIND(TypeDeref, "Type Deref", { AstType* DerefedType; })          \
-    AST_KIND(TypeInteger, "Type Integer", {                               \
-        u64 Size;                                                         \
-        bool Signed;                                                      \
-    })                                                                    \
-    AST_KIND(TypeFloat, "Type Float", { u64 Size; })                      \
-    AST_KIND(TypeVoid, "Type Void", {})                                   \
-    AST_KIND(TypeProcedure, "Type Procedure", {                           \
-        Array<AstType*> Arguments;                                        \
-        AstType* ReturnType;                                              \
-    })                                                                    \
-                                                                          \
-    AST_KIND_END(Type)                                                    \
-                                                                          \
-    AST_KIND_END(Expression)                                              \
-                                                                          \
+#include <algorithm>
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+
+#define AST_KINDS                                                           \
+    AST_KIND(File, "File", { AstScope* Scope; })                            \
+                                                                            \
+    AST_KIND_BEGIN(Statement)                                               \
+                                                                            \
+    AST_KIND(Scope, "Scope", {                                              \
+        AstList<AstStatement*> Statements;                                  \
+        AstList<Ast*> ExtraVariablesInScope; /* e.g. Function parameters */ \
+        AstList<AstScopeSymbol> Symbols;     /* See AstScope_FindSymbol */  \
+    })                                                                      \
+                                                                            \
+    AST_KIND(Declaration, "Declaration", {                                  \
+        bool Constant;                                                      \
+        AstName* Name;                                                      \
+        AstType* Type;                                                      \
+        AstExpression* Value;                                               \
+    })                                                                      \
+                                                                            \
+    AST_KIND_BEGIN(Expression)                                              \
+                                                                            \
+    AST_KIND(IntegerLiteral, "Integer Literal", {                           \
+        Token IntToken;                                                     \
+        u64 Value; /* The bits of an int, which is signed */                \
+    })                                                                      \
+    AST_KIND(FloatLiteral, "Float Literal", {                               \
+        Token FloatToken;                                                   \
+        f64 Value;                                                          \
+    })                                                                      \
+    AST_KIND(Name, "Name", { Token Identifier; })                           \
+                                                                            \
+    AST_KIND(Unary, "Unary", {                                              \
+        Token Operator;                                                     \
+        AstExpression* Operand;                                             \
+    })                                                                      \
+                                                                            \
+    AST_KIND(Binary, "Binary", {                                            \
+        AstExpression* Left;                                                \
+        Token Operator;                                                     \
+        AstExpression* Right;                                               \
+    })                                                                      \
+                                                                            \
+    AST_KIND(Procedure, "Procedure", {                                      \
+        AstList<AstDeclaration*> Arguments;                                 \
+        AstType* ReturnType;                                                \
+        AstScope* Body;                                                     \
+    })                                                                      \
+                                                                            \
+    AST_KIND_BEGIN(Type)                                                    \
+                                                                            \
+    AST_KIND(TypeType, "Type Type", {})                                     \
+    AST_KIND(TypeName, "Type Name", { Token Name; })                        \
+    AST_KIND(TypePointer, "Type Pointer", { AstType* PointerTo; })          \
+    AST_KIND(TypeDeref, "Type Deref", { AstType* DerefedType; })            \
+    AST_KIND(TypeInteger, "Type Integer", {                                 \
+        u64 Size;                                                           \
+        bool Signed;                                                        \
+    })                                                                      \
+    AST_KIND(TypeFloat, "Type Float", { u64 Size; })                        \
+    AST_KIND(TypeVoid, "Type Void", {})                                     \
+    AST_KIND(TypeProcedure, "Type Procedure", {                             \
+        AstList<AstType*> Arguments;                                        \
+        AstType* ReturnType;                                                \
+    })                                                                      \
+                                                                            \
+    AST_KIND_END(Type)                                                      \
+                                                                            \
+    AST_KIND_END(Expression)                                                \
+                                                                            \
     AST_KIND_END(Statement)
 
-enum struct AstKind {
+enum struct AstKind : u8 {
 #define AST_KIND(name, str, type_data) name,
 #define AST_KIND_BEGIN(name)           _##name##_Begin,
 #define AST_KIND_END(name)             _##name##_End,
@@ -104,6 +118,32 @@ AST_KINDS
 #undef AST_KIND_BEGIN
 #undef AST_KIND_END
 
+// A fixed length list of children, stored right behind the node that owns it
+template<typename T>
+struct AstList {
+    T* Data;
+    u64 Length;
+
+    T& operator[](u64 index) const {
+        return this->Data[index];
+    }
+};
+
+template<typename T>
+AstList<T> AstList_Create(T* data, u64 length) {
+    AstList<T> list = {};
+    list.Data       = data;
+    list.Length     = length;
+    return list;
+}
+
+// A slot of a scope's symbol table, which is open addressed by name. Empty slots have Symbol_None as their name
+struct AstScopeSymbol {
+    Symbol Name;
+    u32 Ordinal; // Of the statement that declares it, procedure arguments are 0
+    AstDeclaration* Declaration;
+};
+
 #define AST_KIND(name, str, type_data) struct Ast##name##Data type_data;
 #define AST_KIND_BEGIN(name)
 #define AST_KIND_END(name)
@@ -112,31 +152,155 @@ AST_KINDS
 #undef AST_KIND_BEGIN
 #undef AST_KIND_END
 
-enum struct AstCompletion {
+// Calls 'f' on each list of a payload, only the kinds that have lists need an overload
+template<typename Data, typename F>
+inline void Ast_ForEachList(Data&, F) {}
+
+template<typename F>
+inline void Ast_ForEachList(AstScopeData& data, F f) {
+    f(data.Statements);
+    f(data.ExtraVariablesInScope);
+    f(data.Symbols);
+}
+
+template<typename F>
+inline void Ast_ForEachList(AstProcedureData& data, F f) {
+    f(data.Arguments);
+}
+
+template<typename F>
+inline void Ast_ForEachList(AstTypeProcedureData& data, F f) {
+    f(data.Arguments);
+}
+
+// Calls 'f' on each child of a payload in source order, null ones included. Only the kinds that have children need an
+// overload. A scope's ExtraVariablesInScope are not its children, they are the arguments of its procedure
+template<typename Data, typename F>
+inline void Ast_ForEachChild(Data&, F) {}
+
+template<typename F>
+inline void Ast_ForEachChild(AstFileData& data, F f) {
+    f(data.Scope);
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstScopeData& data, F f) {
+    for (u64 i = 0; i < data.Statements.Length; i++) {
+        f(data.Statements[i]);
+    }
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstDeclarationData& data, F f) {
+    f(data.Name);
+    f(data.Type);
+    f(data.Value);
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstUnaryData& data, F f) {
+    f(data.Operand);
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstBinaryData& data, F f) {
+    f(data.Left);
+    f(data.Right);
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstProcedureData& data, F f) {
+    for (u64 i = 0; i < data.Arguments.Length; i++) {
+        f(data.Arguments[i]);
+    }
+    f(data.ReturnType);
+    f(data.Body);
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstTypePointerData& data, F f) {
+    f(data.PointerTo);
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstTypeDerefData& data, F f) {
+    f(data.DerefedType);
+}
+
+template<typename F>
+inline void Ast_ForEachChild(AstTypeProcedureData& data, F f) {
+    for (u64 i = 0; i < data.Arguments.Length; i++) {
+        f(data.Arguments[i]);
+    }
+    f(data.ReturnType);
+}
+
+// Kinds without data take no space after the header
+template<typename Data>
+constexpr u64 Ast_GetPayloadSize() {
+    return std::is_empty<Data>::value ? 0 : (sizeof(Data) + 7) & ~(u64)7;
+}
+
+enum struct AstCompletion : u8 {
     Incomplete,
     Completing,
     Complete,
 };
 
+// The header every node starts with. The payload of the node's kind follows it and is only as big as that kind needs,
+// so the accessors below are only valid for the kind the node was created as
 struct Ast {
     AstKind Kind;
+    // Atomic so ResolveAstParallel can claim a node from any thread, the serial resolver only loads and stores it
+    std::atomic<AstCompletion> Completion;
+    // 1 + the index of the statement in ParentScope the node is part of, which is what declared before use compares
+    u32 Ordinal;
     AstFile* ParentFile;
     AstScope* ParentScope;
     AstStatement* ParentStatement;
-    AstCompletion Completion;
     AstType* Type;
 
-    union {
-#define AST_KIND(name, str, type_data) Ast##name##Data name;
+#define AST_KIND(name, str, type_data)        \
+    Ast##name##Data& name() {                 \
+        ASSERT(this->Kind == AstKind::name);  \
+        return *(Ast##name##Data*)(this + 1); \
+    }
 #define AST_KIND_BEGIN(name)
 #define AST_KIND_END(name)
-        AST_KINDS
+    AST_KINDS
 #undef AST_KIND
 #undef AST_KIND_BEGIN
 #undef AST_KIND_END
-    };
 };
 
+#define AST_KIND(name, str, type_data)                                                                         \
+    static_assert(alignof(Ast##name##Data) <= alignof(Ast), "The payload has to fit right behind the header");
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+
+constexpr u64 AstKindCount = (u64)AstKind::_Statement_End + 1;
+
+// Bytes a node of 'kind' takes, without the lists behind it
+inline u64 Ast_GetNodeSize(AstKind kind) {
+    switch (kind) {
+#define AST_KIND(name, str, type_data)                              \
+    case AstKind::name:                                             \
+        return sizeof(Ast) + Ast_GetPayloadSize<Ast##name##Data>();
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+        AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+        default:
+            return 0;
+    }
+}
+
 #define AST_KIND(name, str, type_data)         \
     inline bool Ast_Is##name(const Ast* ast) { \
         if (ast == nullptr) {                  \
@@ -157,20 +321,79 @@ AST_KINDS
 #undef AST_KIND_BEGIN
 #undef AST_KIND_END
 
-#define AST_KIND(name, str, type_data)                                                                                  \
-    inline Ast##name* Ast_Create##name(AstFile* file, AstScope* scope, AstStatement* statement, Ast##name##Data data) { \
-        ASSERT(file == nullptr || Ast_IsFile(file));                                                                    \
-        ASSERT(scope == nullptr || Ast_IsScope(scope));                                                                 \
-        ASSERT(statement == nullptr || Ast_IsStatement(statement));                                                     \
-        Ast* ast             = (Ast*)std::memset(::operator new(sizeof(Ast)), 0, sizeof(Ast));                          \
-        ast->Kind            = AstKind::name;                                                                           \
-        ast->ParentFile      = file;                                                                                    \
-        ast->ParentScope     = scope;                                                                                   \
-        ast->ParentStatement = statement;                                                                               \
-        ast->Completion      = AstCompletion::Incomplete;                                                               \
-        ast->Type            = nullptr;                                                                                 \
-        std::memcpy(&ast->name, &data, sizeof(Ast##name##Data)); /* To stop 'operator =' error */                       \
-        return ast;                                                                                                     \
+// Where looking for 'name' starts in a symbol table of 'mask' + 1 slots. Symbols are handed out in order, and an odd
+// multiplier keeps consecutive ones in different slots
+inline u64 AstScope_GetSymbolSlot(Symbol name, u64 mask) {
+    return (u64)(name * 0x9E3779B1u) & mask;
+}
+
+// The first declaration of 'name' directly in 'scope', arguments of its procedure included, or null.
+// Tables are at least twice as big as what is in them, so looking for a name always ends at an empty slot
+inline const AstScopeSymbol* AstScope_FindSymbol(AstScope* scope, Symbol name) {
+    const AstList<AstScopeSymbol>& symbols = scope->Scope().Symbols;
+    if (symbols.Length == 0) {
+        return nullptr;
+    }
+
+    u64 mask = symbols.Length - 1;
+    for (u64 index = AstScope_GetSymbolSlot(name, mask);; index = (index + 1) & mask) {
+        const AstScopeSymbol& symbol = symbols[index];
+        if (symbol.Name == name) {
+            return &symbol;
+        }
+        if (symbol.Name == Symbol_None) {
+            return nullptr;
+        }
+    }
+}
+
+struct AstKindStats {
+    u64 Count;
+    u64 Bytes;      // Headers, payloads and the lists behind them
+    u64 UnionBytes; // What the same nodes took when every node was as big as the largest kind
+};
+
+struct AstStats {
+    AstKindStats Kinds[AstKindCount];
+};
+
+// Every node in the arena of the file being compiled, by kind, for --mem-stats. UnionBytes is not counted
+extern AstStats AstAllocations;
+
+// Nodes are bump allocated from 'arena', so they end up in memory in the order they were created.
+// The lists in 'data' are copied in behind the payload, a node and its lists are a single allocation
+#define AST_KIND(name, str, type_data)                                                                  \
+    inline Ast##name* Ast_Create##name(                                                                 \
+        Arena& arena, AstFile* file, AstScope* scope, AstStatement* statement, Ast##name##Data data) {  \
+        ASSERT(file == nullptr || Ast_IsFile(file));                                                    \
+        ASSERT(scope == nullptr || Ast_IsScope(scope));                                                 \
+        ASSERT(statement == nullptr || Ast_IsStatement(statement));                                     \
+        u64 size     = sizeof(Ast) + Ast_GetPayloadSize<Ast##name##Data>();                             \
+        u64 listSize = 0;                                                                               \
+        Ast_ForEachList(data, [&](auto& list) { listSize += list.Length * sizeof(list.Data[0]); });     \
+        Ast* ast             = (Ast*)Arena_Allocate(arena, size + listSize, alignof(Ast));              \
+        AstAllocations.Kinds[(u64)AstKind::name].Count++;                                               \
+        AstAllocations.Kinds[(u64)AstKind::name].Bytes += size + listSize;                              \
+        ast->Kind            = AstKind::name;                                                           \
+        ast->Completion.store(AstCompletion::Incomplete, std::memory_order_relaxed);                    \
+        ast->Ordinal         = 0;                                                                       \
+        ast->ParentFile      = file;                                                                    \
+        ast->ParentScope     = scope;                                                                   \
+        ast->ParentStatement = statement;                                                               \
+        ast->Type            = nullptr;                                                                 \
+        u8* listData         = (u8*)ast + size;                                                         \
+        Ast_ForEachList(data, [&](auto& list) {                                                         \
+            u64 bytes = list.Length * sizeof(list.Data[0]);                                             \
+            if (bytes != 0) {                                                                           \
+                std::memcpy(listData, list.Data, bytes);                                                \
+            }                                                                                           \
+            list.Data = (decltype(list.Data))listData;                                                  \
+            listData += bytes;                                                                          \
+        });                                                                                             \
+        if (Ast_GetPayloadSize<Ast##name##Data>() != 0) {                                               \
+            std::memcpy(&ast->name(), &data, sizeof(Ast##name##Data)); /* To stop 'operator =' error */ \
+        }                                                                                               \
+        return ast;                                                                                     \
     }
 #define AST_KIND_BEGIN(name)
 #define AST_KIND_END(name)
@@ -179,8 +402,186 @@ AST_KINDS
 #undef AST_KIND_BEGIN
 #undef AST_KIND_END
 
+// Walks a tree without recursion, calling hooks on the way down and on the way back up.
+// A visitor derives from AstVisitor<Itself> and hides the hooks it wants, the others do nothing. Which hook runs is
+// decided at compile time, there are no virtual calls.
+//
+//     EnterNode(node)      before any of the node's children, for every kind
+//     Enter<Kind>(node)    right after EnterNode
+//     Leave<Kind>(node)    after all of the node's children
+//     LeaveNode(node)      right after Leave<Kind>
+//
+// Children are visited in source order, see Ast_ForEachChild. Null children are skipped. After resolving, declaration
+// types are the shared canonical nodes from the TypeTable, so a walk of a resolved tree can visit those more than once
+
+// Calls 'f' on each child of 'ast', see Ast_ForEachChild
+template<typename F>
+inline void Ast_ForEachChildOf(Ast* ast, F f) {
+    switch (ast->Kind) {
+#define AST_KIND(name, str, type_data)    \
+    case AstKind::name: {                 \
+        Ast_ForEachChild(ast->name(), f); \
+    } break;
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+        AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+        default:
+            ASSERT(false);
+    }
+}
+
+struct AstWalkEntry {
+    Ast* Node;
+    bool Entered; // Its children are below it on the stack, it is left when it is popped again
+};
+
+// Deep enough for most trees without going to the heap
+#define AST_WALK_INLINE_DEPTH 64
+
+template<typename Visitor>
+void Ast_Walk(Ast* root, Visitor& visitor) {
+    if (root == nullptr) {
+        return;
+    }
+
+    SmallArray<AstWalkEntry, AST_WALK_INLINE_DEPTH> stack = SmallArray_Create<AstWalkEntry, AST_WALK_INLINE_DEPTH>();
+    SmallArray_Add(stack, { root, false });
+
+    while (stack.Length != 0) {
+        AstWalkEntry& top = stack[stack.Length - 1];
+        Ast* node         = top.Node;
+
+        if (top.Entered) {
+            stack.Length--;
+            switch (node->Kind) {
+#define AST_KIND(name, str, type_data) \
+    case AstKind::name: {              \
+        visitor.Leave##name(node);     \
+    } break;
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+                AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+                default:
+                    ASSERT(false);
+            }
+            visitor.LeaveNode(node);
+            continue;
+        }
+
+        top.Entered = true;
+        visitor.EnterNode(node);
+        switch (node->Kind) {
+#define AST_KIND(name, str, type_data) \
+    case AstKind::name: {              \
+        visitor.Enter##name(node);     \
+    } break;
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+            AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+            default:
+                ASSERT(false);
+        }
+
+        // Pushed in order and then turned around, so the first child is on top
+        u64 firstChild = stack.Length;
+        Ast_ForEachChildOf(node, [&](Ast* child) {
+            if (child != nullptr) {
+                SmallArray_Add(stack, { child, false });
+            }
+        });
+        std::reverse(stack.Data() + firstChild, stack.Data() + stack.Length);
+    }
+
+    SmallArray_Destroy(stack);
+}
+
+template<typename Derived>
+struct AstVisitor {
+    void EnterNode(Ast* node) {}
+    void LeaveNode(Ast* node) {}
+
+#define AST_KIND(name, str, type_data)   \
+    void Enter##name(Ast##name* node) {} \
+    void Leave##name(Ast##name* node) {}
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+    AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+
+    void Walk(Ast* root) {
+        Ast_Walk(root, static_cast<Derived&>(*this));
+    }
+};
+
+// Runs several visitors in one walk, each hook calls the same hook of every pass in the order they were given.
+// The passes see the nodes in the same order as when they are walked one at a time
+template<typename... Pass>
+struct AstFusedVisitor : AstVisitor<AstFusedVisitor<Pass...>> {
+    std::tuple<Pass&...> Passes;
+
+    explicit AstFusedVisitor(Pass&... passes) : Passes(passes...) {}
+
+    void EnterNode(Ast* node) {
+        std::apply([node](Pass&... passes) { (passes.EnterNode(node), ...); }, this->Passes);
+    }
+
+    void LeaveNode(Ast* node) {
+        std::apply([node](Pass&... passes) { (passes.LeaveNode(node), ...); }, this->Passes);
+    }
+
+#define AST_KIND(name, str, type_data)                                                          \
+    void Enter##name(Ast##name* node) {                                                         \
+        std::apply([node](Pass&... passes) { (passes.Enter##name(node), ...); }, this->Passes); \
+    }                                                                                           \
+    void Leave##name(Ast##name* node) {                                                         \
+        std::apply([node](Pass&... passes) { (passes.Leave##name(node), ...); }, this->Passes); \
+    }
+#define AST_KIND_BEGIN(name)
+#define AST_KIND_END(name)
+    AST_KINDS
+#undef AST_KIND
+#undef AST_KIND_BEGIN
+#undef AST_KIND_END
+};
+
+template<typename... Pass>
+void Ast_WalkFused(Ast* root, Pass&... passes) {
+    AstFusedVisitor<Pass...> fused(passes...);
+    fused.Walk(root);
+}
+
+// Adds one node to the counts of its kind
+void AstStats_AddNode(AstStats& stats, Ast* ast);
+
+// Counts the nodes by kind into 'Stats', what Ast_CollectStats runs
+struct AstStatsPass : AstVisitor<AstStatsPass> {
+    AstStats* Stats;
+
+    explicit AstStatsPass(AstStats& stats) : Stats(&stats) {}
+
+    void EnterNode(Ast* node) {
+        AstStats_AddNode(*this->Stats, node);
+    }
+};
+
 #if !defined(KEEP_AST_KINDS)
     #undef AST_KINDS
 #endif
 
 void Ast_Print(Ast* ast, u64 indent = 0);
+
+// Adds up the nodes reachable from 'ast', has to run before resolving since that points nodes at shared types
+void Ast_CollectStats(Ast* ast, AstStats& stats);
+void AstStats_Print(const AstStats& stats);
+void AstStats_PrintAllocations(const AstStats& stats);
@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+// 'value' must not be 0
+inline u32 Bits_CountTrailingZeros(u32 value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return (u32)index;
+#else
+    return (u32)__builtin_ctz(value);
+#endif
+}
+
+// 'value' must not be 0
+inline u32 Bits_CountTrailingZeros64(u64 value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return (u32)index;
+#elif defined(_MSC_VER)
+    return (u32)value != 0 ? Bits_CountTrailingZeros((u32)value) : 32 + Bits_CountTrailingZeros((u32)(value >> 32));
+#else
+    return (u32)__builtin_ctzll(value);
+#endif
+}
+
+// 'value' must not be 0
+inline u32 Bits_FindLastSet(u32 value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse(&index, value);
+    return (u32)index;
+#else
+    return 31 - (u32)__builtin_clz(value);
+#endif
+}
+
+inline u32 Bits_CountOnes(u32 value) {
+#if defined(_MSC_VER)
+    // __popcnt needs a CPU with POPCNT, which not every SSE2 machine has
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+#else
+    return (u32)__builtin_popcount(value);
+#endif
+}
+
+// 'value' must not be 0
+inline u32 Bits_CountLeadingZeros64(u64 value) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - (u32)index;
+#elif defined(_MSC_VER)
+    u32 high = (u32)(value >> 32);
+    return high != 0 ? 31 - Bits_FindLastSet(high) : 63 - Bits_FindLastSet((u32)value);
+#else
+    return (u32)__builtin_clzll(value);
+#endif
+}
+
+// Returns the low 64 bits of the full product, the high 64 bits go into 'high'
+inline u64 Bits_Multiply128(u64 a, u64 b, u64& high) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, &high);
+#elif defined(_MSC_VER)
+    u64 aLow    = (u32)a;
+    u64 aHigh   = a >> 32;
+    u64 bLow    = (u32)b;
+    u64 bHigh   = b >> 32;
+    u64 lowLow  = aLow * bLow;
+    u64 highLow = aHigh * bLow + (lowLow >> 32);
+    u64 lowHigh = aLow * bHigh + (u32)highLow;
+    high        = aHigh * bHigh + (highLow >> 32) + (lowHigh >> 32);
+    return (lowHigh << 32) | (u32)lowLow;
+#else
+    unsigned __int128 product = (unsigned __int128)a * b;
+    high                      = (u64)(product >> 64);
+    return (u64)product;
+#endif
+}
+
+// Each of these leaves the wrapped result in 'result' and returns whether the true one did not fit
+inline bool Bits_AddOverflow(s64 a, s64 b, s64& result) {
+#if defined(_MSC_VER)
+    result = (s64)((u64)a + (u64)b);
+    return b > 0 ? a > INT64_MAX - b : a < INT64_MIN - b;
+#else
+    return __builtin_add_overflow(a, b, &result);
+#endif
+}
+
+inline bool Bits_SubtractOverflow(s64 a, s64 b, s64& result) {
+#if defined(_MSC_VER)
+    result = (s64)((u64)a - (u64)b);
+    return b > 0 ? a < INT64_MIN + b : a > INT64_MAX + b;
+#else
+    return __builtin_sub_overflow(a, b, &result);
+#endif
+}
+
+inline bool Bits_MultiplyOverflow(s64 a, s64 b, s64& result) {
+#if defined(_MSC_VER) && defined(_M_X64)
+    s64 high;
+    result = _mul128(a, b, &high);
+    // It fits when the high word is only the sign of the low one
+    return high != (result >> 63);
+#elif defined(_MSC_VER)
+    result = (s64)((u64)a * (u64)b);
+    if (a == 0 || b == 0) {
+        return false;
+    }
+    // INT64_MIN / -1 does not fit itself, so those are checked before dividing
+    if ((a == -1 && b == INT64_MIN) || (b == -1 && a == INT64_MIN)) {
+        return true;
+    }
+    return result / b != a;
+#else
+    return __builtin_mul_overflow(a, b, &result);
+#endif
+}
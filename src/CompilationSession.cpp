@@ -0,0 +1,70 @@
+#include "CompilationSession.hpp"
+#include "Interner.hpp"
+#include "TypeTable.hpp"
+
+CompilationSession CompilationSession_Create(bool hugePages) {
+    CompilationSession session = {};
+    session.FileOpen           = false;
+    session.Nodes              = Arena_Create(MemoryCategory::Ast, ARENA_DEFAULT_PAGE_SIZE, hugePages);
+    session.Parsing            = ParserStorage_Create();
+    session.Flat               = FlatAst_Create();
+    session.Constants          = Evaluator_Create();
+    session.Incremental        = IncrementalResolver_Create();
+    session.FilesOpened        = 0;
+    return session;
+}
+
+void CompilationSession_Destroy(CompilationSession& session) {
+    if (session.FileOpen) {
+        SourceFile_Close(session.File);
+    }
+    Arena_Destroy(session.Nodes);
+    ParserStorage_Destroy(session.Parsing);
+    FlatAst_Destroy(session.Flat);
+    Evaluator_Destroy(session.Constants);
+    IncrementalResolver_Destroy(session.Incremental);
+    session = {};
+}
+
+void CompilationSession_Reset(CompilationSession& session) {
+    if (session.FileOpen) {
+        SourceFile_Close(session.File);
+        session.FileOpen = false;
+    }
+
+    // The nodes go with the arena they are in
+    Arena_Reset(session.Nodes);
+    AstAllocations = {};
+    FlatAst_Reset(session.Flat);
+    Evaluator_Reset(session.Constants);
+    IncrementalResolver_Reset(session.Incremental);
+    Interner_Reset(GlobalInterner);
+    TypeTable_Reset(GlobalTypes);
+}
+
+bool CompilationSession_Open(CompilationSession& session, const char* path) {
+    CompilationSession_Reset(session);
+
+    if (!SourceFile_Open(session.File, path)) {
+        return false;
+    }
+    session.FileOpen = true;
+    session.FilesOpened++;
+    return true;
+}
+
+bool CompilationSession_OpenRevision(CompilationSession& session, const char* path) {
+    if (session.FileOpen) {
+        SourceFile_Close(session.File);
+        session.FileOpen = false;
+    }
+    FlatAst_Reset(session.Flat);
+    Evaluator_Reset(session.Constants);
+
+    if (!SourceFile_Open(session.File, path)) {
+        return false;
+    }
+    session.FileOpen = true;
+    session.FilesOpened++;
+    return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Arena.hpp"
+#include "SourceFile.hpp"
+#include "Parser.hpp"
+#include "FlatAst.hpp"
+#include "Evaluator.hpp"
+#include "Incremental.hpp"
+
+// Everything compiling a file needs, kept from one file to the next so a process compiling many of them reuses
+// the same pages and buffers instead of giving them back and faulting them in again.
+// Names and types still go into GlobalInterner and GlobalTypes, which every reset clears, so only one session
+// can be compiling at a time
+struct CompilationSession {
+    SourceFile File;
+    bool FileOpen;
+
+    Arena Nodes;                     // The AST
+    ParserStorage Parsing;           // Tokens, literal values, line starts and diagnostics, lent to each file's Parser
+    FlatAst Flat;                    // For the handle based copy of the tree, when it is used
+    Evaluator Constants;             // The values of constant declarations, once they are asked for
+    IncrementalResolver Incremental; // What was resolved in the revisions of the file before this one
+
+    u64 FilesOpened;
+};
+
+CompilationSession CompilationSession_Create(bool hugePages = false);
+void CompilationSession_Destroy(CompilationSession& session);
+
+// Forgets the last file, its source, AST, names, types, constants and diagnostics, but keeps the memory they were in
+void CompilationSession_Reset(CompilationSession& session);
+
+// Resets the session and opens 'path' in it, false when the file cannot be read
+bool CompilationSession_Open(CompilationSession& session, const char* path);
+
+// Opens 'path' as the next revision of the file that is open. Its source and diagnostics replace the last ones, but the
+// AST, names and types of every revision so far are kept, the IncrementalResolver moves parts of them into the new tree
+bool CompilationSession_OpenRevision(CompilationSession& session, const char* path);
@@ -25,10 +25,6 @@ using s64 = int64_t;
 using f32 = float;
 using f64 = double;
 
-#define Alloc(size) std::malloc(size)
-
-#define Dealloc(ptr) std::free(size)
-
 #define Error(message, ...)                           \
     do {                                              \
         std::fflush(stdout);                          \
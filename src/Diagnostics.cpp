@@ -0,0 +1,125 @@
+#include "Diagnostics.hpp"
+#include "Ast.hpp"
+
+String GetDiagnosticMessage(DiagnosticKind kind) {
+    switch (kind) {
+#define DIAGNOSTIC_KIND(name, message) \
+    case DiagnosticKind::name:         \
+        return message;
+        DIAGNOSTIC_KINDS
+#undef DIAGNOSTIC_KIND
+    }
+
+    Error("Unknown diagnostic kind!");
+}
+
+DiagnosticList DiagnosticList_Create(u64 limit) {
+    DiagnosticList list = {};
+    list.Records        = Array_Create<Diagnostic>(0, MemoryCategory::Diagnostics);
+    list.Limit          = limit;
+    list.Dropped        = 0;
+    return list;
+}
+
+void DiagnosticList_Destroy(DiagnosticList& list) {
+    Array_Destroy(list.Records);
+    list = {};
+}
+
+void DiagnosticList_Clear(DiagnosticList& list) {
+    Array_Clear(list.Records);
+    list.Dropped = 0;
+}
+
+void DiagnosticList_UseArena(DiagnosticList& list, Arena& arena) {
+    // Records from an arena might be in pages that were reset since, those are left alone
+    if (list.Records.Owner == nullptr) {
+        Array_Destroy(list.Records);
+    }
+    list.Records = Array_Create<Diagnostic>(arena);
+    list.Dropped = 0;
+}
+
+void DiagnosticList_Add(DiagnosticList& list,
+                        DiagnosticKind kind,
+                        u32 position,
+                        u32 length,
+                        DiagnosticArgument argument0,
+                        DiagnosticArgument argument1) {
+    if (list.Records.Length >= list.Limit) {
+        list.Dropped++;
+        return;
+    }
+
+    // The only allocation a file's diagnostics ever make
+    if (list.Records.Capacity == 0) {
+        Array_Reserve(list.Records, list.Limit);
+    }
+
+    Diagnostic diagnostic   = {};
+    diagnostic.Kind         = kind;
+    diagnostic.Position     = position;
+    diagnostic.Length       = length;
+    diagnostic.Arguments[0] = argument0;
+    diagnostic.Arguments[1] = argument1;
+    Array_Add(list.Records, diagnostic);
+}
+
+u64 Diagnostic_Format(const Diagnostic& diagnostic, char* buffer, u64 size) {
+    u64 length = 0;
+
+    auto Append = [&](const char* data, u64 count) -> void {
+        if (length < size) {
+            u64 space = size - length - 1;
+            std::memcpy(buffer + length, data, count < space ? count : space);
+        }
+        length += count;
+    };
+
+    String message    = GetDiagnosticMessage(diagnostic.Kind);
+    u64 argumentIndex = 0;
+    for (u64 i = 0; i < message.Length; i++) {
+        if (message[i] != '{' || i + 1 >= message.Length || message[i + 1] != '}' || argumentIndex >= 2) {
+            Append((const char*)&message[i], 1);
+            continue;
+        }
+        i++;
+
+        const DiagnosticArgument& argument = diagnostic.Arguments[argumentIndex++];
+        switch (argument.Kind) {
+            case DiagnosticArgumentKind::None: {
+            } break;
+
+            case DiagnosticArgumentKind::Character: {
+                Append((const char*)&argument.CharacterValue, 1);
+            } break;
+
+            case DiagnosticArgumentKind::Integer: {
+                char digits[32];
+                int count = std::snprintf(digits, sizeof(digits), "%llu", (unsigned long long)argument.IntegerValue);
+                Append(digits, (u64)count);
+            } break;
+
+            case DiagnosticArgumentKind::TokenKind: {
+                String name = GetTokenKindName(argument.TokenKindValue);
+                Append((const char*)name.Data, name.Length);
+            } break;
+
+            case DiagnosticArgumentKind::AstKind: {
+                String name = GetAstKindName(argument.AstKindValue);
+                Append((const char*)name.Data, name.Length);
+            } break;
+        }
+    }
+
+    if (size != 0) {
+        buffer[length < size ? length : size - 1] = '\0';
+    }
+    return length;
+}
+
+void Diagnostic_Print(const Diagnostic& diagnostic, SourceLocation location) {
+    char buffer[256];
+    Diagnostic_Format(diagnostic, buffer, sizeof(buffer));
+    PrintError("%u:%u: %s\n", location.Line, location.Column, buffer);
+}
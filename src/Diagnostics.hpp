@@ -0,0 +1,118 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "String.hpp"
+#include "Array.hpp"
+#include "Token.hpp"
+#include "LineTable.hpp"
+
+enum struct AstKind : u8;
+
+// Each '{}' in a message is replaced by the next argument when the diagnostic gets printed
+#define DIAGNOSTIC_KINDS                                                                                    \
+    DIAGNOSTIC_KIND(UnknownCharacter, "Unknown character '{}'")                                             \
+    DIAGNOSTIC_KIND(DigitTooBigForBase, "Digit '{}' too big for base {}")                                   \
+    DIAGNOSTIC_KIND(NumberWithoutDigits, "Expected digits after '0{}'")                                     \
+    DIAGNOSTIC_KIND(IntegerLiteralTooBig, "Integer literal does not fit in 64 bits")                        \
+    DIAGNOSTIC_KIND(FloatLiteralTooBig, "Float literal is too big")                                         \
+                                                                                                            \
+    DIAGNOSTIC_KIND(ExpectedToken, "Expected '{}' got '{}'")                                                \
+    DIAGNOSTIC_KIND(ExpectedName, "Expected 'Name' got '{}'")                                               \
+    DIAGNOSTIC_KIND(UnexpectedToken, "Unexpected '{}'")                                                     \
+    DIAGNOSTIC_KIND(DeclarationWithoutTypeOrValue, "Cannot declare variable with nether type nor value")    \
+    DIAGNOSTIC_KIND(ArgumentWithoutTypeOrValue, "Cannot have a declaration with no type nor value")         \
+    DIAGNOSTIC_KIND(ProcedureTypeArgumentWithoutType, "Must always have argument type for procedure type!")
+
+enum struct DiagnosticKind : u8 {
+#define DIAGNOSTIC_KIND(name, message) name,
+    DIAGNOSTIC_KINDS
+#undef DIAGNOSTIC_KIND
+};
+
+String GetDiagnosticMessage(DiagnosticKind kind);
+
+enum struct DiagnosticArgumentKind : u8 {
+    None,
+    Character,
+    Integer,
+    TokenKind,
+    AstKind,
+};
+
+struct DiagnosticArgument {
+    DiagnosticArgumentKind Kind;
+
+    union {
+        u8 CharacterValue;
+        u64 IntegerValue;
+        TokenKind TokenKindValue;
+        AstKind AstKindValue;
+    };
+};
+
+inline DiagnosticArgument DiagnosticArgument_Character(u8 value) {
+    DiagnosticArgument argument = {};
+    argument.Kind               = DiagnosticArgumentKind::Character;
+    argument.CharacterValue     = value;
+    return argument;
+}
+
+inline DiagnosticArgument DiagnosticArgument_Integer(u64 value) {
+    DiagnosticArgument argument = {};
+    argument.Kind               = DiagnosticArgumentKind::Integer;
+    argument.IntegerValue       = value;
+    return argument;
+}
+
+inline DiagnosticArgument DiagnosticArgument_TokenKind(TokenKind value) {
+    DiagnosticArgument argument = {};
+    argument.Kind               = DiagnosticArgumentKind::TokenKind;
+    argument.TokenKindValue     = value;
+    return argument;
+}
+
+inline DiagnosticArgument DiagnosticArgument_AstKind(AstKind value) {
+    DiagnosticArgument argument = {};
+    argument.Kind               = DiagnosticArgumentKind::AstKind;
+    argument.AstKindValue       = value;
+    return argument;
+}
+
+// Nothing is formatted when a diagnostic is reported, only when someone asks for the text
+struct Diagnostic {
+    DiagnosticKind Kind;
+    u32 Position;
+    u32 Length;
+    DiagnosticArgument Arguments[2];
+};
+
+#define DIAGNOSTIC_DEFAULT_LIMIT 100
+
+// Everything reported for one file, anything past 'Limit' is only counted
+struct DiagnosticList {
+    Array<Diagnostic> Records;
+    u64 Limit;
+    u64 Dropped;
+};
+
+DiagnosticList DiagnosticList_Create(u64 limit = DIAGNOSTIC_DEFAULT_LIMIT);
+void DiagnosticList_Destroy(DiagnosticList& list);
+// Drops every diagnostic, keeping the limit and the storage
+void DiagnosticList_Clear(DiagnosticList& list);
+// Drops every diagnostic, the ones after that are allocated from 'arena' and go away when it is reset
+void DiagnosticList_UseArena(DiagnosticList& list, Arena& arena);
+
+void DiagnosticList_Add(DiagnosticList& list,
+                        DiagnosticKind kind,
+                        u32 position,
+                        u32 length,
+                        DiagnosticArgument argument0 = {},
+                        DiagnosticArgument argument1 = {});
+
+inline u64 DiagnosticList_Count(const DiagnosticList& list) {
+    return list.Records.Length + list.Dropped;
+}
+
+// Same return value as snprintf, the length the whole message would have
+u64 Diagnostic_Format(const Diagnostic& diagnostic, char* buffer, u64 size);
+void Diagnostic_Print(const Diagnostic& diagnostic, SourceLocation location);
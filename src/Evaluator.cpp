@@ -0,0 +1,504 @@
+#include "Evaluator.hpp"
+#include "Bits.hpp"
+#include "Interner.hpp"
+#include "Resolver.hpp"
+
+#include <cmath>
+
+#define EVAL_INITIAL_SLOTS 256
+
+String GetEvalStatusMessage(EvalStatus status) {
+    switch (status) {
+#define EVAL_STATUS(name, message) \
+    case EvalStatus::name:         \
+        return message;
+        EVAL_STATUSES
+#undef EVAL_STATUS
+    }
+
+    Error("Unknown evaluation status!");
+}
+
+ConstValue ConstValue_Integer(s64 value) {
+    ConstValue result = {};
+    result.Kind       = ConstKind::Integer;
+    result.Integer    = value;
+    return result;
+}
+
+ConstValue ConstValue_Float(f64 value) {
+    ConstValue result = {};
+    result.Kind       = ConstKind::Float;
+    result.Float      = value;
+    return result;
+}
+
+ConstValue ConstValue_Procedure(AstProcedure* procedure) {
+    ConstValue result = {};
+    result.Kind       = ConstKind::Procedure;
+    result.Procedure  = procedure;
+    return result;
+}
+
+void ConstValue_Print(const ConstValue& value) {
+    switch (value.Kind) {
+        case ConstKind::Integer: {
+            PrintError("%lld", (long long)value.Integer);
+        } break;
+
+        case ConstKind::Float: {
+            PrintError("%f", value.Float);
+        } break;
+
+        case ConstKind::Procedure: {
+            PrintError("procedure");
+        } break;
+    }
+}
+
+EvalStatus Const_GetIntegerLiteral(Ast* ast, ConstValue& result) {
+    u64 value = ast->IntegerLiteral().Value;
+    if (ast->IntegerLiteral().IntToken.Kind == TokenKind::Integer && value > (u64)INT64_MAX) {
+        return EvalStatus::Overflow;
+    }
+    result = ConstValue_Integer((s64)value);
+    return EvalStatus::Done;
+}
+
+bool Const_IsNegatedMinimum(TokenKind operator_, Ast* operand) {
+    return operator_ == TokenKind::Minus && Ast_IsIntegerLiteral(operand) &&
+           operand->IntegerLiteral().IntToken.Kind == TokenKind::Integer &&
+           operand->IntegerLiteral().Value == (u64)INT64_MAX + 1;
+}
+
+EvalStatus Const_ApplyUnary(TokenKind operator_, const ConstValue& operand, ConstValue& result) {
+    // '*' and '^' go through pointers, which have no value here
+    if (operator_ != TokenKind::Plus && operator_ != TokenKind::Minus) {
+        return EvalStatus::NotConstant;
+    }
+
+    if (operand.Kind == ConstKind::Integer) {
+        if (operator_ == TokenKind::Minus && operand.Integer == INT64_MIN) {
+            return EvalStatus::Overflow;
+        }
+        result = ConstValue_Integer(operator_ == TokenKind::Minus ? -operand.Integer : operand.Integer);
+        return EvalStatus::Done;
+    } else if (operand.Kind == ConstKind::Float) {
+        result = ConstValue_Float(operator_ == TokenKind::Minus ? -operand.Float : operand.Float);
+        return EvalStatus::Done;
+    }
+    return EvalStatus::InvalidOperands;
+}
+
+static EvalStatus Const_ApplyInteger(TokenKind operator_, s64 a, s64 b, ConstValue& result) {
+    s64 value = 0;
+    switch (operator_) {
+        case TokenKind::Plus: {
+            if (Bits_AddOverflow(a, b, value)) {
+                return EvalStatus::Overflow;
+            }
+        } break;
+
+        case TokenKind::Minus: {
+            if (Bits_SubtractOverflow(a, b, value)) {
+                return EvalStatus::Overflow;
+            }
+        } break;
+
+        case TokenKind::Asterisk: {
+            if (Bits_MultiplyOverflow(a, b, value)) {
+                return EvalStatus::Overflow;
+            }
+        } break;
+
+        case TokenKind::Slash:
+        case TokenKind::Percent: {
+            if (b == 0) {
+                return EvalStatus::DivisionByZero;
+            }
+            // The one quotient that does not fit
+            if (a == INT64_MIN && b == -1) {
+                if (operator_ == TokenKind::Slash) {
+                    return EvalStatus::Overflow;
+                }
+                value = 0;
+            } else {
+                value = operator_ == TokenKind::Slash ? a / b : a % b;
+            }
+        } break;
+
+        case TokenKind::LessThan: {
+            value = a < b;
+        } break;
+
+        case TokenKind::LessThanEquals: {
+            value = a <= b;
+        } break;
+
+        case TokenKind::GreaterThan: {
+            value = a > b;
+        } break;
+
+        case TokenKind::GreaterThanEquals: {
+            value = a >= b;
+        } break;
+
+        default:
+            return EvalStatus::NotConstant;
+    }
+
+    result = ConstValue_Integer(value);
+    return EvalStatus::Done;
+}
+
+static EvalStatus Const_ApplyFloat(TokenKind operator_, f64 a, f64 b, ConstValue& result) {
+    f64 value = 0.0;
+    switch (operator_) {
+        case TokenKind::Plus: {
+            value = a + b;
+        } break;
+
+        case TokenKind::Minus: {
+            value = a - b;
+        } break;
+
+        case TokenKind::Asterisk: {
+            value = a * b;
+        } break;
+
+        case TokenKind::Slash:
+        case TokenKind::Percent: {
+            if (b == 0.0) {
+                return EvalStatus::DivisionByZero;
+            }
+            value = operator_ == TokenKind::Slash ? a / b : std::fmod(a, b);
+        } break;
+
+        // Comparisons give integers, there is no boolean type
+        case TokenKind::LessThan:
+            result = ConstValue_Integer(a < b);
+            return EvalStatus::Done;
+        case TokenKind::LessThanEquals:
+            result = ConstValue_Integer(a <= b);
+            return EvalStatus::Done;
+        case TokenKind::GreaterThan:
+            result = ConstValue_Integer(a > b);
+            return EvalStatus::Done;
+        case TokenKind::GreaterThanEquals:
+            result = ConstValue_Integer(a >= b);
+            return EvalStatus::Done;
+
+        default:
+            return EvalStatus::NotConstant;
+    }
+
+    // Literals are finite, so an infinity can only come from going past the largest double
+    if (std::isinf(value)) {
+        return EvalStatus::Overflow;
+    }
+    result = ConstValue_Float(value);
+    return EvalStatus::Done;
+}
+
+EvalStatus Const_ApplyBinary(TokenKind operator_, const ConstValue& left, const ConstValue& right, ConstValue& result) {
+    if (left.Kind != right.Kind || left.Kind == ConstKind::Procedure) {
+        return EvalStatus::InvalidOperands;
+    }
+    if (left.Kind == ConstKind::Integer) {
+        return Const_ApplyInteger(operator_, left.Integer, right.Integer, result);
+    }
+    return Const_ApplyFloat(operator_, left.Float, right.Float, result);
+}
+
+static EvalSlot* Evaluator_AllocateSlots(u64 slotCount) {
+    return (EvalSlot*)Memory_AllocateZeroed(MemoryCategory::Constants, slotCount * sizeof(EvalSlot));
+}
+
+// Nodes are at least 8 byte aligned, the low bits say nothing
+static u64 Evaluator_GetSlotIndex(AstDeclaration* declaration, u64 mask) {
+    return (((u64)declaration >> 3) * 0x9E3779B97F4A7C15ull >> 32) & mask;
+}
+
+static void Evaluator_Rehash(Evaluator& evaluator, u64 slotCount) {
+    EvalSlot* slots = Evaluator_AllocateSlots(slotCount);
+    u64 mask        = slotCount - 1;
+
+    for (u64 i = 0; i < evaluator.SlotCount; i++) {
+        const EvalSlot& slot = evaluator.Slots[i];
+        if (slot.Declaration == nullptr) {
+            continue;
+        }
+
+        u64 index = Evaluator_GetSlotIndex(slot.Declaration, mask);
+        while (slots[index].Declaration != nullptr) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+    }
+
+    Dealloc(Constants, evaluator.Slots, evaluator.SlotCount * sizeof(EvalSlot));
+    evaluator.Slots     = slots;
+    evaluator.SlotCount = slotCount;
+}
+
+// The slot of 'declaration', a new one when it has none. Only valid until the next new slot
+static EvalSlot& Evaluator_GetSlot(Evaluator& evaluator, AstDeclaration* declaration) {
+    u64 mask = evaluator.SlotCount - 1;
+    for (u64 index = Evaluator_GetSlotIndex(declaration, mask);; index = (index + 1) & mask) {
+        EvalSlot& slot = evaluator.Slots[index];
+        if (slot.Declaration == declaration) {
+            return slot;
+        }
+        if (slot.Declaration != nullptr) {
+            continue;
+        }
+
+        // Keep the load factor at or under one half
+        if ((evaluator.SlotsUsed + 1) * 2 > evaluator.SlotCount) {
+            Evaluator_Rehash(evaluator, evaluator.SlotCount * 2);
+            return Evaluator_GetSlot(evaluator, declaration);
+        }
+        evaluator.SlotsUsed++;
+        slot             = {};
+        slot.Declaration = declaration;
+        return slot;
+    }
+}
+
+Evaluator Evaluator_Create() {
+    Evaluator evaluator  = {};
+    evaluator.Slots      = Evaluator_AllocateSlots(EVAL_INITIAL_SLOTS);
+    evaluator.SlotCount  = EVAL_INITIAL_SLOTS;
+    evaluator.Stack      = Array_Create<EvalFrame>(0, MemoryCategory::Constants);
+    evaluator.Values     = Array_Create<ConstValue>(0, MemoryCategory::Constants);
+    evaluator.StepLimit  = EVAL_DEFAULT_STEP_LIMIT;
+    evaluator.StackLimit = EVAL_DEFAULT_STACK_LIMIT;
+    return evaluator;
+}
+
+void Evaluator_Destroy(Evaluator& evaluator) {
+    Dealloc(Constants, evaluator.Slots, evaluator.SlotCount * sizeof(EvalSlot));
+    Array_Destroy(evaluator.Stack);
+    Array_Destroy(evaluator.Values);
+    evaluator = {};
+}
+
+void Evaluator_Reset(Evaluator& evaluator) {
+    std::memset(evaluator.Slots, 0, evaluator.SlotCount * sizeof(EvalSlot));
+    evaluator.SlotsUsed = 0;
+    Array_Clear(evaluator.Stack);
+    Array_Clear(evaluator.Values);
+    evaluator.Stats = {};
+}
+
+// Gives every declaration still on the stack the status the evaluation ended with
+static void Evaluator_Fail(Evaluator& evaluator, EvalStatus status) {
+    for (u64 i = 0; i < evaluator.Stack.Length; i++) {
+        const EvalFrame& frame = evaluator.Stack[i];
+        if (Ast_IsDeclaration(frame.Node) && frame.Entered) {
+            EvalSlot& slot  = Evaluator_GetSlot(evaluator, frame.Node);
+            slot.Evaluating = false;
+            slot.Evaluated  = true;
+            slot.Status     = status;
+        }
+    }
+    Array_Clear(evaluator.Stack);
+    Array_Clear(evaluator.Values);
+}
+
+// Takes the first step of the top frame: pushes its operands, or its value when it has none
+static EvalStatus Evaluator_Enter(Evaluator& evaluator) {
+    EvalFrame& top = evaluator.Stack[evaluator.Stack.Length - 1];
+    Ast* node      = top.Node;
+    top.Entered    = true;
+
+    switch (node->Kind) {
+        case AstKind::Declaration: {
+            EvalSlot& slot = Evaluator_GetSlot(evaluator, node);
+            if (slot.Evaluating) {
+                return EvalStatus::Cycle;
+            }
+            if (slot.Evaluated) {
+                evaluator.Stats.Reused++;
+                if (slot.Status != EvalStatus::Done) {
+                    return slot.Status;
+                }
+                Array_Add(evaluator.Values, slot.Value);
+                evaluator.Stack.Length--;
+                return EvalStatus::Done;
+            }
+
+            if (!node->Declaration().Constant || node->Declaration().Value == nullptr) {
+                return EvalStatus::NotConstant;
+            }
+            slot.Evaluating = true;
+            Array_Add(evaluator.Stack, { node->Declaration().Value, false });
+        } break;
+
+        case AstKind::IntegerLiteral: {
+            ConstValue value  = {};
+            EvalStatus status = Const_GetIntegerLiteral(node, value);
+            if (status != EvalStatus::Done) {
+                return status;
+            }
+            Array_Add(evaluator.Values, value);
+            evaluator.Stack.Length--;
+        } break;
+
+        case AstKind::FloatLiteral: {
+            Array_Add(evaluator.Values, ConstValue_Float(node->FloatLiteral().Value));
+            evaluator.Stack.Length--;
+        } break;
+
+        case AstKind::Procedure: {
+            Array_Add(evaluator.Values, ConstValue_Procedure(node));
+            evaluator.Stack.Length--;
+        } break;
+
+        // Stands for its declaration, so the frame becomes that
+        case AstKind::Name: {
+            Symbol name = node->Name().Identifier.Data.Name;
+            if (Resolve_IsBuiltinName(name)) {
+                return EvalStatus::NotConstant;
+            }
+            AstDeclaration* declaration = Resolve_FindDeclaration(node, name);
+            if (declaration == nullptr) {
+                return EvalStatus::NotConstant;
+            }
+            top.Node    = declaration;
+            top.Entered = false;
+        } break;
+
+        case AstKind::Unary: {
+            TokenKind operator_ = node->Unary().Operator.Kind;
+            if (operator_ != TokenKind::Plus && operator_ != TokenKind::Minus) {
+                return EvalStatus::NotConstant;
+            }
+            if (Const_IsNegatedMinimum(operator_, node->Unary().Operand)) {
+                Array_Add(evaluator.Values, ConstValue_Integer(INT64_MIN));
+                evaluator.Stack.Length--;
+                break;
+            }
+            Array_Add(evaluator.Stack, { node->Unary().Operand, false });
+        } break;
+
+        // The left operand goes on top so its value is pushed first
+        case AstKind::Binary: {
+            AstBinaryData& binary = node->Binary();
+            Array_Add(evaluator.Stack, { binary.Right, false });
+            Array_Add(evaluator.Stack, { binary.Left, false });
+        } break;
+
+        default:
+            return EvalStatus::NotConstant;
+    }
+    return EvalStatus::Done;
+}
+
+// Pops the top frame once its operands are on 'Values', replacing them with its own value
+static EvalStatus Evaluator_Leave(Evaluator& evaluator) {
+    Ast* node = evaluator.Stack[evaluator.Stack.Length - 1].Node;
+    evaluator.Stack.Length--;
+
+    Array<ConstValue>& values = evaluator.Values;
+    switch (node->Kind) {
+        case AstKind::Declaration: {
+            EvalSlot& slot  = Evaluator_GetSlot(evaluator, node);
+            slot.Evaluating = false;
+            slot.Evaluated  = true;
+            slot.Status     = EvalStatus::Done;
+            slot.Value      = values[values.Length - 1];
+            evaluator.Stats.Evaluated++;
+        } break;
+
+        case AstKind::Unary: {
+            ConstValue& operand = values[values.Length - 1];
+            return Const_ApplyUnary(node->Unary().Operator.Kind, operand, operand);
+        }
+
+        case AstKind::Binary: {
+            ConstValue right = values[values.Length - 1];
+            ConstValue& left = values[values.Length - 2];
+            values.Length--;
+            return Const_ApplyBinary(node->Binary().Operator.Kind, left, right, left);
+        }
+
+        default:
+            ASSERT(false);
+    }
+    return EvalStatus::Done;
+}
+
+EvalStatus Evaluator_Evaluate(Evaluator& evaluator, AstDeclaration* declaration, ConstValue& value) {
+    ASSERT(evaluator.Stack.Length == 0 && evaluator.Values.Length == 0);
+    Array_Add(evaluator.Stack, { declaration, false });
+
+    u64 steps = 0;
+    while (evaluator.Stack.Length != 0) {
+        EvalStatus status = EvalStatus::Done;
+        if (steps++ == evaluator.StepLimit) {
+            status = EvalStatus::StepLimit;
+        } else if (evaluator.Stack.Length > evaluator.StackLimit) {
+            status = EvalStatus::StackLimit;
+        } else if (evaluator.Stack[evaluator.Stack.Length - 1].Entered) {
+            status = Evaluator_Leave(evaluator);
+        } else {
+            status = Evaluator_Enter(evaluator);
+        }
+
+        if (evaluator.Stack.Length > evaluator.Stats.MaxStack) {
+            evaluator.Stats.MaxStack = evaluator.Stack.Length;
+        }
+        if (status != EvalStatus::Done) {
+            evaluator.Stats.Steps += steps;
+            Evaluator_Fail(evaluator, status);
+            return status;
+        }
+    }
+
+    evaluator.Stats.Steps += steps;
+    ASSERT(evaluator.Values.Length == 1);
+    value = evaluator.Values[0];
+    Array_Clear(evaluator.Values);
+    return EvalStatus::Done;
+}
+
+// Evaluates the constant declarations in the order they are walked
+struct EvalPrintPass : AstVisitor<EvalPrintPass> {
+    Evaluator* Constants;
+    u64 Errors = 0;
+
+    explicit EvalPrintPass(Evaluator& evaluator) : Constants(&evaluator) {}
+
+    void EnterDeclaration(AstDeclaration* node) {
+        if (!node->Declaration().Constant || !Ast_IsName(node->Declaration().Name)) {
+            return;
+        }
+
+        ConstValue value  = {};
+        EvalStatus status = Evaluator_Evaluate(*this->Constants, node, value);
+        Resolve_PrintName(node);
+        if (status == EvalStatus::Done) {
+            PrintError(" = ");
+            ConstValue_Print(value);
+        } else {
+            String message = GetEvalStatusMessage(status);
+            PrintError(" %.*s", (u32)message.Length, message.Data);
+        }
+        PrintError("\n");
+        this->Errors += EvalStatus_IsError(status);
+    }
+};
+
+bool Evaluator_PrintAll(Evaluator& evaluator, Ast* ast) {
+    PrintError("\nConstants:\n");
+    EvalPrintPass pass(evaluator);
+    pass.Walk(ast);
+
+    const EvalStats& stats = evaluator.Stats;
+    PrintError("Evaluated: %llu\n", stats.Evaluated);
+    PrintError("Reused: %llu\n", stats.Reused);
+    PrintError("Steps: %llu\n", stats.Steps);
+    PrintError("Max Stack: %llu\n", stats.MaxStack);
+    return pass.Errors == 0;
+}
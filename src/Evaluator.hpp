@@ -0,0 +1,119 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Array.hpp"
+#include "Ast.hpp"
+
+// Reduces constant declarations, 'name :: value' and 'name : type : value', to values while compiling. Values are
+// integers and floats built with the unary and binary operators out of literals and other constants, and procedures,
+// which are their own value. Each declaration is evaluated once, what it came to or why it could not be is kept for
+// whoever asks next. Works on the parsed tree, names are looked up the way the resolver does but nothing is resolved
+
+#define EVAL_STATUSES                                                              \
+    EVAL_STATUS(Done, "")                                                          \
+    EVAL_STATUS(NotConstant, "is not known at compile time")                       \
+    EVAL_STATUS(InvalidOperands, "applies an operator to values it does not take") \
+    EVAL_STATUS(Overflow, "overflows")                                             \
+    EVAL_STATUS(DivisionByZero, "divides by zero")                                 \
+    EVAL_STATUS(Cycle, "depends on itself")                                        \
+    EVAL_STATUS(StepLimit, "takes too many steps to evaluate")                     \
+    EVAL_STATUS(StackLimit, "nests too deeply to evaluate")
+
+enum struct EvalStatus : u8 {
+#define EVAL_STATUS(name, message) name,
+    EVAL_STATUSES
+#undef EVAL_STATUS
+};
+
+String GetEvalStatusMessage(EvalStatus status);
+
+// A constant that is not known at compile time is a variable that cannot change, the rest are mistakes
+inline bool EvalStatus_IsError(EvalStatus status) {
+    return status != EvalStatus::Done && status != EvalStatus::NotConstant;
+}
+
+enum struct ConstKind : u8 {
+    Integer,
+    Float,
+    Procedure,
+};
+
+struct ConstValue {
+    ConstKind Kind;
+
+    union {
+        s64 Integer;
+        f64 Float;
+        AstProcedure* Procedure;
+    };
+};
+
+ConstValue ConstValue_Integer(s64 value);
+ConstValue ConstValue_Float(f64 value);
+ConstValue ConstValue_Procedure(AstProcedure* procedure);
+void ConstValue_Print(const ConstValue& value);
+
+// What the integer literal 'ast' stands for. As written it holds what the lexer read, which is only an int up to
+// INT64_MAX, anything above that overflows. An operator the resolver folded into a literal holds the bits of its value
+// and keeps the operator's token
+EvalStatus Const_GetIntegerLiteral(Ast* ast, ConstValue& result);
+
+// '-' right in front of 2^63 as written, which is INT64_MIN: the one int that cannot be written without the operator
+bool Const_IsNegatedMinimum(TokenKind operator_, Ast* operand);
+
+// What 'operator_' gives for its operands. Integers are signed 64 bit and never wrap, comparisons give 0 or 1
+EvalStatus Const_ApplyUnary(TokenKind operator_, const ConstValue& operand, ConstValue& result);
+EvalStatus Const_ApplyBinary(TokenKind operator_, const ConstValue& left, const ConstValue& right, ConstValue& result);
+
+// What is known about one declaration
+struct EvalSlot {
+    AstDeclaration* Declaration; // Null for an empty slot
+    bool Evaluating;             // It is on the stack, meeting it again is a cycle
+    bool Evaluated;              // Status is what it came to
+    EvalStatus Status;
+    ConstValue Value; // When Status is Done
+};
+
+// A node being evaluated, its operands go on the stack above it and their values on 'Values'
+struct EvalFrame {
+    Ast* Node;
+    bool Entered;
+};
+
+struct EvalStats {
+    u64 Evaluated; // Declarations, none is evaluated twice
+    u64 Reused;    // Times a declaration was asked for again
+    u64 Steps;
+    u64 MaxStack;
+};
+
+// Steps and frames for one call of Evaluator_Evaluate, which includes the constants it needs that are not known yet
+#define EVAL_DEFAULT_STEP_LIMIT  (1 << 24)
+#define EVAL_DEFAULT_STACK_LIMIT (1 << 20)
+
+struct Evaluator {
+    EvalSlot* Slots; // Open addressed by declaration
+    u64 SlotCount;   // Always a power of 2
+    u64 SlotsUsed;
+
+    Array<EvalFrame> Stack;
+    Array<ConstValue> Values;
+
+    u64 StepLimit;
+    u64 StackLimit; // Bounds the memory an evaluation takes, the two arrays never get longer than this
+    EvalStats Stats;
+};
+
+Evaluator Evaluator_Create();
+void Evaluator_Destroy(Evaluator& evaluator);
+
+// Forgets every value, keeping the slots and the stacks for the next file
+void Evaluator_Reset(Evaluator& evaluator);
+
+// Evaluates 'declaration' and the constants it refers to, or looks up what that came to before. A declaration that
+// fails makes every one that refers to it fail the same way. 'value' is only set when it gives back Done
+EvalStatus Evaluator_Evaluate(Evaluator& evaluator, AstDeclaration* declaration, ConstValue& value);
+
+// Evaluates every constant declaration under 'ast' in source order and prints what each came to, for --const-values.
+// False when one of them is an error
+bool Evaluator_PrintAll(Evaluator& evaluator, Ast* ast);
@@ -0,0 +1,883 @@
+#include "FlatAst.hpp"
+#include "Evaluator.hpp"
+#include "SmallArray.hpp"
+
+#define FLAT_AST_INITIAL_TYPE_SLOTS 256
+
+static void FlatAst_AddBuiltins(FlatAst& flat) {
+    Array_Add(flat.Symbols, FlatAstSymbol{ Symbol_None, 0, AST_HANDLE_NONE });
+
+    // Takes up AST_HANDLE_NONE, so looking at the fields of no node is harmless
+    FlatAst_AddNode(flat, AstKind::TypeVoid, AST_HANDLE_NONE, AST_HANDLE_NONE, 0, 0);
+
+    flat.TypeType  = FlatAst_GetType(flat, AstKind::TypeType, 0, nullptr, 0);
+    flat.TypeVoid  = FlatAst_GetType(flat, AstKind::TypeVoid, 0, nullptr, 0);
+    flat.TypeInt   = FlatAst_GetType(flat, AstKind::TypeInteger, FLAT_AST_SIGNED_BIT, nullptr, 0);
+    flat.TypeFloat = FlatAst_GetType(flat, AstKind::TypeFloat, 0, nullptr, 0);
+}
+
+FlatAst FlatAst_Create() {
+    FlatAst flat          = {};
+    flat.Kinds            = Array_Create<AstKind>(0, MemoryCategory::Ast);
+    flat.Completions      = Array_Create<AstCompletion>(0, MemoryCategory::Ast);
+    flat.ParentScopes     = Array_Create<AstHandle>(0, MemoryCategory::Ast);
+    flat.ParentStatements = Array_Create<AstHandle>(0, MemoryCategory::Ast);
+    flat.Ordinals         = Array_Create<u32>(0, MemoryCategory::Ast);
+    flat.Types            = Array_Create<AstHandle>(0, MemoryCategory::Ast);
+    flat.FirstChild       = Array_Create<u32>(0, MemoryCategory::Ast);
+    flat.ChildCount       = Array_Create<u32>(0, MemoryCategory::Ast);
+    flat.Values           = Array_Create<u64>(0, MemoryCategory::Ast);
+    flat.Children         = Array_Create<AstHandle>(0, MemoryCategory::Ast);
+    flat.Symbols          = Array_Create<FlatAstSymbol>(0, MemoryCategory::Ast);
+    flat.TypeSlots        = Array_Create<AstHandle>(FLAT_AST_INITIAL_TYPE_SLOTS, MemoryCategory::Types);
+    for (u64 i = 0; i < FLAT_AST_INITIAL_TYPE_SLOTS; i++) {
+        Array_Add(flat.TypeSlots, (AstHandle)AST_HANDLE_NONE);
+    }
+
+    FlatAst_AddBuiltins(flat);
+    return flat;
+}
+
+void FlatAst_Destroy(FlatAst& flat) {
+    Array_Destroy(flat.Kinds);
+    Array_Destroy(flat.Completions);
+    Array_Destroy(flat.ParentScopes);
+    Array_Destroy(flat.ParentStatements);
+    Array_Destroy(flat.Ordinals);
+    Array_Destroy(flat.Types);
+    Array_Destroy(flat.FirstChild);
+    Array_Destroy(flat.ChildCount);
+    Array_Destroy(flat.Values);
+    Array_Destroy(flat.Children);
+    Array_Destroy(flat.Symbols);
+    Array_Destroy(flat.TypeSlots);
+    flat = {};
+}
+
+void FlatAst_Reset(FlatAst& flat) {
+    Array_Clear(flat.Kinds);
+    Array_Clear(flat.Completions);
+    Array_Clear(flat.ParentScopes);
+    Array_Clear(flat.ParentStatements);
+    Array_Clear(flat.Ordinals);
+    Array_Clear(flat.Types);
+    Array_Clear(flat.FirstChild);
+    Array_Clear(flat.ChildCount);
+    Array_Clear(flat.Values);
+    Array_Clear(flat.Children);
+    Array_Clear(flat.Symbols);
+    for (u64 i = 0; i < flat.TypeSlots.Length; i++) {
+        flat.TypeSlots[i] = AST_HANDLE_NONE;
+    }
+    flat.TypeStats = {};
+
+    FlatAst_AddBuiltins(flat);
+}
+
+AstHandle FlatAst_AddNode(
+    FlatAst& flat, AstKind kind, AstHandle parentScope, AstHandle parentStatement, u32 childCount, u64 value) {
+    AstHandle node = (AstHandle)flat.Kinds.Length;
+    Array_Add(flat.Kinds, kind);
+    Array_Add(flat.Completions, AstCompletion::Incomplete);
+    Array_Add(flat.ParentScopes, parentScope);
+    Array_Add(flat.ParentStatements, parentStatement);
+    Array_Add(flat.Ordinals, 0u);
+    Array_Add(flat.Types, (AstHandle)AST_HANDLE_NONE);
+    Array_Add(flat.FirstChild, (u32)flat.Children.Length);
+    Array_Add(flat.ChildCount, childCount);
+    Array_Add(flat.Values, value);
+    for (u32 i = 0; i < childCount; i++) {
+        Array_Add(flat.Children, (AstHandle)AST_HANDLE_NONE);
+    }
+    return node;
+}
+
+// While a tree is being copied, each of its nodes keeps the handle it got in its Type field, which is null until
+// the tree is resolved. Parents and ExtraVariablesInScope always point back at nodes that are already in
+struct FlatAstBuilder {
+    FlatAst* Flat;
+    Array<Ast*> Nodes;
+};
+
+// Parents outside of the tree being copied come back as no node
+static AstHandle FlatAstBuilder_Find(const FlatAstBuilder& builder, Ast* ast) {
+    if (ast == nullptr) {
+        return AST_HANDLE_NONE;
+    }
+    return (AstHandle)(uintptr_t)ast->Type;
+}
+
+// Copies the symbol table of 'scope', whose declarations are all in already
+static void FlatAstBuilder_AddSymbols(FlatAstBuilder& builder, AstHandle node, AstScope* scope) {
+    FlatAst& flat                          = *builder.Flat;
+    const AstList<AstScopeSymbol>& symbols = scope->Scope().Symbols;
+    if (symbols.Length == 0) {
+        return;
+    }
+
+    flat.Values[node] |= flat.Symbols.Length << FLAT_AST_SYMBOLS_SHIFT;
+    Array_Add(flat.Symbols, FlatAstSymbol{ Symbol_None, (u32)symbols.Length, AST_HANDLE_NONE });
+    for (u64 i = 0; i < symbols.Length; i++) {
+        AstHandle declaration = FlatAstBuilder_Find(builder, symbols[i].Declaration);
+        Array_Add(flat.Symbols, FlatAstSymbol{ symbols[i].Name, symbols[i].Ordinal, declaration });
+    }
+}
+
+static AstHandle FlatAstBuilder_Add(FlatAstBuilder& builder, Ast* ast) {
+    if (ast == nullptr) {
+        return AST_HANDLE_NONE;
+    }
+    ASSERT(ast->Completion == AstCompletion::Incomplete && ast->Type == nullptr);
+
+    u32 childCount = 0;
+    u64 value      = 0;
+    switch (ast->Kind) {
+        case AstKind::File: {
+            childCount = 1;
+        } break;
+
+        case AstKind::Scope: {
+            childCount = (u32)(ast->Scope().ExtraVariablesInScope.Length + ast->Scope().Statements.Length);
+            value      = ast->Scope().ExtraVariablesInScope.Length;
+        } break;
+
+        case AstKind::Declaration: {
+            childCount = 3;
+            value      = ast->Declaration().Constant;
+        } break;
+
+        case AstKind::IntegerLiteral: {
+            value = ast->IntegerLiteral().Value;
+        } break;
+
+        case AstKind::FloatLiteral: {
+            std::memcpy(&value, &ast->FloatLiteral().Value, sizeof(value));
+        } break;
+
+        case AstKind::Name: {
+            value = ast->Name().Identifier.Data.Name;
+        } break;
+
+        case AstKind::Unary: {
+            childCount = 1;
+            value      = (u64)ast->Unary().Operator.Kind;
+        } break;
+
+        case AstKind::Binary: {
+            childCount = 2;
+            value      = (u64)ast->Binary().Operator.Kind;
+        } break;
+
+        case AstKind::Procedure: {
+            childCount = (u32)(2 + ast->Procedure().Arguments.Length);
+        } break;
+
+        case AstKind::TypeName: {
+            value = ast->TypeName().Name.Data.Name;
+        } break;
+
+        case AstKind::TypePointer:
+        case AstKind::TypeDeref: {
+            childCount = 1;
+        } break;
+
+        case AstKind::TypeInteger: {
+            value = ast->TypeInteger().Size | (ast->TypeInteger().Signed ? FLAT_AST_SIGNED_BIT : 0);
+        } break;
+
+        case AstKind::TypeFloat: {
+            value = ast->TypeFloat().Size;
+        } break;
+
+        case AstKind::TypeProcedure: {
+            childCount = (u32)(1 + ast->TypeProcedure().Arguments.Length);
+        } break;
+
+        default:
+            break;
+    }
+
+    FlatAst& flat  = *builder.Flat;
+    AstHandle node = FlatAst_AddNode(flat,
+                                     ast->Kind,
+                                     FlatAstBuilder_Find(builder, ast->ParentScope),
+                                     FlatAstBuilder_Find(builder, ast->ParentStatement),
+                                     childCount,
+                                     value);
+    flat.Ordinals[node] = ast->Ordinal;
+    ast->Type           = (AstType*)(uintptr_t)node;
+    Array_Add(builder.Nodes, ast);
+
+    // Children are added in source order, which is not always the order of their slots
+    switch (ast->Kind) {
+        case AstKind::File: {
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->File().Scope));
+        } break;
+
+        case AstKind::Scope: {
+            AstList<Ast*> extra = ast->Scope().ExtraVariablesInScope;
+            for (u64 i = 0; i < extra.Length; i++) {
+                FlatAst_SetChild(flat, node, (u32)i, FlatAstBuilder_Find(builder, extra[i]));
+            }
+            for (u64 i = 0; i < ast->Scope().Statements.Length; i++) {
+                FlatAst_SetChild(flat, node, (u32)(extra.Length + i), FlatAstBuilder_Add(builder, ast->Scope().Statements[i]));
+            }
+            FlatAstBuilder_AddSymbols(builder, node, ast);
+        } break;
+
+        case AstKind::Declaration: {
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->Declaration().Name));
+            FlatAst_SetChild(flat, node, 1, FlatAstBuilder_Add(builder, ast->Declaration().Type));
+            FlatAst_SetChild(flat, node, 2, FlatAstBuilder_Add(builder, ast->Declaration().Value));
+        } break;
+
+        case AstKind::Unary: {
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->Unary().Operand));
+        } break;
+
+        case AstKind::Binary: {
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->Binary().Left));
+            FlatAst_SetChild(flat, node, 1, FlatAstBuilder_Add(builder, ast->Binary().Right));
+        } break;
+
+        case AstKind::Procedure: {
+            for (u64 i = 0; i < ast->Procedure().Arguments.Length; i++) {
+                FlatAst_SetChild(flat, node, (u32)(2 + i), FlatAstBuilder_Add(builder, ast->Procedure().Arguments[i]));
+            }
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->Procedure().ReturnType));
+            FlatAst_SetChild(flat, node, 1, FlatAstBuilder_Add(builder, ast->Procedure().Body));
+        } break;
+
+        case AstKind::TypePointer: {
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->TypePointer().PointerTo));
+        } break;
+
+        case AstKind::TypeDeref: {
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->TypeDeref().DerefedType));
+        } break;
+
+        case AstKind::TypeProcedure: {
+            for (u64 i = 0; i < ast->TypeProcedure().Arguments.Length; i++) {
+                FlatAst_SetChild(flat, node, (u32)(1 + i), FlatAstBuilder_Add(builder, ast->TypeProcedure().Arguments[i]));
+            }
+            FlatAst_SetChild(flat, node, 0, FlatAstBuilder_Add(builder, ast->TypeProcedure().ReturnType));
+        } break;
+
+        default:
+            break;
+    }
+
+    return node;
+}
+
+AstHandle FlatAst_Build(FlatAst& flat, Ast* ast) {
+    FlatAstBuilder builder = {};
+    builder.Flat           = &flat;
+    builder.Nodes          = Array_Create<Ast*>();
+
+    AstHandle node = FlatAstBuilder_Add(builder, ast);
+
+    for (u64 i = 0; i < builder.Nodes.Length; i++) {
+        builder.Nodes[i]->Type = nullptr;
+    }
+    Array_Destroy(builder.Nodes);
+    return node;
+}
+
+static u32 FlatAst_HashType(const FlatAst& flat, AstHandle type) {
+    const AstHandle* children = flat.ChildCount[type] != 0 ? &flat.Children[flat.FirstChild[type]] : nullptr;
+    return TypeTable_Hash(flat.Kinds[type], flat.Values[type], children, flat.ChildCount[type] * sizeof(AstHandle));
+}
+
+static bool FlatAst_TypeEquals(
+    const FlatAst& flat, AstHandle type, AstKind kind, u64 value, const AstHandle* children, u32 childCount) {
+    if (flat.Kinds[type] != kind || flat.Values[type] != value || flat.ChildCount[type] != childCount) {
+        return false;
+    }
+    for (u32 i = 0; i < childCount; i++) {
+        if (FlatAst_GetChild(flat, type, i) != children[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void FlatAst_RehashTypes(FlatAst& flat, u64 slotCount) {
+    Array<AstHandle> slots = Array_Create<AstHandle>(slotCount, MemoryCategory::Types);
+    for (u64 i = 0; i < slotCount; i++) {
+        Array_Add(slots, (AstHandle)AST_HANDLE_NONE);
+    }
+
+    u64 mask = slotCount - 1;
+    for (u64 i = 0; i < flat.TypeSlots.Length; i++) {
+        AstHandle type = flat.TypeSlots[i];
+        if (type == AST_HANDLE_NONE) {
+            continue;
+        }
+
+        u64 index = FlatAst_HashType(flat, type) & mask;
+        while (slots[index] != AST_HANDLE_NONE) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = type;
+    }
+
+    Array_Destroy(flat.TypeSlots);
+    flat.TypeSlots = slots;
+}
+
+AstHandle FlatAst_GetType(FlatAst& flat, AstKind kind, u64 value, const AstHandle* children, u32 childCount) {
+    u32 hash = TypeTable_Hash(kind, value, children, childCount * sizeof(AstHandle));
+    u64 mask = flat.TypeSlots.Length - 1;
+
+    flat.TypeStats.Lookups++;
+
+    u64 probes = 1;
+    for (u64 index = hash & mask;; index = (index + 1) & mask, probes++) {
+        AstHandle type = flat.TypeSlots[index];
+
+        if (type == AST_HANDLE_NONE) {
+            // 'children' can point into 'Children', which adding a node might move
+            SmallArray<AstHandle, 8> parts = SmallArray_Create<AstHandle, 8>();
+            for (u32 i = 0; i < childCount; i++) {
+                SmallArray_Add(parts, children[i]);
+            }
+
+            type = FlatAst_AddNode(flat, kind, AST_HANDLE_NONE, AST_HANDLE_NONE, childCount, value);
+            for (u32 i = 0; i < childCount; i++) {
+                FlatAst_SetChild(flat, type, i, parts[i]);
+            }
+            SmallArray_Destroy(parts);
+
+            flat.Completions[type] = AstCompletion::Complete;
+            flat.Types[type]       = flat.TypeType != AST_HANDLE_NONE ? flat.TypeType : type;
+            flat.TypeSlots[index]  = type;
+
+            flat.TypeStats.DistinctTypes++;
+            if (kind == AstKind::TypeProcedure) {
+                flat.TypeStats.ProcedureSignatures++;
+            }
+            flat.TypeStats.TotalProbes += probes;
+            if (probes > flat.TypeStats.MaxProbeLength) {
+                flat.TypeStats.MaxProbeLength = probes;
+            }
+
+            // Keep the load factor at or under one half
+            if (flat.TypeStats.DistinctTypes * 2 > flat.TypeSlots.Length) {
+                FlatAst_RehashTypes(flat, flat.TypeSlots.Length * 2);
+            }
+            return type;
+        }
+
+        if (FlatAst_TypeEquals(flat, type, kind, value, children, childCount)) {
+            flat.TypeStats.TotalProbes += probes;
+            if (probes > flat.TypeStats.MaxProbeLength) {
+                flat.TypeStats.MaxProbeLength = probes;
+            }
+            return type;
+        }
+    }
+}
+
+// The same as TypeTable_GetCanonical
+static AstHandle FlatAst_GetCanonical(FlatAst& flat, AstHandle type) {
+    if (type == AST_HANDLE_NONE) {
+        return AST_HANDLE_NONE;
+    }
+
+    AstKind kind = flat.Kinds[type];
+    if (kind == AstKind::TypeName || kind == AstKind::TypeDeref) {
+        return flat.Types[type];
+    }
+
+    const AstHandle* children = flat.ChildCount[type] != 0 ? &flat.Children[flat.FirstChild[type]] : nullptr;
+    return FlatAst_GetType(flat, kind, flat.Values[type], children, flat.ChildCount[type]);
+}
+
+static void FlatAst_ResolveTypeChild(FlatAst& flat, AstHandle node, u32 index) {
+    AstHandle type = FlatAst_GetChild(flat, node, index);
+    FlatAst_Resolve(flat, type);
+    FlatAst_SetChild(flat, node, index, FlatAst_GetCanonical(flat, type));
+}
+
+// The same as AstScope_FindSymbol
+static const FlatAstSymbol* FlatAst_FindSymbol(const FlatAst& flat, AstHandle scope, Symbol name) {
+    const FlatAstSymbol* symbols = &flat.Symbols[flat.Values[scope] >> FLAT_AST_SYMBOLS_SHIFT];
+    u32 slotCount                = symbols[0].Ordinal;
+    if (slotCount == 0) {
+        return nullptr;
+    }
+
+    u64 mask = slotCount - 1;
+    for (u64 index = AstScope_GetSymbolSlot(name, mask);; index = (index + 1) & mask) {
+        const FlatAstSymbol& symbol = symbols[1 + index];
+        if (symbol.Name == name) {
+            return &symbol;
+        }
+        if (symbol.Name == Symbol_None) {
+            return nullptr;
+        }
+    }
+}
+
+// The same as Resolve_FindDeclaration: a declaration of 'name' that comes before 'node', from the inside out
+static AstHandle FindDeclaration(const FlatAst& flat, AstHandle node, Symbol name) {
+    u32 before = flat.Ordinals[node];
+    for (AstHandle scope = flat.ParentScopes[node]; scope != AST_HANDLE_NONE; scope = flat.ParentScopes[scope]) {
+        const FlatAstSymbol* symbol = FlatAst_FindSymbol(flat, scope, name);
+        if (symbol != nullptr && symbol->Ordinal < before) {
+            return symbol->Declaration;
+        }
+        before = UINT32_MAX;
+    }
+    return AST_HANDLE_NONE;
+}
+
+static bool IsBuiltinName(Symbol name) {
+    return name == Symbol_Type || name == Symbol_Void || name == Symbol_Int;
+}
+
+static bool IsNumberType(const FlatAst& flat, AstHandle type) {
+    return flat.Kinds[type] == AstKind::TypeInteger || flat.Kinds[type] == AstKind::TypeFloat;
+}
+
+// The literal 'node' stands for, the same as for Ast operators
+static AstHandle GetFoldedOperand(const FlatAst& flat, AstHandle node) {
+    while (flat.Kinds[node] == AstKind::Name) {
+        Symbol name = (Symbol)flat.Values[node];
+        if (IsBuiltinName(name)) {
+            return AST_HANDLE_NONE;
+        }
+        AstHandle declaration = FindDeclaration(flat, node, name);
+        if (declaration == AST_HANDLE_NONE || flat.Values[declaration] == 0) {
+            return AST_HANDLE_NONE;
+        }
+        node = FlatAst_GetChild(flat, declaration, 2);
+    }
+    bool literal = flat.Kinds[node] == AstKind::IntegerLiteral || flat.Kinds[node] == AstKind::FloatLiteral;
+    return node != AST_HANDLE_NONE && literal ? node : AST_HANDLE_NONE;
+}
+
+// Literals here are resolved already, as written they were checked to be an int then. Folding writes the bits of any
+// int, and there is no token left to tell the two apart
+static ConstValue GetLiteralValue(const FlatAst& flat, AstHandle literal) {
+    if (flat.Kinds[literal] == AstKind::IntegerLiteral) {
+        return ConstValue_Integer((s64)flat.Values[literal]);
+    }
+    f64 number;
+    std::memcpy(&number, &flat.Values[literal], sizeof(number));
+    return ConstValue_Float(number);
+}
+
+// The operator at 'node' becomes the literal it comes to, without children
+static void FoldInto(FlatAst& flat, AstHandle node, EvalStatus status, const ConstValue& value) {
+    if (status == EvalStatus::Overflow) {
+        Error("Constant expression overflows!");
+    } else if (status == EvalStatus::DivisionByZero) {
+        Error("Division by zero in constant expression!");
+    } else if (status != EvalStatus::Done) {
+        return;
+    }
+
+    if (value.Kind == ConstKind::Integer) {
+        flat.Kinds[node]  = AstKind::IntegerLiteral;
+        flat.Values[node] = (u64)value.Integer;
+    } else {
+        flat.Kinds[node] = AstKind::FloatLiteral;
+        std::memcpy(&flat.Values[node], &value.Float, sizeof(value.Float));
+    }
+    flat.ChildCount[node] = 0;
+}
+
+static void FlatAst_ResolveUnary(FlatAst& flat, AstHandle node) {
+    AstHandle operand   = FlatAst_GetChild(flat, node, 0);
+    TokenKind operator_ = (TokenKind)flat.Values[node];
+
+    // INT64_MIN written out, the operand is no int on its own. Not resolved yet it is as written
+    bool minimum = operator_ == TokenKind::Minus && flat.Kinds[operand] == AstKind::IntegerLiteral &&
+                   flat.Completions[operand] == AstCompletion::Incomplete && flat.Values[operand] == (u64)INT64_MAX + 1;
+    if (minimum) {
+        flat.Types[node] = flat.TypeInt;
+        FoldInto(flat, node, EvalStatus::Done, ConstValue_Integer(INT64_MIN));
+        return;
+    }
+    FlatAst_Resolve(flat, operand);
+
+    AstHandle type      = flat.Types[operand];
+    switch (operator_) {
+        case TokenKind::Plus:
+        case TokenKind::Minus: {
+            if (!IsNumberType(flat, type)) {
+                Error("Operator cannot be applied to this type!");
+            }
+            flat.Types[node] = type;
+        } break;
+
+        case TokenKind::Asterisk: {
+            if (flat.Kinds[type] != AstKind::TypePointer) {
+                Error("Unable to deref value that is not pointer!");
+            }
+            flat.Types[node] = FlatAst_GetChild(flat, type, 0);
+        } break;
+
+        case TokenKind::Caret: {
+            flat.Types[node] = FlatAst_GetType(flat, AstKind::TypePointer, 0, &type, 1);
+        } break;
+
+        default:
+            ASSERT(false);
+    }
+
+    AstHandle literal = GetFoldedOperand(flat, operand);
+    if (literal != AST_HANDLE_NONE) {
+        ConstValue value  = {};
+        EvalStatus status = Const_ApplyUnary(operator_, GetLiteralValue(flat, literal), value);
+        FoldInto(flat, node, status, value);
+    }
+}
+
+static void FlatAst_ResolveBinary(FlatAst& flat, AstHandle node) {
+    AstHandle left  = FlatAst_GetChild(flat, node, 0);
+    AstHandle right = FlatAst_GetChild(flat, node, 1);
+    FlatAst_Resolve(flat, left);
+    FlatAst_Resolve(flat, right);
+
+    if (flat.Types[left] != flat.Types[right]) {
+        Error("Types not compatible!");
+    }
+    if (!IsNumberType(flat, flat.Types[left])) {
+        Error("Operator cannot be applied to this type!");
+    }
+    TokenKind operator_ = (TokenKind)flat.Values[node];
+    Token token         = {};
+    token.Kind          = operator_;
+    bool comparison     = GetBinaryOperatorPrecedence(token) == OPERATOR_PRECEDENCE_COMPARISON;
+    flat.Types[node]    = comparison ? flat.TypeInt : flat.Types[left];
+
+    AstHandle leftLiteral  = GetFoldedOperand(flat, left);
+    AstHandle rightLiteral = GetFoldedOperand(flat, right);
+    if (leftLiteral != AST_HANDLE_NONE && rightLiteral != AST_HANDLE_NONE) {
+        ConstValue value  = {};
+        EvalStatus status = Const_ApplyBinary(
+            operator_, GetLiteralValue(flat, leftLiteral), GetLiteralValue(flat, rightLiteral), value);
+        FoldInto(flat, node, status, value);
+    }
+}
+
+void FlatAst_Resolve(FlatAst& flat, AstHandle node) {
+    if (node == AST_HANDLE_NONE) {
+        return;
+    }
+
+    if (flat.Completions[node] == AstCompletion::Complete) {
+        return;
+    } else if (flat.Completions[node] == AstCompletion::Completing) {
+        Error("Cyclic dependency found!");
+    } else { // AstCompletion::Incomplete
+        flat.Completions[node] = AstCompletion::Completing;
+    }
+
+    switch (flat.Kinds[node]) {
+        case AstKind::Declaration: {
+            FlatAst_ResolveTypeChild(flat, node, 1);
+            FlatAst_Resolve(flat, FlatAst_GetChild(flat, node, 2));
+
+            // Arguments can be given only a type, there is nothing to check it against
+            AstHandle type  = FlatAst_GetChild(flat, node, 1);
+            AstHandle value = FlatAst_GetChild(flat, node, 2);
+            if (value != AST_HANDLE_NONE && type == AST_HANDLE_NONE) {
+                FlatAst_SetChild(flat, node, 1, flat.Types[value]);
+            } else if (value != AST_HANDLE_NONE) {
+                if (type != flat.Types[value]) {
+                    Error("Types not compatible!");
+                }
+            }
+
+            flat.Types[node] = flat.TypeVoid;
+        } break;
+
+        case AstKind::File:
+        case AstKind::Scope: {
+            // Covers a scope's ExtraVariablesInScope before its statements
+            for (u32 i = 0; i < flat.ChildCount[node]; i++) {
+                FlatAst_Resolve(flat, FlatAst_GetChild(flat, node, i));
+            }
+            flat.Types[node] = flat.TypeVoid;
+        } break;
+
+        // Folded literals are complete already, so this one is as written
+        case AstKind::IntegerLiteral: {
+            if (flat.Values[node] > (u64)INT64_MAX) {
+                Error("Integer literal does not fit in an int!");
+            }
+            flat.Types[node] = flat.TypeInt;
+        } break;
+
+        case AstKind::FloatLiteral: {
+            flat.Types[node] = flat.TypeFloat;
+        } break;
+
+        case AstKind::Name:
+        case AstKind::TypeName: {
+            Symbol name = (Symbol)flat.Values[node];
+            if (name == Symbol_Type) {
+                flat.Types[node] = flat.TypeType;
+            } else if (name == Symbol_Void) {
+                flat.Types[node] = flat.TypeVoid;
+            } else if (name == Symbol_Int) {
+                flat.Types[node] = flat.TypeInt;
+            } else {
+                AstHandle declaration = FindDeclaration(flat, node, name);
+                if (declaration != AST_HANDLE_NONE) {
+                    FlatAst_Resolve(flat, declaration);
+                    flat.Types[node] = FlatAst_GetChild(flat, declaration, 1);
+                }
+                if (declaration == AST_HANDLE_NONE || flat.Types[node] == AST_HANDLE_NONE) {
+                    Error("Could not find name!");
+                }
+            }
+        } break;
+
+        case AstKind::Unary: {
+            FlatAst_ResolveUnary(flat, node);
+        } break;
+
+        case AstKind::Binary: {
+            FlatAst_ResolveBinary(flat, node);
+        } break;
+
+        case AstKind::Procedure: {
+            u32 argumentCount = flat.ChildCount[node] - 2;
+            for (u32 i = 0; i < argumentCount; i++) {
+                FlatAst_Resolve(flat, FlatAst_GetChild(flat, node, 2 + i));
+            }
+            FlatAst_ResolveTypeChild(flat, node, 0);
+            FlatAst_Resolve(flat, FlatAst_GetChild(flat, node, 1));
+
+            SmallArray<AstHandle, 8> parts = SmallArray_Create<AstHandle, 8>();
+            SmallArray_Add(parts, FlatAst_GetChild(flat, node, 0));
+            for (u32 i = 0; i < argumentCount; i++) {
+                SmallArray_Add(parts, FlatAst_GetChild(flat, FlatAst_GetChild(flat, node, 2 + i), 1));
+            }
+            AstHandle type = FlatAst_GetType(flat, AstKind::TypeProcedure, 0, parts.Data(), (u32)parts.Length);
+            SmallArray_Destroy(parts);
+            flat.Types[node] = type;
+        } break;
+
+        case AstKind::TypePointer: {
+            FlatAst_ResolveTypeChild(flat, node, 0);
+            flat.Types[node] = flat.TypeType;
+        } break;
+
+        case AstKind::TypeDeref: {
+            FlatAst_ResolveTypeChild(flat, node, 0);
+            AstHandle derefed = FlatAst_GetChild(flat, node, 0);
+            if (flat.Kinds[derefed] != AstKind::TypePointer) {
+                Error("Unable to deref type that is not pointer!");
+            }
+            flat.Types[node] = derefed;
+        } break;
+
+        case AstKind::TypeProcedure: {
+            for (u32 i = 1; i < flat.ChildCount[node]; i++) {
+                FlatAst_ResolveTypeChild(flat, node, i);
+            }
+            FlatAst_ResolveTypeChild(flat, node, 0);
+            flat.Types[node] = flat.TypeType;
+        } break;
+
+        case AstKind::TypeInteger:
+        case AstKind::TypeFloat:
+        case AstKind::TypeVoid:
+        case AstKind::TypeType: {
+            flat.Types[node] = flat.TypeType;
+        } break;
+
+        case AstKind::_Statement_Begin:
+        case AstKind::_Statement_End:
+        case AstKind::_Expression_Begin:
+        case AstKind::_Expression_End:
+        case AstKind::_Type_Begin:
+        case AstKind::_Type_End:
+            ASSERT(false);
+    }
+
+    flat.Completions[node] = AstCompletion::Complete;
+}
+
+void FlatAst_Print(const FlatAst& flat, AstHandle node, u64 indent) {
+    auto PrintIndent = [&](u64 extraIndent = 0) -> void {
+        for (u64 i = 0; i < (indent + extraIndent); i++) {
+            Print("\t");
+        }
+    };
+
+    auto PrintCategory = [&](const char* message) -> void {
+        Print("\n");
+        PrintIndent(1);
+        Print(message);
+    };
+
+    auto PrintList = [&](u32 first, u32 end) -> void {
+        for (u32 i = first; i < end; i++) {
+            if (i == first) {
+                Print("\n");
+            }
+
+            PrintIndent(2);
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, i), indent + 2);
+
+            if (i != end - 1) {
+                Print(",\n");
+            }
+        }
+    };
+
+    if (node == AST_HANDLE_NONE) {
+        Print("()");
+        return;
+    }
+
+    u64 value = flat.Values[node];
+    switch (flat.Kinds[node]) {
+        case AstKind::File: {
+            Print("(<File> Scope: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::Scope: {
+            Print("(<Scope> (");
+            PrintCategory("Statements: (");
+            PrintList((u32)value, flat.ChildCount[node]);
+            Print("))");
+        } break;
+
+        case AstKind::Declaration: {
+            Print("(<Declaration>");
+            PrintCategory("Constant: ");
+            Print("%s", value != 0 ? "true" : "false");
+            PrintCategory("Name: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            PrintCategory("Type: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 1), indent + 1);
+            PrintCategory("Value: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 2), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::IntegerLiteral: {
+            Print("(<Integer>");
+            PrintCategory("Value: ");
+            Print("%lld)", (s64)value);
+        } break;
+
+        case AstKind::FloatLiteral: {
+            f64 number;
+            std::memcpy(&number, &value, sizeof(number));
+            Print("(<Float>");
+            PrintCategory("Value: ");
+            Print("%f)", number);
+        } break;
+
+        case AstKind::Name: {
+            Print("(<Name>");
+            PrintCategory("Value: ");
+            String name = Interner_GetString(GlobalInterner, (Symbol)value);
+            Print("'%.*s')", (u32)name.Length, name.Data);
+        } break;
+
+        case AstKind::Unary: {
+            Print("(<Unary>");
+            PrintCategory("Operator: ");
+            Print("'%s'", GetTokenKindName((TokenKind)value).Data);
+            PrintCategory("Operand: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::Binary: {
+            Print("(<Binary>");
+            PrintCategory("Operator: ");
+            Print("'%s'", GetTokenKindName((TokenKind)value).Data);
+            PrintCategory("Left: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            PrintCategory("Right: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 1), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::TypeName: {
+            Print("(<Type Name>");
+            PrintCategory("Value: ");
+            String name = Interner_GetString(GlobalInterner, (Symbol)value);
+            Print("'%.*s')", (u32)name.Length, name.Data);
+        } break;
+
+        case AstKind::TypePointer: {
+            Print("(<Type Pointer>");
+            PrintCategory("Pointer To: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::TypeDeref: {
+            Print("(<Type Deref>");
+            PrintCategory("Derefed Type: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::TypeInteger: {
+            Print("(<Type Integer>");
+            PrintCategory("Size: ");
+            Print("%llu", value & ~FLAT_AST_SIGNED_BIT);
+            PrintCategory("Signed: ");
+            Print((value & FLAT_AST_SIGNED_BIT) != 0 ? "true)" : "false)");
+        } break;
+
+        case AstKind::TypeFloat: {
+            Print("(<Type Float>");
+            PrintCategory("Size: ");
+            Print("%llu)", value);
+        } break;
+
+        case AstKind::TypeVoid: {
+            Print("(<Type Void>)");
+        } break;
+
+        case AstKind::TypeType: {
+            Print("(<Type Type>)");
+        } break;
+
+        case AstKind::TypeProcedure: {
+            Print("(<Type Procedure>");
+            PrintCategory("Arguments: (");
+            PrintList(1, flat.ChildCount[node]);
+            Print(")");
+            PrintCategory("ReturnType: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::Procedure: {
+            Print("(<Procedure>");
+            PrintCategory("Arguments: (");
+            PrintList(2, flat.ChildCount[node]);
+            Print(")");
+            PrintCategory("ReturnType: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 0), indent + 1);
+            PrintCategory("Body: ");
+            FlatAst_Print(flat, FlatAst_GetChild(flat, node, 1), indent + 1);
+            Print(")");
+        } break;
+
+        case AstKind::_Statement_Begin:
+        case AstKind::_Statement_End:
+        case AstKind::_Expression_Begin:
+        case AstKind::_Expression_End:
+        case AstKind::_Type_Begin:
+        case AstKind::_Type_End:
+            ASSERT(false);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Array.hpp"
+#include "Ast.hpp"
+#include "TypeTable.hpp"
+
+// Index of a node in a FlatAst, 0 is no node
+using AstHandle = u32;
+
+#define AST_HANDLE_NONE 0
+
+// A slot of a scope's symbol table, the same as AstScopeSymbol
+struct FlatAstSymbol {
+    Symbol Name;
+    u32 Ordinal;
+    AstHandle Declaration;
+};
+
+// The same tree as Ast, stored as one array per field and addressed by handles instead of pointers.
+// Nodes are numbered in the order a depth first walk visits them, so walking the tree mostly moves forward through memory.
+//
+// Each node's children are one contiguous range of 'Children':
+//   File           Scope
+//   Scope          ExtraVariablesInScope..., Statements...
+//   Declaration    Name, Type, Value
+//   Unary          Operand
+//   Binary         Left, Right
+//   Procedure      ReturnType, Body, Arguments...
+//   TypePointer    PointerTo
+//   TypeDeref      DerefedType
+//   TypeProcedure  ReturnType, Arguments...
+//
+// And 'Values' holds what is not a child:
+//   Scope                 How many of the children are ExtraVariablesInScope, and where its table in 'Symbols' starts in
+//                         the top 32 bits
+//   Declaration           Constant
+//   IntegerLiteral        Value
+//   FloatLiteral          Value, as its bits
+//   Name, TypeName        Symbol
+//   Unary, Binary         Operator TokenKind
+//   TypeInteger           Size, with Signed in the top bit
+//   TypeFloat             Size
+struct FlatAst {
+    Array<AstKind> Kinds;
+    Array<AstCompletion> Completions;
+    Array<AstHandle> ParentScopes;
+    Array<AstHandle> ParentStatements;
+    Array<u32> Ordinals;
+    Array<AstHandle> Types;
+    Array<u32> FirstChild;
+    Array<u32> ChildCount;
+    Array<u64> Values;
+
+    Array<AstHandle> Children;
+
+    // The symbol tables of all scopes, each the same as the one its Ast scope has. A table starts with an entry that
+    // holds how many slots follow in its Ordinal, the one at 0 has none and is where scopes without a declaration point
+    Array<FlatAstSymbol> Symbols;
+
+    // Canonical types, like TypeTable but by handle. Open addressed, AST_HANDLE_NONE for an empty slot
+    Array<AstHandle> TypeSlots;
+    TypeTableStats TypeStats;
+
+    // Made by FlatAst_Create, before any other node
+    AstHandle TypeType;
+    AstHandle TypeVoid;
+    AstHandle TypeInt;
+    AstHandle TypeFloat;
+};
+
+#define FLAT_AST_SIGNED_BIT   (1ULL << 63)
+#define FLAT_AST_SYMBOLS_SHIFT 32
+
+FlatAst FlatAst_Create();
+void FlatAst_Destroy(FlatAst& flat);
+
+// Empty again but for the built in types, the arrays keep their capacity
+void FlatAst_Reset(FlatAst& flat);
+
+// Its children start out as no node
+AstHandle FlatAst_AddNode(
+    FlatAst& flat, AstKind kind, AstHandle parentScope, AstHandle parentStatement, u32 childCount, u64 value);
+
+inline AstHandle FlatAst_GetChild(const FlatAst& flat, AstHandle node, u32 index) {
+    ASSERT(index < flat.ChildCount[node]);
+    return flat.Children[flat.FirstChild[node] + index];
+}
+
+inline void FlatAst_SetChild(FlatAst& flat, AstHandle node, u32 index, AstHandle child) {
+    ASSERT(index < flat.ChildCount[node]);
+    flat.Children[flat.FirstChild[node] + index] = child;
+}
+
+// The canonical type with this structure, its children have to be canonical already
+AstHandle FlatAst_GetType(FlatAst& flat, AstKind kind, u64 value, const AstHandle* children, u32 childCount);
+
+// Copies the tree under 'ast' in, it has to be unresolved
+AstHandle FlatAst_Build(FlatAst& flat, Ast* ast);
+
+// The same as ResolveAst and Ast_Print, so the two layouts can be compared on the same input
+void FlatAst_Resolve(FlatAst& flat, AstHandle node);
+void FlatAst_Print(const FlatAst& flat, AstHandle node, u64 indent = 0);
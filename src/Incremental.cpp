@@ -0,0 +1,553 @@
+#include "Incremental.hpp"
+#include "Resolver.hpp"
+
+#include <chrono>
+#include <cstring>
+
+#define QUERY_INITIAL_RECORDS 64
+
+// The same mixing step as Interner_Hash, keeping all 64 bits. A big workspace has too many statements for 32
+static u64 Fingerprint_Mix(u64 hash, u64 value) {
+    u64 a = hash ^ value ^ 0xA0761D6478BD642Full;
+    u64 b = 0xE7037ED1A0B428DBull;
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)a * b;
+    return (u64)product ^ (u64)(product >> 64);
+#else
+    u64 product = a * b;
+    return product ^ (product >> 32) ^ ((a >> 32) * (b >> 32));
+#endif
+}
+
+// Hashes four words at a time in four lanes that do not wait on each other, the whole source goes through here on every
+// revision
+static u64 Fingerprint_Bytes(const u8* data, u64 length) {
+    u64 lanes[4] = { 1, 2, 3, 4 };
+    u64 i        = 0;
+    for (; i + 32 <= length; i += 32) {
+        for (u64 lane = 0; lane < 4; lane++) {
+            u64 word;
+            std::memcpy(&word, data + i + lane * 8, sizeof(word));
+            lanes[lane] = Fingerprint_Mix(lanes[lane], word);
+        }
+    }
+    for (; i < length; i += 8) {
+        u64 word = 0;
+        std::memcpy(&word, data + i, length - i < 8 ? length - i : 8);
+        lanes[0] = Fingerprint_Mix(lanes[0], word);
+    }
+
+    u64 hash = Fingerprint_Mix(length, lanes[0]);
+    for (u64 lane = 1; lane < 4; lane++) {
+        hash = Fingerprint_Mix(hash, lanes[lane]);
+    }
+    return hash;
+}
+
+// The content of a statement that is not a declaration: kinds, names, literals and operators, and enough about which
+// children are there that two different trees do not give the same sequence
+struct FingerprintPass : AstVisitor<FingerprintPass> {
+    u64 Hash = 0;
+
+    void Add(u64 value) {
+        this->Hash = Fingerprint_Mix(this->Hash, value);
+    }
+
+    void EnterNode(Ast* node) {
+        this->Add((u64)node->Kind);
+        switch (node->Kind) {
+            case AstKind::Scope: {
+                this->Add(node->Scope().Statements.Length);
+            } break;
+
+            case AstKind::Declaration: {
+                AstDeclarationData& declaration = node->Declaration();
+                this->Add((u64)declaration.Constant | (u64)(declaration.Type != nullptr) << 1 |
+                          (u64)(declaration.Value != nullptr) << 2);
+            } break;
+
+            case AstKind::IntegerLiteral: {
+                this->Add(node->IntegerLiteral().Value);
+            } break;
+
+            case AstKind::FloatLiteral: {
+                u64 bits;
+                std::memcpy(&bits, &node->FloatLiteral().Value, sizeof(bits));
+                this->Add(bits);
+            } break;
+
+            case AstKind::Name: {
+                this->Add(node->Name().Identifier.Data.Name);
+            } break;
+
+            case AstKind::TypeName: {
+                this->Add(node->TypeName().Name.Data.Name);
+            } break;
+
+            case AstKind::Unary: {
+                this->Add((u64)node->Unary().Operator.Kind);
+            } break;
+
+            case AstKind::Binary: {
+                this->Add((u64)node->Binary().Operator.Kind);
+            } break;
+
+            case AstKind::Procedure: {
+                AstProcedureData& procedure = node->Procedure();
+                this->Add(procedure.Arguments.Length << 2 | (u64)(procedure.ReturnType != nullptr) << 1 |
+                          (u64)(procedure.Body != nullptr));
+            } break;
+
+            case AstKind::TypeInteger: {
+                this->Add(node->TypeInteger().Size << 1 | (u64)node->TypeInteger().Signed);
+            } break;
+
+            case AstKind::TypeFloat: {
+                this->Add(node->TypeFloat().Size);
+            } break;
+
+            case AstKind::TypeProcedure: {
+                AstTypeProcedureData& type = node->TypeProcedure();
+                this->Add(type.Arguments.Length << 1 | (u64)(type.ReturnType != nullptr));
+            } break;
+
+            default:
+                break;
+        }
+    }
+};
+
+// The top level statement 'name' finds from the statement at 'index', or QUERY_NONE when the resolver would find
+// something else or nothing
+static u32 Query_FindTopLevel(AstScope* topLevel, Symbol name, bool ordered, u32 index) {
+    const AstScopeSymbol* symbol = AstScope_FindSymbol(topLevel, name);
+    if (symbol == nullptr || symbol->Ordinal == 0 || (ordered && symbol->Ordinal > index)) {
+        return QUERY_NONE;
+    }
+    return symbol->Ordinal - 1;
+}
+
+// The top level names a statement that is being rechecked looks up, found the way Resolve_FindDeclaration does.
+// Names of declarations inside it are not top level dependencies, anything found outside the top level scope or not
+// at all makes it volatile
+struct ReferencesPass : AstVisitor<ReferencesPass> {
+    AstScope* TopLevel;
+    Array<QueryDependency>* Dependencies;
+    u64 FirstDependency;
+    bool Volatile;
+    Ast* DeclaredName; // Is not looked up
+
+    ReferencesPass(AstScope* topLevel, Array<QueryDependency>& dependencies)
+        : TopLevel(topLevel)
+        , Dependencies(&dependencies)
+        , FirstDependency(dependencies.Length)
+        , Volatile(false)
+        , DeclaredName(nullptr) {}
+
+    void EnterDeclaration(AstDeclaration* node) {
+        this->DeclaredName = node->Declaration().Name;
+    }
+
+    void EnterName(AstName* node) {
+        if (node != this->DeclaredName) {
+            this->Reference(node, node->Name().Identifier.Data.Name);
+        }
+    }
+
+    void EnterTypeName(AstTypeName* node) {
+        this->Reference(node, node->TypeName().Name.Data.Name);
+    }
+
+    void Reference(Ast* node, Symbol name) {
+        if (Resolve_IsBuiltinName(name)) {
+            return;
+        }
+
+        u32 before     = node->Ordinal;
+        bool passedTop = false;
+        for (AstScope* scope = node->ParentScope; scope != nullptr; scope = scope->ParentScope) {
+            const AstScopeSymbol* symbol = AstScope_FindSymbol(scope, name);
+            if (symbol != nullptr && symbol->Ordinal < before) {
+                if (scope == this->TopLevel && symbol->Ordinal != 0) {
+                    this->Add(name, node->ParentScope == this->TopLevel, symbol->Ordinal - 1);
+                } else if (scope == this->TopLevel || passedTop) {
+                    this->Volatile = true;
+                }
+                return;
+            }
+            passedTop = passedTop || scope == this->TopLevel;
+            before    = UINT32_MAX;
+        }
+        this->Volatile = true;
+    }
+
+    // Most statements look up a few names many times
+    void Add(Symbol name, bool ordered, u32 statement) {
+        Array<QueryDependency>& dependencies = *this->Dependencies;
+        for (u64 i = this->FirstDependency; i < dependencies.Length; i++) {
+            if (dependencies[i].Name == name && dependencies[i].Ordered == ordered) {
+                return;
+            }
+        }
+        QueryDependency dependency = {};
+        dependency.Name            = name;
+        dependency.Ordered         = ordered;
+        dependency.Statement       = statement;
+        Array_Add(dependencies, dependency);
+    }
+};
+
+static QuerySignature Query_GetSignature(AstStatement* statement) {
+    QuerySignature signature = {};
+    signature.LiteralKind    = AstKind::File;
+    if (!Ast_IsDeclaration(statement)) {
+        return signature;
+    }
+
+    AstDeclarationData& declaration = statement->Declaration();
+    signature.Type                  = declaration.Type;
+    Ast* literal                    = declaration.Constant ? Resolve_GetFoldedOperand(declaration.Value) : nullptr;
+    if (Ast_IsIntegerLiteral(literal)) {
+        signature.LiteralKind = AstKind::IntegerLiteral;
+        signature.LiteralBits = literal->IntegerLiteral().Value;
+    } else if (Ast_IsFloatLiteral(literal)) {
+        signature.LiteralKind = AstKind::FloatLiteral;
+        std::memcpy(&signature.LiteralBits, &literal->FloatLiteral().Value, sizeof(signature.LiteralBits));
+    }
+    return signature;
+}
+
+static bool QuerySignature_Equal(const QuerySignature& a, const QuerySignature& b) {
+    return a.Type == b.Type && a.LiteralKind == b.LiteralKind && a.LiteralBits == b.LiteralBits;
+}
+
+static QueryRecord* QueryTable_AllocateRecords(u64 recordCount) {
+    return (QueryRecord*)Memory_AllocateZeroed(MemoryCategory::Queries, recordCount * sizeof(QueryRecord));
+}
+
+static QueryTable QueryTable_Create() {
+    QueryTable table   = {};
+    table.Records      = QueryTable_AllocateRecords(QUERY_INITIAL_RECORDS);
+    table.RecordCount  = QUERY_INITIAL_RECORDS;
+    table.Dependencies = Array_Create<QueryDependency>(0, MemoryCategory::Queries);
+    return table;
+}
+
+static void QueryTable_Destroy(QueryTable& table) {
+    Dealloc(Queries, table.Records, table.RecordCount * sizeof(QueryRecord));
+    Array_Destroy(table.Dependencies);
+    table = {};
+}
+
+// Empties the table and makes room for the answers of 'statementCount' statements, keeping the load at or under one half
+static void QueryTable_Clear(QueryTable& table, u64 statementCount) {
+    u64 recordCount = table.RecordCount;
+    while (recordCount < statementCount * 2) {
+        recordCount *= 2;
+    }
+    if (recordCount != table.RecordCount) {
+        Dealloc(Queries, table.Records, table.RecordCount * sizeof(QueryRecord));
+        table.Records     = QueryTable_AllocateRecords(recordCount);
+        table.RecordCount = recordCount;
+    } else {
+        std::memset(table.Records, 0, table.RecordCount * sizeof(QueryRecord));
+    }
+    Array_Clear(table.Dependencies);
+}
+
+static void QueryTable_Add(QueryTable& table, const QueryRecord& record) {
+    u64 mask  = table.RecordCount - 1;
+    u64 index = record.Fingerprint & mask;
+    while (table.Records[index].Fingerprint != 0) {
+        index = (index + 1) & mask;
+    }
+    table.Records[index] = record;
+}
+
+// An answer for 'fingerprint' that no other statement has taken yet, or QUERY_NONE
+static u32 QueryTable_Take(QueryTable& table, u64 fingerprint) {
+    u64 mask = table.RecordCount - 1;
+    for (u64 index = fingerprint & mask; table.Records[index].Fingerprint != 0; index = (index + 1) & mask) {
+        QueryRecord& record = table.Records[index];
+        if (record.Fingerprint == fingerprint && !record.Taken) {
+            record.Taken = true;
+            return (u32)index;
+        }
+    }
+    return QUERY_NONE;
+}
+
+IncrementalResolver IncrementalResolver_Create() {
+    IncrementalResolver incremental = {};
+    incremental.Previous            = QueryTable_Create();
+    incremental.Current             = QueryTable_Create();
+    incremental.Statements          = Array_Create<QueryStatement>(0, MemoryCategory::Queries);
+    incremental.Stack               = Array_Create<u32>(0, MemoryCategory::Queries);
+    return incremental;
+}
+
+void IncrementalResolver_Destroy(IncrementalResolver& incremental) {
+    QueryTable_Destroy(incremental.Previous);
+    QueryTable_Destroy(incremental.Current);
+    Array_Destroy(incremental.Statements);
+    Array_Destroy(incremental.Stack);
+    incremental = {};
+}
+
+void IncrementalResolver_Reset(IncrementalResolver& incremental) {
+    QueryTable_Clear(incremental.Previous, 0);
+    QueryTable_Clear(incremental.Current, 0);
+    Array_Clear(incremental.Statements);
+    Array_Clear(incremental.Stack);
+    incremental.Stats = {};
+}
+
+// Its answer cannot be reused, so what it depends on comes from its own content now
+static void Query_StartRecheck(IncrementalResolver& incremental, AstScope* topLevel, u32 index) {
+    QueryStatement& statement = incremental.Statements[index];
+    ReferencesPass references(topLevel, incremental.Current.Dependencies);
+    references.Walk(topLevel->Scope().Statements[index]);
+
+    statement.Rechecked       = true;
+    statement.Volatile        = references.Volatile;
+    statement.NextDependency  = 0;
+    statement.FirstDependency = (u32)references.FirstDependency;
+    statement.DependencyCount = (u32)(incremental.Current.Dependencies.Length - references.FirstDependency);
+    if (statement.Record == QUERY_NONE) {
+        incremental.Stats.Edited++;
+    } else {
+        incremental.Stats.Invalidated++;
+    }
+}
+
+// Takes over what the answer depends on, looked up again in this revision. Signatures are still the ones it found
+static void Query_StartReuse(IncrementalResolver& incremental, AstScope* topLevel, u32 index) {
+    QueryStatement& statement            = incremental.Statements[index];
+    const QueryRecord& record            = incremental.Previous.Records[statement.Record];
+    Array<QueryDependency>& dependencies = incremental.Current.Dependencies;
+
+    statement.NextDependency  = 0;
+    statement.FirstDependency = (u32)dependencies.Length;
+    statement.DependencyCount = record.DependencyCount;
+    for (u32 i = 0; i < record.DependencyCount; i++) {
+        QueryDependency dependency = incremental.Previous.Dependencies[record.FirstDependency + i];
+        dependency.Statement       = Query_FindTopLevel(topLevel, dependency.Name, dependency.Ordered, index);
+        Array_Add(dependencies, dependency);
+    }
+}
+
+// The next statement 'index' depends on that nobody has started on, or QUERY_NONE once there are none left
+static u32 Query_NextDependency(IncrementalResolver& incremental, u32 index) {
+    QueryStatement& statement = incremental.Statements[index];
+    while (statement.NextDependency != statement.DependencyCount) {
+        u32 target = incremental.Current.Dependencies[statement.FirstDependency + statement.NextDependency].Statement;
+        statement.NextDependency++;
+
+        // One that is being visited is on a cycle, which the resolver reports
+        if (target != QUERY_NONE && incremental.Statements[target].State == QueryState::Unknown) {
+            return target;
+        }
+    }
+    return QUERY_NONE;
+}
+
+// Whether every name the answer looked up finds the same signature now. 'cutOff' is set when one of them was rechecked
+static bool Query_Matches(IncrementalResolver& incremental, u32 index, bool& cutOff) {
+    const QueryStatement& statement = incremental.Statements[index];
+    for (u32 i = 0; i < statement.DependencyCount; i++) {
+        const QueryDependency& dependency = incremental.Current.Dependencies[statement.FirstDependency + i];
+        if (dependency.Statement == QUERY_NONE) {
+            return false;
+        }
+
+        const QueryStatement& found = incremental.Statements[dependency.Statement];
+        if (found.State != QueryState::Settled || !QuerySignature_Equal(found.Signature, dependency.Signature)) {
+            return false;
+        }
+        cutOff = cutOff || found.Rechecked;
+    }
+    return true;
+}
+
+// Moves the resolved statement of the answer into the new tree, in place of the one that was parsed. What is inside it
+// still points at the scope it was parsed in, which only differs from this one in what it does not depend on
+static void Query_Reuse(IncrementalResolver& incremental, AstScope* topLevel, u32 index) {
+    QueryStatement& statement = incremental.Statements[index];
+    const QueryRecord& record = incremental.Previous.Records[statement.Record];
+    AstStatement* parsed      = topLevel->Scope().Statements[index];
+    AstStatement* resolved    = record.Statement;
+
+    resolved->Ordinal                   = index + 1;
+    resolved->ParentFile                = parsed->ParentFile;
+    resolved->ParentScope               = topLevel;
+    resolved->ParentStatement           = parsed->ParentStatement;
+    topLevel->Scope().Statements[index] = resolved;
+    if (Ast_IsDeclaration(parsed) && Ast_IsName(parsed->Declaration().Name)) {
+        AstScopeSymbol* symbol =
+            (AstScopeSymbol*)AstScope_FindSymbol(topLevel, parsed->Declaration().Name->Name().Identifier.Data.Name);
+        if (symbol != nullptr && symbol->Declaration == parsed) {
+            symbol->Declaration = resolved;
+        }
+    }
+
+    statement.Signature = record.Signature;
+    statement.State     = QueryState::Settled;
+}
+
+static bool Query_Recheck(IncrementalResolver& incremental, AstScope* topLevel, u32 index) {
+    AstStatement* node = topLevel->Scope().Statements[index];
+    if (!ResolveAst(node)) {
+        return false;
+    }
+
+    // What it depends on is complete even when it was on a cycle of answers, the resolver went through it
+    QueryStatement& statement = incremental.Statements[index];
+    for (u32 i = 0; i < statement.DependencyCount; i++) {
+        QueryDependency& dependency = incremental.Current.Dependencies[statement.FirstDependency + i];
+        dependency.Signature        = Query_GetSignature(topLevel->Scope().Statements[dependency.Statement]);
+    }
+    statement.Signature = Query_GetSignature(node);
+    statement.State     = QueryState::Settled;
+    return true;
+}
+
+// Settles 'first' and everything it depends on, each after what it depends on
+static bool Query_Settle(IncrementalResolver& incremental, AstScope* topLevel, u32 first) {
+    Array<u32>& stack = incremental.Stack;
+    Array_Add(stack, first);
+    while (stack.Length != 0) {
+        u32 index                 = stack[stack.Length - 1];
+        QueryStatement& statement = incremental.Statements[index];
+        if (statement.State == QueryState::Settled) {
+            stack.Length--;
+            continue;
+        }
+
+        if (statement.State == QueryState::Unknown) {
+            statement.State = QueryState::Visiting;
+            if (statement.Record == QUERY_NONE) {
+                Query_StartRecheck(incremental, topLevel, index);
+            } else {
+                Query_StartReuse(incremental, topLevel, index);
+            }
+        }
+
+        u32 dependency = Query_NextDependency(incremental, index);
+        if (dependency != QUERY_NONE) {
+            Array_Add(stack, dependency);
+            continue;
+        }
+
+        bool cutOff = false;
+        if (!statement.Rechecked && Query_Matches(incremental, index, cutOff)) {
+            Query_Reuse(incremental, topLevel, index);
+            incremental.Stats.Reused++;
+            incremental.Stats.CutOff += cutOff;
+            stack.Length--;
+        } else if (!statement.Rechecked) {
+            // Its own content can depend on more than the answer did, when a name finds a different statement now
+            Query_StartRecheck(incremental, topLevel, index);
+        } else {
+            if (!Query_Recheck(incremental, topLevel, index)) {
+                Array_Clear(stack);
+                return false;
+            }
+            stack.Length--;
+        }
+    }
+    return true;
+}
+
+bool IncrementalResolver_Resolve(IncrementalResolver& incremental, Ast* ast, const String& source) {
+    AstScope* topLevel = Resolve_FindTopLevelScope(ast);
+    if (topLevel == nullptr) {
+        IncrementalResolver_Reset(incremental);
+        return ResolveAst(ast);
+    }
+
+    IncrementalStats& stats      = incremental.Stats;
+    AstList<AstStatement*> nodes = topLevel->Scope().Statements;
+    stats.Revisions++;
+    stats.Statements  = nodes.Length;
+    stats.Reused      = 0;
+    stats.Edited      = 0;
+    stats.Invalidated = 0;
+    stats.CutOff      = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    QueryTable_Clear(incremental.Current, nodes.Length);
+    Array_Clear(incremental.Statements);
+    Array_Reserve(incremental.Statements, nodes.Length);
+    incremental.Statements.Length = nodes.Length;
+
+    // A declaration's text goes from its name to the next declaration's name, which is much cheaper to hash than its
+    // tree and the same text always parses to the same tree. Whatever else is in between goes with the declaration
+    // before it, so an edit there only rechecks more than it has to. Other statements have no position of their own
+    u64 end = source.Length;
+    for (u64 i = nodes.Length; i-- != 0;) {
+        u64 fingerprint = 0;
+        if (Ast_IsDeclaration(nodes[i]) && Ast_IsName(nodes[i]->Declaration().Name)) {
+            u64 begin   = nodes[i]->Declaration().Name->Name().Identifier.Position;
+            fingerprint = Fingerprint_Bytes(source.Data + begin, end - begin);
+            end         = begin;
+        } else {
+            FingerprintPass pass;
+            pass.Walk(nodes[i]);
+            fingerprint = pass.Hash;
+        }
+
+        QueryStatement& statement = incremental.Statements[i];
+        statement                 = {};
+        statement.Fingerprint     = fingerprint != 0 ? fingerprint : 1;
+        statement.State           = QueryState::Unknown;
+    }
+    // In source order, so of two statements with the same content the first one takes the first answer
+    for (u64 i = 0; i < nodes.Length; i++) {
+        incremental.Statements[i].Record = QueryTable_Take(incremental.Previous, incremental.Statements[i].Fingerprint);
+    }
+    auto resolveStart        = std::chrono::steady_clock::now();
+    stats.FingerprintSeconds = std::chrono::duration<f64>(resolveStart - start).count();
+
+    for (u32 i = 0; i < nodes.Length; i++) {
+        if (incremental.Statements[i].State == QueryState::Unknown && !Query_Settle(incremental, topLevel, i)) {
+            IncrementalResolver_Reset(incremental);
+            return false;
+        }
+    }
+
+    // Every top level statement is complete, what is left is the nodes around them
+    if (!ResolveAst(ast)) {
+        IncrementalResolver_Reset(incremental);
+        return false;
+    }
+    stats.ResolveSeconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - resolveStart).count();
+
+    for (u64 i = 0; i < nodes.Length; i++) {
+        const QueryStatement& statement = incremental.Statements[i];
+        if (statement.Volatile) {
+            continue;
+        }
+
+        QueryRecord record     = {};
+        record.Fingerprint     = statement.Fingerprint;
+        record.Statement       = nodes[i];
+        record.Signature       = statement.Signature;
+        record.FirstDependency = statement.FirstDependency;
+        record.DependencyCount = statement.DependencyCount;
+        QueryTable_Add(incremental.Current, record);
+    }
+    std::swap(incremental.Previous, incremental.Current);
+    return true;
+}
+
+void IncrementalStats_Print(const IncrementalStats& stats) {
+    PrintError("\nIncremental Stats:\n");
+    PrintError("Revision: %llu\n", stats.Revisions);
+    PrintError("Top Level Statements: %llu\n", stats.Statements);
+    PrintError("Reused: %llu\n", stats.Reused);
+    PrintError("Rechecked After Edits: %llu\n", stats.Edited);
+    PrintError("Rechecked After Signature Changes: %llu\n", stats.Invalidated);
+    PrintError("Reused Past A Recheck: %llu\n", stats.CutOff);
+    PrintError("Fingerprinting: %.3f ms\n", stats.FingerprintSeconds * 1e3);
+    PrintError("Resolving: %.3f ms\n", stats.ResolveSeconds * 1e3);
+}
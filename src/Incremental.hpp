@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Array.hpp"
+#include "Ast.hpp"
+
+// Resolves one revision of a file after another, only redoing the top level statements an edit can have changed.
+// Every top level statement is a query whose answer is its resolved subtree. Answers are kept by a fingerprint of the
+// statement's text, together with the top level names it looked up and what it found there. A statement of the new
+// revision whose content was seen before takes the old answer as long as every name it looked up still finds the same
+// signature; otherwise it is resolved again. So an edit inside a procedure body rechecks that procedure, and the ones
+// that call it only when its type changed.
+//
+// The new revision is parsed as a whole. Reused statements are moved into it from the old tree, so the trees of every
+// revision have to stay alive, as do the names and types they point at
+
+// What the statements that refer to a declaration can see of it: its type, and the literal a constant folded to.
+// Everything that refers to two declarations with the same signature resolves the same way
+struct QuerySignature {
+    AstType* Type;
+    AstKind LiteralKind; // IntegerLiteral or FloatLiteral for a constant that folded, File otherwise
+    u64 LiteralBits;
+};
+
+// A top level name a statement looked up and the signature it found
+struct QueryDependency {
+    Symbol Name;
+    bool Ordered;  // Looked up from the statement itself rather than a scope inside it, so only earlier ones count
+    u32 Statement; // The index of what it found, in the revision that looked it up
+    QuerySignature Signature;
+};
+
+// The answer for one top level statement of a revision
+struct QueryRecord {
+    u64 Fingerprint;         // Of its content, 0 for an empty slot
+    AstStatement* Statement; // Resolved
+    QuerySignature Signature;
+    u32 FirstDependency; // Into the Dependencies of the table it is in
+    u32 DependencyCount;
+    bool Taken; // By a statement of the next revision, two statements can have the same content
+};
+
+struct QueryTable {
+    QueryRecord* Records; // Open addressed by fingerprint
+    u64 RecordCount;      // Always a power of 2
+    Array<QueryDependency> Dependencies;
+};
+
+enum struct QueryState : u8 {
+    Unknown,
+    Visiting, // Waiting for what it depends on
+    Settled,  // Resolved, by reusing an answer or again
+};
+
+// A top level statement of the revision being resolved
+struct QueryStatement {
+    u64 Fingerprint;
+    u32 Record;         // The answer with the same fingerprint, or QUERY_NONE
+    u32 NextDependency; // How many of its dependencies have been looked at
+    QueryState State;
+    bool Rechecked;      // Its answer could not be reused, what it depends on was found again by walking it
+    bool Volatile;       // Looks up something that is not a top level statement, so its answer is not kept
+    u32 FirstDependency; // Into the Dependencies of the current table, once it is being visited
+    u32 DependencyCount;
+    QuerySignature Signature;
+};
+
+#define QUERY_NONE UINT32_MAX
+
+struct IncrementalStats {
+    u64 Revisions;
+    u64 Statements;  // Top level statements of the last revision
+    u64 Reused;      // Of those, the ones whose answer was taken from the revision before
+    u64 Edited;      // Rechecked because their content had no answer
+    u64 Invalidated; // Rechecked because a name they look up found a different signature
+    u64 CutOff;      // Reused even though something they depend on was rechecked
+    f64 FingerprintSeconds;
+    f64 ResolveSeconds;
+};
+
+struct IncrementalResolver {
+    QueryTable Previous; // The answers of the last revision
+    QueryTable Current;  // Filled in while resolving this one, then it is swapped with Previous
+    Array<QueryStatement> Statements;
+    Array<u32> Stack;
+    IncrementalStats Stats;
+};
+
+IncrementalResolver IncrementalResolver_Create();
+void IncrementalResolver_Destroy(IncrementalResolver& incremental);
+
+// Forgets every answer, for when the next tree is not a revision of the last one
+void IncrementalResolver_Reset(IncrementalResolver& incremental);
+
+// Resolves 'ast', parsed from 'source', like ResolveAst, reusing what it can of the revision resolved before. Statements
+// of the last revision that are reused are moved into 'ast', so that tree is not whole afterwards
+bool IncrementalResolver_Resolve(IncrementalResolver& incremental, Ast* ast, const String& source);
+
+void IncrementalStats_Print(const IncrementalStats& stats);
@@ -0,0 +1,190 @@
+#include "Interner.hpp"
+
+#define INTERNER_CHUNK_SIZE    (64 * 1024)
+#define INTERNER_INITIAL_SLOTS 1024
+
+Interner GlobalInterner = Interner_Create();
+
+static u64 ReadU64(const u8* data) {
+    u64 value;
+    std::memcpy(&value, data, sizeof(u64));
+    return value;
+}
+
+static u64 Mix(u64 a, u64 b) {
+    // 64x64 -> 128 bit multiply folded back down, the same mixing step wyhash uses
+#if defined(__SIZEOF_INT128__)
+    __uint128_t product = (__uint128_t)a * b;
+    return (u64)product ^ (u64)(product >> 64);
+#else
+    u64 product = a * b;
+    return product ^ (product >> 32) ^ ((a >> 32) * (b >> 32));
+#endif
+}
+
+u32 Interner_Hash(const u8* data, u64 length) {
+    const u64 seed0 = 0xA0761D6478BD642Full;
+    const u64 seed1 = 0xE7037ED1A0B428DBull;
+
+    u64 hash = seed0 ^ length;
+    while (length >= 8) {
+        hash = Mix(hash ^ ReadU64(data), seed1);
+        data += 8;
+        length -= 8;
+    }
+
+    if (length > 0) {
+        u64 tail = 0;
+        std::memcpy(&tail, data, length);
+        hash = Mix(hash ^ tail, seed1);
+    }
+
+    return (u32)Mix(hash, seed0);
+}
+
+static u8* Interner_AllocateBytes(Interner& interner, u64 size) {
+    InternerChunk* chunk = interner.Chunks;
+    if (chunk == nullptr || chunk->Capacity - chunk->Used < size) {
+        if (interner.Spare != nullptr && interner.Spare->Capacity >= size) {
+            chunk          = interner.Spare;
+            interner.Spare = chunk->Next;
+        } else {
+            u64 capacity    = size > INTERNER_CHUNK_SIZE ? size : INTERNER_CHUNK_SIZE;
+            chunk           = (InternerChunk*)Alloc(Identifiers, sizeof(InternerChunk) + capacity);
+            chunk->Capacity = capacity;
+        }
+        chunk->Next     = interner.Chunks;
+        chunk->Used     = 0;
+        interner.Chunks = chunk;
+    }
+
+    u8* bytes = (u8*)(chunk + 1) + chunk->Used;
+    chunk->Used += size;
+    return bytes;
+}
+
+static InternerSlot* Interner_AllocateSlots(u64 slotCount) {
+    return (InternerSlot*)Memory_AllocateZeroed(MemoryCategory::Identifiers, slotCount * sizeof(InternerSlot));
+}
+
+static void Interner_Rehash(Interner& interner, u64 slotCount) {
+    InternerSlot* slots = Interner_AllocateSlots(slotCount);
+    u64 mask            = slotCount - 1;
+
+    for (u64 i = 0; i < interner.SlotCount; i++) {
+        InternerSlot slot = interner.Slots[i];
+        if (slot.Value == Symbol_None) {
+            continue;
+        }
+
+        u64 index = slot.Hash & mask;
+        while (slots[index].Value != Symbol_None) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+    }
+
+    Dealloc(Identifiers, interner.Slots, interner.SlotCount * sizeof(InternerSlot));
+    interner.Slots     = slots;
+    interner.SlotCount = slotCount;
+}
+
+static void Interner_AddPredefined(Interner& interner) {
+    Array_Add(interner.Strings, String()); // Symbol_None
+#define PREDEFINED_SYMBOL(name, str) Interner_Intern(interner, str);
+    PREDEFINED_SYMBOLS
+#undef PREDEFINED_SYMBOL
+}
+
+Interner Interner_Create() {
+    Interner interner  = {};
+    interner.Slots     = Interner_AllocateSlots(INTERNER_INITIAL_SLOTS);
+    interner.SlotCount = INTERNER_INITIAL_SLOTS;
+    interner.Strings   = Array_Create<String>(0, MemoryCategory::Identifiers);
+    interner.Chunks    = nullptr;
+    interner.Spare     = nullptr;
+
+    Interner_AddPredefined(interner);
+    return interner;
+}
+
+static void Interner_FreeChunks(InternerChunk* chunk) {
+    while (chunk != nullptr) {
+        InternerChunk* next = chunk->Next;
+        Dealloc(Identifiers, chunk, sizeof(InternerChunk) + chunk->Capacity);
+        chunk = next;
+    }
+}
+
+void Interner_Destroy(Interner& interner) {
+    Dealloc(Identifiers, interner.Slots, interner.SlotCount * sizeof(InternerSlot));
+    Array_Destroy(interner.Strings);
+    Interner_FreeChunks(interner.Chunks);
+    Interner_FreeChunks(interner.Spare);
+    interner = {};
+}
+
+void Interner_Reset(Interner& interner) {
+    std::memset(interner.Slots, 0, interner.SlotCount * sizeof(InternerSlot));
+    Array_Clear(interner.Strings);
+
+    // Only the usual size is worth keeping, the bigger ones were made for a single long name
+    InternerChunk* chunk = interner.Chunks;
+    while (chunk != nullptr) {
+        InternerChunk* next = chunk->Next;
+        if (chunk->Capacity == INTERNER_CHUNK_SIZE) {
+            chunk->Next    = interner.Spare;
+            interner.Spare = chunk;
+        } else {
+            Dealloc(Identifiers, chunk, sizeof(InternerChunk) + chunk->Capacity);
+        }
+        chunk = next;
+    }
+    interner.Chunks = nullptr;
+    interner.Stats  = {};
+
+    Interner_AddPredefined(interner);
+}
+
+Symbol Interner_Intern(Interner& interner, const String& string) {
+    u32 hash = Interner_Hash(string.Data, string.Length);
+    u64 mask = interner.SlotCount - 1;
+
+    interner.Stats.Lookups++;
+
+    u64 probes = 1;
+    for (u64 index = hash & mask;; index = (index + 1) & mask, probes++) {
+        InternerSlot& slot = interner.Slots[index];
+
+        if (slot.Value == Symbol_None) {
+            String stored = { Interner_AllocateBytes(interner, string.Length), string.Length };
+            std::memcpy(stored.Data, string.Data, string.Length);
+
+            slot.Hash  = hash;
+            slot.Value = (Symbol)interner.Strings.Length;
+            Array_Add(interner.Strings, stored);
+
+            interner.Stats.UniqueSymbols++;
+            interner.Stats.BytesStored += string.Length;
+            interner.Stats.TotalProbes += probes;
+            if (probes > interner.Stats.MaxProbeLength) {
+                interner.Stats.MaxProbeLength = probes;
+            }
+
+            Symbol symbol = slot.Value;
+            // Keep the load factor at or under one half
+            if (interner.Stats.UniqueSymbols * 2 > interner.SlotCount) {
+                Interner_Rehash(interner, interner.SlotCount * 2);
+            }
+            return symbol;
+        }
+
+        if (slot.Hash == hash && interner.Strings[slot.Value] == string) {
+            interner.Stats.TotalProbes += probes;
+            if (probes > interner.Stats.MaxProbeLength) {
+                interner.Stats.MaxProbeLength = probes;
+            }
+            return slot.Value;
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "String.hpp"
+#include "Array.hpp"
+
+using Symbol = u32;
+
+// Names the compiler looks for itself, these always get the same symbols
+#define PREDEFINED_SYMBOLS          \
+    PREDEFINED_SYMBOL(Type, "type") \
+    PREDEFINED_SYMBOL(Void, "void") \
+    PREDEFINED_SYMBOL(Int, "int")
+
+enum : Symbol {
+    Symbol_None = 0,
+#define PREDEFINED_SYMBOL(name, str) Symbol_##name,
+    PREDEFINED_SYMBOLS
+#undef PREDEFINED_SYMBOL
+        Symbol_PredefinedCount,
+};
+
+struct InternerSlot {
+    u32 Hash;
+    Symbol Value; // Symbol_None for an empty slot
+};
+
+struct InternerChunk {
+    InternerChunk* Next;
+    u64 Used;
+    u64 Capacity;
+    // The string bytes follow
+};
+
+struct InternerStats {
+    u64 UniqueSymbols;
+    u64 Lookups;
+    u64 TotalProbes;
+    u64 MaxProbeLength;
+    u64 BytesStored;
+};
+
+struct Interner {
+    InternerSlot* Slots;
+    u64 SlotCount; // Always a power of 2
+    Array<String> Strings; // Indexed by symbol
+    InternerChunk* Chunks;
+    InternerChunk* Spare; // Emptied by Interner_Reset, taken before a new chunk is allocated
+    InternerStats Stats;
+};
+
+Interner Interner_Create();
+void Interner_Destroy(Interner& interner);
+
+// Back to only the predefined symbols, keeping the slots and string chunks for the next file
+void Interner_Reset(Interner& interner);
+
+Symbol Interner_Intern(Interner& interner, const String& string);
+
+inline const String& Interner_GetString(const Interner& interner, Symbol symbol) {
+    return interner.Strings[symbol];
+}
+
+u32 Interner_Hash(const u8* data, u64 length);
+
+// The interner that every Lexer puts identifiers into
+extern Interner GlobalInterner;
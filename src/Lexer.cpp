@@ -1,47 +1,136 @@
 #include "Lexer.hpp"
 
-Lexer::Lexer(const String& source) : Source(source), Position(0), Line(1), Column(1), Errors(Array_Create<String>()) {}
+LexerStorage LexerStorage_Create() {
+    LexerStorage storage     = {};
+    storage.Values           = Array_Create<TokenValue>(0, MemoryCategory::Tokens);
+    storage.Diagnostics      = DiagnosticList_Create();
+    storage.Lines.LineStarts = Array_Create<u32>(0, MemoryCategory::Source);
+    return storage;
+}
+
+void LexerStorage_Destroy(LexerStorage& storage) {
+    Array_Destroy(storage.Values);
+    DiagnosticList_Destroy(storage.Diagnostics);
+    LineTable_Destroy(storage.Lines);
+}
+
+Lexer::Lexer(const String& source, Interner& symbols, const Scanner* scan, LexerStorage* storage)
+    : Source(source)
+    , Position(0)
+    , Symbols(&symbols)
+    , Scan(scan)
+    , Lines({})
+    , LinesBuilt(false)
+    , Storage(storage)
+    , Values({})
+    , Diagnostics({}) {
+    if (source.Length > UINT32_MAX) {
+        Error("Source files over 4GB are not supported");
+    }
+
+    if (storage != nullptr) {
+        this->Values      = storage->Values;
+        this->Diagnostics = storage->Diagnostics;
+        this->Lines       = storage->Lines;
+        Array_Clear(this->Values);
+        DiagnosticList_Clear(this->Diagnostics);
+    } else {
+        this->Values           = Array_Create<TokenValue>(0, MemoryCategory::Tokens);
+        this->Diagnostics      = DiagnosticList_Create();
+        this->Lines.LineStarts = Array_Create<u32>(0, MemoryCategory::Source);
+    }
+}
+
+Lexer::~Lexer() {
+    if (this->Storage != nullptr) {
+        // Might have moved while growing
+        this->Storage->Values      = this->Values;
+        this->Storage->Diagnostics = this->Diagnostics;
+        this->Storage->Lines       = this->Lines;
+    } else {
+        Array_Destroy(this->Values);
+        DiagnosticList_Destroy(this->Diagnostics);
+        LineTable_Destroy(this->Lines);
+    }
+}
 
-Lexer::~Lexer() = default;
+void Lexer::TokenizeAll(Array<Token>& tokens) {
+    // Tokens average a few bytes each, so this is close to the final size for real code
+    Array_Reserve(tokens, tokens.Length + (this->Source.Length - this->Position) / 4 + 1);
+
+    while (true) {
+        Token token = this->NextToken();
+        Array_Add(tokens, token);
+        if (Token_IsEndOfFile(token)) {
+            break;
+        }
+    }
+}
+
+SourceLocation Lexer::GetLocation(u32 position) {
+    if (!this->LinesBuilt) {
+        LineTable_Rebuild(this->Lines, this->Source, this->Scan);
+        this->LinesBuilt = true;
+    }
+    return LineTable_GetLocation(this->Lines, position);
+}
 
 Token Lexer::NextToken() {
-#define Current ((this->Position >= this->Source.Length) ? '\0' : this->Source[this->Position])
+// The source is padded with '\0', which is both the end of file and the sentinel that stops every scan
+#define Current (this->Source[this->Position])
 
+    // Newlines never go through here, the whitespace scan takes care of them
     auto NextChar = [this]() -> u8 {
-        u8 current = Current;
-        this->Position++;
-        this->Column++;
-        if (current == '\n') {
-            this->Line++;
-            this->Column = 1;
-        }
-        return current;
+        return this->Source[this->Position++];
     };
 
     while (true) {
-        u64 startPosition = this->Position;
-        u64 startLine     = this->Line;
-        u64 startColumn   = this->Column;
+        u32 startPosition = this->Position;
+
+        u8 characterClass = CharacterClasses.Classes[Current];
+
+        if (characterClass & (u8)CharacterClass::Whitespace) {
+            this->Position += (u32)this->Scan->SkipWhitespace(&Current);
+            // A chunk of a bigger source is not followed by the sentinel, but it always ends on a newline,
+            // so this is the only place where the end can be reached without seeing '\0'
+            if (this->Position >= this->Source.Length) {
+                return Token_CreateEndOfFile((u32)this->Source.Length, 0);
+            }
+            continue;
+        }
+
+        if (characterClass & (u8)CharacterClass::IdentifierStart) {
+            u32 length = 1 + (u32)this->Scan->ScanIdentifierBody(&this->Source[this->Position + 1]);
+            this->Position += length;
+
+            // Only the first occurrence of a name gets copied, into the interner
+            Symbol name = Interner_Intern(*this->Symbols, String(&this->Source[startPosition], length));
+            return Token_CreateIdentifier(startPosition, length, name);
+        }
+
+        if (characterClass & (u8)CharacterClass::Digit) {
+            return this->LexNumber(startPosition);
+        }
 
-#define MATCH(chr, kind)                                                     \
-    case chr: {                                                              \
-        NextChar();                                                          \
-        return Token_Create##kind(startPosition, startLine, startColumn, 1); \
+#define MATCH(chr, kind)                             \
+    case chr: {                                      \
+        NextChar();                                  \
+        return Token_Create##kind(startPosition, 1); \
     } break
 
-#define MATCH2(chr, kind, chr2, kind2)                                            \
-    case chr: {                                                                   \
-        NextChar();                                                               \
-        if (Current == chr2) {                                                    \
-            NextChar();                                                           \
-            return Token_Create##kind2(startPosition, startLine, startColumn, 2); \
-        }                                                                         \
-        return Token_Create##kind(startPosition, startLine, startColumn, 1);      \
+#define MATCH2(chr, kind, chr2, kind2)                    \
+    case chr: {                                           \
+        NextChar();                                       \
+        if (Current == chr2) {                            \
+            NextChar();                                   \
+            return Token_Create##kind2(startPosition, 2); \
+        }                                                 \
+        return Token_Create##kind(startPosition, 1);      \
     } break
 
         switch (Current) {
             case '\0': {
-                return Token_CreateEndOfFile(startPosition, startLine, startColumn, 0);
+                return Token_CreateEndOfFile(startPosition, 0);
             } break;
 
                 MATCH('(', LParen);
@@ -65,255 +154,12 @@ Token Lexer::NextToken() {
                 MATCH2('<', LessThan, '=', LessThanEquals);
                 MATCH2('>', GreaterThan, '=', GreaterThanEquals);
 
-            case ' ':
-            case '\t':
-            case '\n':
-            case '\r': {
-                NextChar();
-                continue;
-            } break;
-
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9': {
-                u64 base = 10;
-                if (Current == '0') {
-                    switch (NextChar()) {
-                        case 'x':
-                        case 'X': {
-                            NextChar();
-                            base = 16;
-                        } break;
-
-                        case 'b':
-                        case 'B': {
-                            NextChar();
-                            base = 2;
-                        } break;
-
-                        default: {
-                            base = 10;
-                        } break;
-                    }
-                }
-
-                u64 intValue = 0;
-
-                while (true) {
-                    switch (Current) {
-                        case '0':
-                        case '1':
-                        case '2':
-                        case '3':
-                        case '4':
-                        case '5':
-                        case '6':
-                        case '7':
-                        case '8':
-                        case '9':
-                        case 'A':
-                        case 'B':
-                        case 'C':
-                        case 'D':
-                        case 'E':
-                        case 'F':
-                        case 'a':
-                        case 'b':
-                        case 'c':
-                        case 'd':
-                        case 'e':
-                        case 'f': {
-                            u64 value = 0;
-                            if (Current >= '0' && Current <= '9') {
-                                value = Current - '0';
-                            } else if (Current >= 'A' && Current <= 'F') {
-                                value = Current - 'A';
-                            } else if (Current >= 'a' && Current <= 'a') {
-                                value = Current - 'a';
-                            }
-
-                            if ((value == 0 && Current != '0') || value >= base) {
-                                const char* message = "Digit '%c' too big for base %llu";
-                                u8 character        = Current;
-                                u64 size            = std::snprintf(nullptr, 0, message, character, base);
-                                char* buffer        = new char[size];
-                                std::sprintf(buffer, message, character, base);
-                                Array_Add(this->Errors, String(buffer));
-                            }
-
-                            intValue *= base;
-                            intValue += value;
-
-                            NextChar();
-                        } break;
-
-                        case '_': {
-                            NextChar();
-                        }
-                            continue;
-
-                        case '.': {
-                            // TODO: Float
-                            ASSERT(false);
-                        } break;
-
-                        default: {
-                        } break;
-                    }
-                    break;
-                }
-
-                return Token_CreateInteger(startPosition, startLine, startColumn, this->Position - startPosition, intValue);
-            } break;
-
-            case 'A':
-            case 'B':
-            case 'C':
-            case 'D':
-            case 'E':
-            case 'F':
-            case 'G':
-            case 'H':
-            case 'I':
-            case 'J':
-            case 'K':
-            case 'L':
-            case 'M':
-            case 'N':
-            case 'O':
-            case 'P':
-            case 'Q':
-            case 'R':
-            case 'S':
-            case 'T':
-            case 'U':
-            case 'V':
-            case 'W':
-            case 'X':
-            case 'Y':
-            case 'Z':
-            case 'a':
-            case 'b':
-            case 'c':
-            case 'd':
-            case 'e':
-            case 'f':
-            case 'g':
-            case 'h':
-            case 'i':
-            case 'j':
-            case 'k':
-            case 'l':
-            case 'm':
-            case 'n':
-            case 'o':
-            case 'p':
-            case 'q':
-            case 'r':
-            case 's':
-            case 't':
-            case 'u':
-            case 'v':
-            case 'w':
-            case 'x':
-            case 'y':
-            case 'z': {
-                Array<u8> buffer = Array_Create<u8>();
-
-                while (true) {
-                    switch (Current) {
-                        case '0':
-                        case '1':
-                        case '2':
-                        case '3':
-                        case '4':
-                        case '5':
-                        case '6':
-                        case '7':
-                        case '8':
-                        case '9':
-                        case 'A':
-                        case 'B':
-                        case 'C':
-                        case 'D':
-                        case 'E':
-                        case 'F':
-                        case 'G':
-                        case 'H':
-                        case 'I':
-                        case 'J':
-                        case 'K':
-                        case 'L':
-                        case 'M':
-                        case 'N':
-                        case 'O':
-                        case 'P':
-                        case 'Q':
-                        case 'R':
-                        case 'S':
-                        case 'T':
-                        case 'U':
-                        case 'V':
-                        case 'W':
-                        case 'X':
-                        case 'Y':
-                        case 'Z':
-                        case 'a':
-                        case 'b':
-                        case 'c':
-                        case 'd':
-                        case 'e':
-                        case 'f':
-                        case 'g':
-                        case 'h':
-                        case 'i':
-                        case 'j':
-                        case 'k':
-                        case 'l':
-                        case 'm':
-                        case 'n':
-                        case 'o':
-                        case 'p':
-                        case 'q':
-                        case 'r':
-                        case 's':
-                        case 't':
-                        case 'u':
-                        case 'v':
-                        case 'w':
-                        case 'x':
-                        case 'y':
-                        case 'z': {
-                            Array_Add(buffer, NextChar());
-                        }
-                            continue;
-
-                        default: {
-                        } break;
-                    }
-                    break;
-                }
-
-                String identifier = { new u8[buffer.Length + 1], buffer.Length };
-                std::memcpy(identifier.Data, buffer.Data, buffer.Length * sizeof(u8));
-                identifier[buffer.Length] = '\0';
-                return Token_CreateIdentifier(startPosition, startLine, startColumn, this->Position - startPosition, identifier);
-            } break;
-
             default: {
-                const char* message = "Unknown character '%c'";
-                u8 character        = NextChar();
-                u64 size            = std::snprintf(nullptr, 0, message, character);
-                char* buffer        = new char[size];
-                std::sprintf(buffer, message, character);
-                Array_Add(this->Errors, String(buffer));
+                DiagnosticList_Add(this->Diagnostics,
+                                   DiagnosticKind::UnknownCharacter,
+                                   startPosition,
+                                   1,
+                                   DiagnosticArgument_Character(NextChar()));
             } break;
         }
 
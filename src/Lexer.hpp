@@ -4,18 +4,53 @@
 #include "String.hpp"
 #include "Array.hpp"
 #include "Token.hpp"
+#include "LexerScan.hpp"
+#include "SourceFile.hpp"
+#include "LineTable.hpp"
+#include "Diagnostics.hpp"
+
+// What a Lexer fills in. It is lent to the Lexer and given back by its destructor, so a caller lexing many files
+// can keep the capacity from one file to the next
+struct LexerStorage {
+    Array<TokenValue> Values;
+    DiagnosticList Diagnostics;
+    LineTable Lines;
+};
+
+LexerStorage LexerStorage_Create();
+void LexerStorage_Destroy(LexerStorage& storage);
 
 class Lexer {
 public:
-    Lexer(const String& source);
+    // 'source' must be followed by SOURCE_PADDING zero bytes, like the ones SourceFile_Open gives back.
+    // Without 'storage' the Lexer has its own, which goes away with it
+    Lexer(const String& source,
+          Interner& symbols     = GlobalInterner,
+          const Scanner* scan   = Scanner_GetBest(),
+          LexerStorage* storage = nullptr);
     ~Lexer();
 
     Token NextToken();
+    // Lexes everything that is left into 'tokens', the EndOfFile token included
+    void TokenizeAll(Array<Token>& tokens);
+    // Same result as TokenizeAll, but the source is split at newlines and the pieces are lexed on separate threads
+    void TokenizeAllParallel(Array<Token>& tokens, u32 threadCount);
+
+    // Builds the line table the first time it is needed
+    SourceLocation GetLocation(u32 position);
+private:
+    // In LexerNumber.cpp
+    Token LexNumber(u32 startPosition);
 private:
     String Source;
-    u64 Position;
-    u64 Line;
-    u64 Column;
+    u32 Position;
+    Interner* Symbols;
+    const Scanner* Scan;
+    LineTable Lines;
+    bool LinesBuilt;
+    LexerStorage* Storage;
 public:
-    Array<String> Errors;
+    Array<TokenValue> Values;
+    // Shared with the parser, so the limit applies to the whole file
+    DiagnosticList Diagnostics;
 };
@@ -0,0 +1,199 @@
+#include "Lexer.hpp"
+#include "NumberParse.hpp"
+
+#include <cmath>
+
+// Past this value another 8 digits could overflow a u64
+static constexpr u64 EightDigitLimit = (UINT64_MAX - 99999999) / 100000000;
+
+static const u64 SmallPowersOfTen[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000 };
+
+struct DecimalDigits {
+    u64 Mantissa;
+    u32 Taken;   // Digits that went into 'Mantissa'
+    u32 Dropped; // Digits after the ones that fit into a u64
+    bool DroppedNonZero;
+};
+
+// Consumes decimal digits with '_' separators and returns the length in bytes,
+// up to 8 digits are counted and converted at once while they still fit into the mantissa
+static u32 DecimalDigits_Consume(DecimalDigits& digits, const u8* data) {
+    u32 length = 0;
+    while (true) {
+        u32 count = 8;
+        while (count == 8 && digits.Dropped == 0 && digits.Mantissa <= EightDigitLimit) {
+            u64 word = Number_LoadEightBytes(data + length);
+            count    = Number_CountDigits(word);
+            if (count != 0) {
+                digits.Mantissa = digits.Mantissa * SmallPowersOfTen[count] + Number_ParseDigits(word, count);
+                digits.Taken += count;
+                length += count;
+            }
+        }
+
+        // Only left over digits when the mantissa is about to overflow
+        while (Character_Is(data[length], CharacterClass::Digit)) {
+            u64 digit = data[length] - '0';
+            if (digits.Dropped == 0 && digits.Mantissa <= (UINT64_MAX - digit) / 10) {
+                digits.Mantissa = digits.Mantissa * 10 + digit;
+                digits.Taken++;
+            } else {
+                digits.Dropped++;
+                digits.DroppedNonZero |= digit != 0;
+            }
+            length++;
+        }
+
+        if (data[length] != '_') {
+            return length;
+        }
+        length++;
+    }
+}
+
+Token Lexer::LexNumber(u32 startPosition) {
+#define Current (this->Source[this->Position])
+
+    // Letters that can be hex digits are still part of the literal, they are just wrong for the base
+    auto ConsumeInvalidDigits = [this](u64 base) -> void {
+        while (NumberDigits.Values[Current] != 0xFF) {
+            DiagnosticList_Add(this->Diagnostics,
+                               DiagnosticKind::DigitTooBigForBase,
+                               this->Position,
+                               1,
+                               DiagnosticArgument_Character(Current),
+                               DiagnosticArgument_Integer(base));
+            this->Position++;
+        }
+    };
+
+    if (Current == '0') {
+        u8 prefix = this->Source[this->Position + 1];
+
+        u64 base = 0;
+        if (prefix == 'x' || prefix == 'X') {
+            base = 16;
+        } else if (prefix == 'b' || prefix == 'B') {
+            base = 2;
+        }
+
+        if (base != 0) {
+            this->Position += 2;
+
+            u64 intValue  = 0;
+            bool overflow = false;
+            bool hasDigit = false;
+            u32 shift     = base == 16 ? 4 : 1;
+            while (true) {
+                u8 value = NumberDigits.Values[Current];
+                if (value == 0xFF) {
+                    if (Current != '_') {
+                        break;
+                    }
+                } else if (value >= base) {
+                    DiagnosticList_Add(this->Diagnostics,
+                                       DiagnosticKind::DigitTooBigForBase,
+                                       this->Position,
+                                       1,
+                                       DiagnosticArgument_Character(Current),
+                                       DiagnosticArgument_Integer(base));
+                } else {
+                    overflow |= (intValue >> (64 - shift)) != 0;
+                    intValue = (intValue << shift) | value;
+                    hasDigit = true;
+                }
+                this->Position++;
+            }
+
+            if (!hasDigit) {
+                DiagnosticList_Add(this->Diagnostics,
+                                   DiagnosticKind::NumberWithoutDigits,
+                                   startPosition,
+                                   this->Position - startPosition,
+                                   DiagnosticArgument_Character(prefix));
+            } else if (overflow) {
+                DiagnosticList_Add(this->Diagnostics,
+                                   DiagnosticKind::IntegerLiteralTooBig,
+                                   startPosition,
+                                   this->Position - startPosition);
+            }
+
+            return Token_CreateInteger(startPosition, this->Position - startPosition, intValue, this->Values);
+        }
+    }
+
+    DecimalDigits digits = {};
+    this->Position += DecimalDigits_Consume(digits, &Current);
+
+    // Most literals end right here, anything else after them is handled below
+    if (Current != '.' && NumberDigits.Values[Current] == 0xFF && digits.Dropped == 0) {
+        return Token_CreateInteger(startPosition, this->Position - startPosition, digits.Mantissa, this->Values);
+    }
+
+    s64 exponent = digits.Dropped;
+    bool isFloat = false;
+
+    // A '.' only starts a fraction when a digit follows it
+    if (Current == '.' && Character_Is(this->Source[this->Position + 1], CharacterClass::Digit)) {
+        this->Position++;
+        isFloat = true;
+
+        u32 taken = digits.Taken;
+        this->Position += DecimalDigits_Consume(digits, &Current);
+        exponent -= digits.Taken - taken;
+    }
+
+    if ((Current | 0x20) == 'e') {
+        u32 offset = 1;
+        bool minus = false;
+        if (this->Source[this->Position + 1] == '+' || this->Source[this->Position + 1] == '-') {
+            minus  = this->Source[this->Position + 1] == '-';
+            offset = 2;
+        }
+
+        if (Character_Is(this->Source[this->Position + offset], CharacterClass::Digit)) {
+            this->Position += offset;
+            isFloat = true;
+
+            // Saturates, anything this big is already 0 or infinity
+            s64 explicitExponent = 0;
+            while (Character_Is(Current, CharacterClass::Digit) || Current == '_') {
+                if (Current != '_' && explicitExponent < 100000) {
+                    explicitExponent = explicitExponent * 10 + (Current - '0');
+                }
+                this->Position++;
+            }
+            exponent += minus ? -explicitExponent : explicitExponent;
+        }
+    }
+
+    ConsumeInvalidDigits(10);
+
+    u32 length = this->Position - startPosition;
+    if (!isFloat) {
+        if (digits.Dropped != 0) {
+            DiagnosticList_Add(this->Diagnostics, DiagnosticKind::IntegerLiteralTooBig, startPosition, length);
+        }
+        return Token_CreateInteger(startPosition, length, digits.Mantissa, this->Values);
+    }
+
+    f64 floatValue = 0.0;
+    bool exact     = Number_ComputeFloat(digits.Mantissa, exponent, floatValue);
+    if (exact && digits.DroppedNonZero) {
+        // The real value is somewhere between the two, if they round the same it does too
+        f64 upper = 0.0;
+        exact     = digits.Mantissa != UINT64_MAX && Number_ComputeFloat(digits.Mantissa + 1, exponent, upper) &&
+                upper == floatValue;
+    }
+    if (!exact) {
+        floatValue = Number_ParseFloatExact(&this->Source[startPosition], length);
+    }
+
+    if (floatValue == HUGE_VAL) {
+        DiagnosticList_Add(this->Diagnostics, DiagnosticKind::FloatLiteralTooBig, startPosition, length);
+    }
+
+    return Token_CreateFloat(startPosition, length, floatValue, this->Values);
+
+#undef Current
+}
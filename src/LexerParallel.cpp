@@ -0,0 +1,142 @@
+#include "Lexer.hpp"
+
+#include <thread>
+
+struct LexerChunk {
+    u32 Start;
+    u32 End;
+    Interner Symbols;
+    Array<Token> Tokens;
+    Array<TokenValue> Values;
+    DiagnosticList Diagnostics;
+};
+
+static void LexerChunk_Tokenize(LexerChunk& chunk, const String& source, const Scanner* scan) {
+    // Each chunk interns into its own table, the symbols get remapped when the chunks are stitched
+    chunk.Symbols = Interner_Create();
+
+    Lexer lexer(String(source.Data + chunk.Start, chunk.End - chunk.Start), chunk.Symbols, scan);
+    lexer.TokenizeAll(chunk.Tokens);
+    chunk.Values      = lexer.Values;
+    chunk.Diagnostics = lexer.Diagnostics;
+
+    // The chunk owns them now, the lexer's destructor would free them otherwise
+    lexer.Values      = {};
+    lexer.Diagnostics = {};
+}
+
+void Lexer::TokenizeAllParallel(Array<Token>& tokens, u32 threadCount) {
+    u64 remaining = this->Source.Length - this->Position;
+    // Not worth the threads for small inputs
+    if (threadCount <= 1 || remaining < threadCount * 64 * 1024) {
+        this->TokenizeAll(tokens);
+        return;
+    }
+
+    // The language has no tokens that span lines, so cutting right after a newline never splits one
+    Array<LexerChunk> chunks = Array_Create<LexerChunk>();
+    u64 start                = this->Position;
+    for (u32 i = 0; i < threadCount && start < this->Source.Length; i++) {
+        u64 end = this->Position + remaining * (i + 1) / threadCount;
+        if (i == threadCount - 1 || end >= this->Source.Length) {
+            end = this->Source.Length;
+        } else {
+            if (end < start) {
+                end = start;
+            }
+            const u8* newline = (const u8*)std::memchr(&this->Source[end], '\n', this->Source.Length - end);
+            end               = newline == nullptr ? this->Source.Length : (u64)(newline - this->Source.Data) + 1;
+        }
+
+        LexerChunk chunk = {};
+        chunk.Start      = (u32)start;
+        chunk.End        = (u32)end;
+        chunk.Tokens     = Array_Create<Token>(0, MemoryCategory::Tokens);
+        Array_Add(chunks, chunk);
+        start = end;
+    }
+
+    // The first chunk is lexed on this thread
+    Array<std::thread> threads = Array_Create<std::thread>(chunks.Length - 1);
+    for (u64 i = 1; i < chunks.Length; i++) {
+        Array_Emplace(threads, LexerChunk_Tokenize, std::ref(chunks[i]), std::cref(this->Source), this->Scan);
+    }
+    LexerChunk_Tokenize(chunks[0], this->Source, this->Scan);
+    for (u64 i = 0; i < threads.Length; i++) {
+        threads[i].join();
+    }
+    Array_Destroy(threads);
+
+    u64 tokenCount = 0;
+    for (u64 i = 0; i < chunks.Length; i++) {
+        tokenCount += chunks[i].Tokens.Length;
+    }
+    Array_Reserve(tokens, tokens.Length + tokenCount);
+
+    Array<Symbol> symbolMap = Array_Create<Symbol>(0, MemoryCategory::Identifiers);
+    bool ended              = false;
+    for (u64 i = 0; i < chunks.Length; i++) {
+        LexerChunk& chunk = chunks[i];
+
+        // Interning the chunk's symbols in order gives them the same ids they would get from a serial lex,
+        // since each chunk numbers its names by first occurrence too
+        Array_Clear(symbolMap);
+        for (u64 j = 0; j < chunk.Symbols.Strings.Length; j++) {
+            Array_Add(symbolMap, j == Symbol_None ? Symbol_None : Interner_Intern(*this->Symbols, chunk.Symbols.Strings[j]));
+        }
+
+        u32 valueOffset = (u32)this->Values.Length;
+        for (u64 j = 0; j < chunk.Values.Length; j++) {
+            Array_Add(this->Values, chunk.Values[j]);
+        }
+        // Adding them in order keeps the same ones a serial lex would keep under the limit
+        for (u64 j = 0; j < chunk.Diagnostics.Records.Length; j++) {
+            Diagnostic diagnostic = chunk.Diagnostics.Records[j];
+            DiagnosticList_Add(this->Diagnostics,
+                               diagnostic.Kind,
+                               diagnostic.Position + chunk.Start,
+                               diagnostic.Length,
+                               diagnostic.Arguments[0],
+                               diagnostic.Arguments[1]);
+        }
+        this->Diagnostics.Dropped += chunk.Diagnostics.Dropped;
+
+        for (u64 j = 0; j < chunk.Tokens.Length; j++) {
+            Token token = chunk.Tokens[j];
+            token.Position += chunk.Start;
+
+            if (Token_IsIdentifier(token)) {
+                token.Data.Name = symbolMap[token.Data.Name];
+            } else if (Token_IsInteger(token) || Token_IsFloat(token)) {
+                token.Data.ValueIndex += valueOffset;
+            } else if (Token_IsEndOfFile(token)) {
+                // Only the last chunk ends the file, unless a '\0' in the middle ended it early
+                if (i != chunks.Length - 1 && token.Position == chunk.End) {
+                    continue;
+                }
+                ended = true;
+            }
+
+            Array_Add(tokens, token);
+        }
+
+        Array_Destroy(chunk.Tokens);
+        Array_Destroy(chunk.Values);
+        DiagnosticList_Destroy(chunk.Diagnostics);
+        Interner_Destroy(chunk.Symbols);
+
+        if (ended) {
+            this->Position = tokens[tokens.Length - 1].Position;
+            for (u64 j = i + 1; j < chunks.Length; j++) {
+                Array_Destroy(chunks[j].Tokens);
+                Array_Destroy(chunks[j].Values);
+                DiagnosticList_Destroy(chunks[j].Diagnostics);
+                Interner_Destroy(chunks[j].Symbols);
+            }
+            break;
+        }
+    }
+
+    Array_Destroy(symbolMap);
+    Array_Destroy(chunks);
+}
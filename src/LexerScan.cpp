@@ -0,0 +1,251 @@
+#include "LexerScan.hpp"
+#include "Bits.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+    #define SCAN_X64 1
+    #include <immintrin.h>
+#else
+    #define SCAN_X64 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+    #define SCAN_TARGET_AVX2
+#endif
+
+String GetScanImplementationName(ScanImplementation implementation) {
+    switch (implementation) {
+#define SCAN_IMPLEMENTATION(name)  \
+    case ScanImplementation::name: \
+        return #name;
+        SCAN_IMPLEMENTATIONS
+#undef SCAN_IMPLEMENTATION
+    }
+
+    Error("Unknown scan implementation!");
+}
+
+static u64 Scalar_SkipWhitespace(const u8* data) {
+    u64 length = 0;
+    while (Character_Is(data[length], CharacterClass::Whitespace)) {
+        length++;
+    }
+    return length;
+}
+
+static u64 Scalar_ScanIdentifierBody(const u8* data) {
+    u64 length = 0;
+    while (Character_Is(data[length], CharacterClass::IdentifierBody)) {
+        length++;
+    }
+    return length;
+}
+
+static u64 Scalar_ScanDigits(const u8* data) {
+    u64 length = 0;
+    while (Character_Is(data[length], CharacterClass::Digit)) {
+        length++;
+    }
+    return length;
+}
+
+static u64 Scalar_CountNewlines(const u8* data, u64 length) {
+    u64 newlines = 0;
+    for (u64 i = 0; i < length; i++) {
+        newlines += data[i] == '\n';
+    }
+    return newlines;
+}
+
+#if SCAN_X64
+
+// Each block function produces a bit mask with one bit per byte that belongs to the run,
+// the drivers below then only have to find the first zero bit.
+
+static u64 SSE2_SkipWhitespace(const u8* data) {
+    for (u64 offset = 0;; offset += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + offset));
+        __m128i space = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                                                  _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))),
+                                     _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\t')),
+                                                  _mm_cmpeq_epi8(block, _mm_set1_epi8('\r'))));
+
+        u32 mask = (u32)_mm_movemask_epi8(space);
+        if (mask != 0xFFFF) {
+            return offset + Bits_CountTrailingZeros(~mask);
+        }
+    }
+}
+
+static inline __m128i SSE2_InRange(__m128i block, char low, char high) {
+    return _mm_and_si128(_mm_cmpgt_epi8(block, _mm_set1_epi8((char)(low - 1))),
+                         _mm_cmplt_epi8(block, _mm_set1_epi8((char)(high + 1))));
+}
+
+static u64 SSE2_ScanIdentifierBody(const u8* data) {
+    for (u64 offset = 0;; offset += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + offset));
+        // Setting bit 5 folds upper case onto lower case without touching the digits
+        __m128i lower = _mm_or_si128(block, _mm_set1_epi8(0x20));
+        __m128i body  = _mm_or_si128(SSE2_InRange(lower, 'a', 'z'), SSE2_InRange(block, '0', '9'));
+
+        u32 mask = (u32)_mm_movemask_epi8(body);
+        if (mask != 0xFFFF) {
+            return offset + Bits_CountTrailingZeros(~mask);
+        }
+    }
+}
+
+static u64 SSE2_ScanDigits(const u8* data) {
+    for (u64 offset = 0;; offset += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + offset));
+
+        u32 mask = (u32)_mm_movemask_epi8(SSE2_InRange(block, '0', '9'));
+        if (mask != 0xFFFF) {
+            return offset + Bits_CountTrailingZeros(~mask);
+        }
+    }
+}
+
+static u64 SSE2_CountNewlines(const u8* data, u64 length) {
+    u64 newlines = 0;
+    u64 offset   = 0;
+    for (; offset + 16 <= length; offset += 16) {
+        __m128i block = _mm_loadu_si128((const __m128i*)(data + offset));
+        newlines += Bits_CountOnes((u32)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))));
+    }
+    return newlines + Scalar_CountNewlines(data + offset, length - offset);
+}
+
+SCAN_TARGET_AVX2 static u64 AVX2_SkipWhitespace(const u8* data) {
+    for (u64 offset = 0;; offset += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + offset));
+        __m256i space = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                                                        _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))),
+                                        _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t')),
+                                                        _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r'))));
+
+        u32 mask = (u32)_mm256_movemask_epi8(space);
+        if (mask != 0xFFFFFFFF) {
+            return offset + Bits_CountTrailingZeros(~mask);
+        }
+    }
+}
+
+SCAN_TARGET_AVX2 static inline __m256i AVX2_InRange(__m256i block, char low, char high) {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8((char)(low - 1))),
+                            _mm256_cmpgt_epi8(_mm256_set1_epi8((char)(high + 1)), block));
+}
+
+SCAN_TARGET_AVX2 static u64 AVX2_ScanIdentifierBody(const u8* data) {
+    for (u64 offset = 0;; offset += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + offset));
+        __m256i lower = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+        __m256i body  = _mm256_or_si256(AVX2_InRange(lower, 'a', 'z'), AVX2_InRange(block, '0', '9'));
+
+        u32 mask = (u32)_mm256_movemask_epi8(body);
+        if (mask != 0xFFFFFFFF) {
+            return offset + Bits_CountTrailingZeros(~mask);
+        }
+    }
+}
+
+SCAN_TARGET_AVX2 static u64 AVX2_ScanDigits(const u8* data) {
+    for (u64 offset = 0;; offset += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + offset));
+
+        u32 mask = (u32)_mm256_movemask_epi8(AVX2_InRange(block, '0', '9'));
+        if (mask != 0xFFFFFFFF) {
+            return offset + Bits_CountTrailingZeros(~mask);
+        }
+    }
+}
+
+SCAN_TARGET_AVX2 static u64 AVX2_CountNewlines(const u8* data, u64 length) {
+    u64 newlines = 0;
+    u64 offset   = 0;
+    for (; offset + 32 <= length; offset += 32) {
+        __m256i block = _mm256_loadu_si256((const __m256i*)(data + offset));
+        newlines += Bits_CountOnes((u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))));
+    }
+    return newlines + Scalar_CountNewlines(data + offset, length - offset);
+}
+
+static bool CpuSupportsAVX2() {
+    #if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx     = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+    #else
+    return __builtin_cpu_supports("avx2");
+    #endif
+}
+
+#endif
+
+static const Scanner ScalarScanner = {
+    ScanImplementation::Scalar,
+    Scalar_SkipWhitespace,
+    Scalar_ScanIdentifierBody,
+    Scalar_ScanDigits,
+    Scalar_CountNewlines,
+};
+
+#if SCAN_X64
+static const Scanner SSE2Scanner = {
+    ScanImplementation::SSE2,
+    SSE2_SkipWhitespace,
+    SSE2_ScanIdentifierBody,
+    SSE2_ScanDigits,
+    SSE2_CountNewlines,
+};
+
+static const Scanner AVX2Scanner = {
+    ScanImplementation::AVX2,
+    AVX2_SkipWhitespace,
+    AVX2_ScanIdentifierBody,
+    AVX2_ScanDigits,
+    AVX2_CountNewlines,
+};
+#endif
+
+const Scanner* Scanner_Get(ScanImplementation implementation) {
+    switch (implementation) {
+        case ScanImplementation::Scalar:
+            return &ScalarScanner;
+
+#if SCAN_X64
+        case ScanImplementation::SSE2:
+            return &SSE2Scanner; // Always there on x64
+
+        case ScanImplementation::AVX2:
+            return CpuSupportsAVX2() ? &AVX2Scanner : nullptr;
+#else
+        case ScanImplementation::SSE2:
+        case ScanImplementation::AVX2:
+            return nullptr;
+#endif
+    }
+
+    return nullptr;
+}
+
+const Scanner* Scanner_GetBest() {
+    static const Scanner* best = []() -> const Scanner* {
+        if (const Scanner* scanner = Scanner_Get(ScanImplementation::AVX2)) {
+            return scanner;
+        }
+        if (const Scanner* scanner = Scanner_Get(ScanImplementation::SSE2)) {
+            return scanner;
+        }
+        return &ScalarScanner;
+    }();
+    return best;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "String.hpp"
+
+enum struct CharacterClass : u8 {
+    Whitespace      = 1 << 0,
+    IdentifierStart = 1 << 1,
+    IdentifierBody  = 1 << 2,
+    Digit           = 1 << 3,
+};
+
+struct CharacterClassTable {
+    u8 Classes[256];
+};
+
+constexpr CharacterClassTable CharacterClassTable_Create() {
+    CharacterClassTable table = {};
+
+    table.Classes[(u8)' ']  = (u8)CharacterClass::Whitespace;
+    table.Classes[(u8)'\t'] = (u8)CharacterClass::Whitespace;
+    table.Classes[(u8)'\n'] = (u8)CharacterClass::Whitespace;
+    table.Classes[(u8)'\r'] = (u8)CharacterClass::Whitespace;
+
+    for (u8 c = 'A'; c <= 'Z'; c++) {
+        table.Classes[c]             = (u8)CharacterClass::IdentifierStart | (u8)CharacterClass::IdentifierBody;
+        table.Classes[c - 'A' + 'a'] = (u8)CharacterClass::IdentifierStart | (u8)CharacterClass::IdentifierBody;
+    }
+
+    for (u8 c = '0'; c <= '9'; c++) {
+        table.Classes[c] = (u8)CharacterClass::IdentifierBody | (u8)CharacterClass::Digit;
+    }
+
+    return table;
+}
+
+inline constexpr CharacterClassTable CharacterClasses = CharacterClassTable_Create();
+
+inline bool Character_Is(u8 character, CharacterClass characterClass) {
+    return (CharacterClasses.Classes[character] & (u8)characterClass) != 0;
+}
+
+#define SCAN_IMPLEMENTATIONS    \
+    SCAN_IMPLEMENTATION(Scalar) \
+    SCAN_IMPLEMENTATION(SSE2)   \
+    SCAN_IMPLEMENTATION(AVX2)
+
+enum struct ScanImplementation : u8 {
+#define SCAN_IMPLEMENTATION(name) name,
+    SCAN_IMPLEMENTATIONS
+#undef SCAN_IMPLEMENTATION
+};
+
+String GetScanImplementationName(ScanImplementation implementation);
+
+// Block scanners for the runs that make up most of a source file.
+// All of them stop at the '\0' sentinel, and may read up to 32 bytes past it.
+struct Scanner {
+    ScanImplementation Implementation;
+
+    u64 (*SkipWhitespace)(const u8* data);
+    u64 (*ScanIdentifierBody)(const u8* data);
+    u64 (*ScanDigits)(const u8* data);
+
+    // Unlike the scans this one stops at 'length' and does not rely on the padding
+    u64 (*CountNewlines)(const u8* data, u64 length);
+};
+
+// Returns nullptr when the CPU cannot run the implementation
+const Scanner* Scanner_Get(ScanImplementation implementation);
+const Scanner* Scanner_GetBest();
@@ -0,0 +1,43 @@
+#include "LineTable.hpp"
+
+LineTable LineTable_Create(const String& source, const Scanner* scan) {
+    LineTable table  = {};
+    table.LineStarts = Array_Create<u32>(0, MemoryCategory::Source);
+    LineTable_Rebuild(table, source, scan);
+    return table;
+}
+
+void LineTable_Rebuild(LineTable& table, const String& source, const Scanner* scan) {
+    Array_Clear(table.LineStarts);
+
+    // Count first so the table is allocated exactly once
+    Array_Reserve(table.LineStarts, scan->CountNewlines(source.Data, source.Length) + 1);
+
+    Array_Add(table.LineStarts, 0u);
+    const u8* start = source.Data;
+    const u8* end   = source.Data + source.Length;
+    while (const u8* newline = (const u8*)std::memchr(start, '\n', (size_t)(end - start))) {
+        Array_Add(table.LineStarts, (u32)(newline - source.Data + 1));
+        start = newline + 1;
+    }
+}
+
+void LineTable_Destroy(LineTable& table) {
+    Array_Destroy(table.LineStarts);
+}
+
+SourceLocation LineTable_GetLocation(const LineTable& table, u32 position) {
+    // Find the last line that starts at or before the position
+    u64 low  = 0;
+    u64 high = table.LineStarts.Length;
+    while (high - low > 1) {
+        u64 middle = low + (high - low) / 2;
+        if (table.LineStarts[middle] <= position) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    return { (u32)(low + 1), position - table.LineStarts[low] + 1 };
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "String.hpp"
+#include "Array.hpp"
+#include "LexerScan.hpp"
+
+struct SourceLocation {
+    u32 Line;
+    u32 Column;
+};
+
+// Offsets of the first byte of every line, so a token position can be turned back into a line and column
+struct LineTable {
+    Array<u32> LineStarts;
+};
+
+LineTable LineTable_Create(const String& source, const Scanner* scan);
+// Same as a new table for 'source', but in the storage 'table' already has
+void LineTable_Rebuild(LineTable& table, const String& source, const Scanner* scan);
+void LineTable_Destroy(LineTable& table);
+
+SourceLocation LineTable_GetLocation(const LineTable& table, u32 position);
@@ -2,321 +2,211 @@
 #include "String.hpp"
 #include "Array.hpp"
 #include "Parser.hpp"
-
-void ResolveAst(Ast* ast);
-
-int main(int argc, char** argv) {
-    // Not sure if this is needed for no buffering of stderr and stdout
-    std::setbuf(stderr, nullptr);
-    std::setbuf(stdout, nullptr);
-
-    if (argc != 2) {
-        Error("Invalid arguments!\nUsage: %s file", argv[0]);
+#include "SourceFile.hpp"
+#include "Resolver.hpp"
+#include "FlatAst.hpp"
+#include "TypeTable.hpp"
+#include "CompilationSession.hpp"
+
+struct Options {
+    u32 LexThreads;
+    u32 ResolveThreads;
+    bool HugePages;
+    bool InternerStats;
+    bool AstStats;
+    bool FlatAst;
+    bool TypeStats;
+    bool MemStats;
+    bool ConstValues;
+    bool Incremental;
+    bool OnDemand;
+    const char* Roots; // Comma separated, for --on-demand
+};
+
+// Interned again for every file, each one starts with an empty interner
+static Array<Symbol> InternRoots(const char* roots) {
+    Array<Symbol> symbols = Array_Create<Symbol>();
+    const char* start     = roots;
+    for (const char* c = roots;; c++) {
+        if (*c == ',' || *c == '\0') {
+            if (c != start) {
+                Array_Add(symbols, Interner_Intern(GlobalInterner, String((u8*)start, (u64)(c - start))));
+            }
+            if (*c == '\0') {
+                break;
+            }
+            start = c + 1;
+        }
     }
+    return symbols;
+}
 
-    std::FILE* file = std::fopen(argv[1], "rb");
-    if (file == nullptr) {
-        Error("Unable to open file: '%s'", argv[1]);
+// A revision is resolved reusing what resolving the file before it found, for --incremental
+static void CompileFile(CompilationSession& session, const char* path, bool revision, const Options& options) {
+    bool opened = revision ? CompilationSession_OpenRevision(session, path) : CompilationSession_Open(session, path);
+    if (!opened) {
+        Error("Unable to read file: '%s'", path);
     }
 
-    std::fseek(file, 0, SEEK_END);
-    u64 fileSize = std::ftell(file);
-    std::fseek(file, 0, SEEK_SET);
-    u8* data = new u8[fileSize];
-    if (fread(data, sizeof(u8), fileSize, file) != fileSize) {
-        Error("Unable to read file: '%s'", argv[1]);
+    if (options.MemStats) {
+        MemoryStats_Print("reading");
     }
-    std::fclose(file);
-
-    String fileSource(data, fileSize);
 
-    Parser parser(fileSource);
+    Parser parser(session.File.Source, session.Nodes, ParserMode::Batched, options.LexThreads, &session.Parsing);
     AstStatement* statement = parser.ParseStatement();
 
-    if (parser.Lexer.Errors.Length != 0) {
-        PrintError("\nLexer Errors:\n");
+    const DiagnosticList& diagnostics = parser.Lexer.Diagnostics;
+    if (DiagnosticList_Count(diagnostics) != 0) {
+        PrintError("\nErrors:\n");
 
-        for (u64 i = 0; i < parser.Lexer.Errors.Length; i++) {
-            PrintError("%.*s\n", (u32)parser.Lexer.Errors[i].Length, parser.Lexer.Errors[i].Data);
+        for (u64 i = 0; i < diagnostics.Records.Length; i++) {
+            Diagnostic_Print(diagnostics.Records[i], parser.Lexer.GetLocation(diagnostics.Records[i].Position));
         }
-    }
 
-    if (parser.Errors.Length != 0) {
-        PrintError("\nParser Errors:\n");
-
-        for (u64 i = 0; i < parser.Errors.Length; i++) {
-            PrintError("%.*s\n", (u32)parser.Errors[i].Length, parser.Errors[i].Data);
+        if (diagnostics.Dropped != 0) {
+            PrintError("... and %llu more\n", diagnostics.Dropped);
         }
     }
 
-    if (parser.Lexer.Errors.Length != 0 || parser.Errors.Length != 0) {
+    if (DiagnosticList_Count(diagnostics) != 0) {
         Error("\nThere were errors. We cannot continue.");
     }
 
-    ResolveAst(statement);
-    Ast_Print(statement);
+    if (options.MemStats) {
+        MemoryStats_Print("parsing");
+        AstStats_PrintAllocations(AstAllocations);
+    }
 
-    delete[] data;
-    return 0;
-}
+    if (options.AstStats) {
+        AstStats stats = {};
+        Ast_CollectStats(statement, stats);
+        AstStats_Print(stats);
+    }
 
-bool TypesEqual(AstType* a, AstType* b) {
-    ASSERT(Ast_IsType(a) && Ast_IsType(b));
+    // Before resolving, evaluating needs nothing resolved and reports mistakes the resolver does not look for
+    if (options.ConstValues && !Evaluator_PrintAll(session.Constants, statement)) {
+        Error("\nThere were errors. We cannot continue.");
+    }
 
-    if (a->Kind != b->Kind) {
-        if (Ast_IsTypeName(a) && Ast_IsTypeName(b)) {
-            return TypesEqual(a->Type, b->Type);
-        } else if (Ast_IsTypeName(a)) {
-            return TypesEqual(a->Type, b);
-        } else if (Ast_IsTypeName(b)) {
-            return TypesEqual(a, b->Type);
-        } else {
-            return false;
+    TypeTableStats types = {};
+    if (options.FlatAst) {
+        // Same output, from the handle based copy of the tree
+        FlatAst& flat  = session.Flat;
+        AstHandle root = FlatAst_Build(flat, statement);
+        FlatAst_Resolve(flat, root);
+        FlatAst_Print(flat, root);
+        types = flat.TypeStats;
+    } else if (options.Incremental) {
+        if (!IncrementalResolver_Resolve(session.Incremental, statement, session.File.Source)) {
+            Error("\nThere were errors. We cannot continue.");
+        }
+        Ast_Print(statement);
+        IncrementalStats_Print(session.Incremental.Stats);
+        types = GlobalTypes.Stats;
+    } else if (options.OnDemand) {
+        Array<Symbol> roots      = InternRoots(options.Roots);
+        ResolveDemandStats stats = {};
+        if (!ResolveAstOnDemand(statement, roots, stats)) {
+            Error("\nThere were errors. We cannot continue.");
+        }
+        Ast_Print(statement);
+        ResolveDemandStats_Print(stats);
+        types = GlobalTypes.Stats;
+        Array_Destroy(roots);
+    } else {
+        if (!ResolveAstParallel(statement, options.ResolveThreads)) {
+            Error("\nThere were errors. We cannot continue.");
         }
+        Ast_Print(statement);
+        types = GlobalTypes.Stats;
     }
 
-    switch (a->Kind) {
-        case AstKind::TypeName: {
-            return a->TypeName.Name.Data.Name == b->TypeName.Name.Data.Name;
-        } break;
-
-        case AstKind::TypeProcedure: {
-            if (a->TypeProcedure.Arguments.Length != b->TypeProcedure.Arguments.Length) {
-                return false;
-            }
-
-            if (!TypesEqual(a->TypeProcedure.ReturnType, b->TypeProcedure.ReturnType)) {
-                return false;
-            }
-
-            for (u64 i = 0; i < a->TypeProcedure.Arguments.Length; i++) {
-                if (!TypesEqual(a->TypeProcedure.Arguments[i], b->TypeProcedure.Arguments[i])) {
-                    return false;
-                }
-            }
-
-            return true;
-        } break;
-
-        case AstKind::TypeVoid: {
-            return true;
-        } break;
-
-        case AstKind::TypeFloat: {
-            return a->TypeFloat.Size == b->TypeFloat.Size;
-        } break;
-
-        case AstKind::TypeInteger: {
-            return a->TypeInteger.Signed == b->TypeInteger.Signed && a->TypeInteger.Size == b->TypeInteger.Size;
-        } break;
-
-        case AstKind::TypeDeref: {
-            return TypesEqual(a->TypeDeref.DerefedType, b->TypeDeref.DerefedType);
-        } break;
-
-        case AstKind::TypePointer: {
-            return TypesEqual(a->TypePointer.PointerTo, b->TypePointer.PointerTo);
-        } break;
-
-        default: {
-            ASSERT(false);
-            return false;
-        } break;
+    if (options.InternerStats) {
+        const InternerStats& stats = GlobalInterner.Stats;
+        PrintError("\nInterner Stats:\n");
+        PrintError("Unique Symbols: %llu\n", stats.UniqueSymbols);
+        PrintError("Lookups: %llu\n", stats.Lookups);
+        PrintError("Average Probe Length: %.3f\n", stats.Lookups == 0 ? 0.0 : (f64)stats.TotalProbes / (f64)stats.Lookups);
+        PrintError("Max Probe Length: %llu\n", stats.MaxProbeLength);
+        PrintError("Bytes Stored: %llu\n", stats.BytesStored);
     }
-}
-
-#include <functional>
 
-static AstTypeType* TypeType   = Ast_CreateTypeType(nullptr, nullptr, nullptr, {});
-static AstTypeVoid* TypeVoid   = Ast_CreateTypeVoid(nullptr, nullptr, nullptr, {});
-static AstTypeInteger* TypeInt = Ast_CreateTypeInteger(nullptr, nullptr, nullptr, { 0, true });
-
-void ResolveAst(Ast* ast) {
-    if (ast == nullptr) {
-        return;
+    if (options.MemStats) {
+        MemoryStats_Print("resolving and printing");
     }
 
-    if (ast->Completion == AstCompletion::Complete) {
-        return;
-    } else if (ast->Completion == AstCompletion::Completing) {
-        Error("Cyclic dependency found!");
-    } else { // AstCompletion::Incomplete
-        ast->Completion = AstCompletion::Completing;
+    if (options.TypeStats) {
+        PrintError("\nType Stats:\n");
+        PrintError("Distinct Types: %llu\n", types.DistinctTypes);
+        PrintError("Procedure Signatures: %llu\n", types.ProcedureSignatures);
+        PrintError("Lookups: %llu\n", types.Lookups);
+        PrintError("Average Probe Length: %.3f\n", types.Lookups == 0 ? 0.0 : (f64)types.TotalProbes / (f64)types.Lookups);
+        PrintError("Max Probe Length: %llu\n", types.MaxProbeLength);
     }
+}
 
-    switch (ast->Kind) {
-        case AstKind::Declaration: {
-            ResolveAst(ast->Declaration.Type);
-            ResolveAst(ast->Declaration.Value);
-
-            if (ast->Declaration.Type == nullptr) {
-                ast->Declaration.Type = ast->Declaration.Value->Type;
-            } else {
-                if (!TypesEqual(ast->Declaration.Type, ast->Declaration.Value->Type)) {
-                    Error("Types not compatible!");
-                }
-            }
-
-            ast->Type = TypeVoid;
-        } break;
-
-        case AstKind::File: {
-            ResolveAst(ast->File.Scope);
-            ast->Type = TypeVoid;
-        } break;
-
-        case AstKind::Scope: {
-            for (u64 i = 0; i < ast->Scope.ExtraVariablesInScope.Length; i++) {
-                ResolveAst(ast->Scope.ExtraVariablesInScope[i]);
-            }
-            for (u64 i = 0; i < ast->Scope.Statements.Length; i++) {
-                ResolveAst(ast->Scope.Statements[i]);
-            }
-            ast->Type = TypeVoid;
-        } break;
-
-        case AstKind::IntegerLiteral: {
-            ast->Type = TypeInt;
-        } break;
-
-        case AstKind::FloatLiteral: {
-            ASSERT(false);
-        } break;
-
-        case AstKind::Name: {
-            std::function<void(AstScope*)> findFunc = [&](AstScope* scope) -> void {
-                if (scope == nullptr) {
-                    return;
-                }
-
-                for (u64 i = 0; i < scope->Scope.Statements.Length; i++) {
-                    if (scope->Scope.Statements[i] == ast || scope->Scope.Statements[i] == ast->ParentStatement) {
-                        break;
-                    }
-
-                    if (Ast_IsDeclaration(scope->Scope.Statements[i])) {
-                        if (scope->Scope.Statements[i]->Declaration.Name->Name.Identifier.Data.Name ==
-                            ast->Name.Identifier.Data.Name) {
-                            ResolveAst(scope->Scope.Statements[i]);
-                            ast->Type = scope->Scope.Statements[i]->Declaration.Type;
-                            return;
-                        }
-                    }
-                }
-
-                findFunc(scope->ParentScope);
-            };
-
-            String name = ast->TypeName.Name.Data.Name;
-            if (name == "type") {
-                ast->Type = TypeType;
-            } else if (name == "void") {
-                ast->Type = TypeVoid;
-            } else if (name == "int") {
-                ast->Type = TypeInt;
-            } else {
-                findFunc(ast->ParentScope);
-                if (ast->Type == nullptr) {
-                    Error("Could not find name!");
-                }
-            }
-        } break;
-
-        case AstKind::Unary:
-            break;
+int main(int argc, char** argv) {
+    // Not sure if this is needed for no buffering of stderr and stdout
+    std::setbuf(stderr, nullptr);
+    std::setbuf(stdout, nullptr);
 
-        case AstKind::Binary:
+    Array<const char*> paths = Array_Create<const char*>();
+    Options options          = {};
+    options.LexThreads       = 1;
+    options.ResolveThreads   = 1;
+    options.Roots            = "main";
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--interner-stats") == 0) {
+            options.InternerStats = true;
+        } else if (std::strcmp(argv[i], "--ast-stats") == 0) {
+            options.AstStats = true;
+        } else if (std::strcmp(argv[i], "--mem-stats") == 0) {
+            options.MemStats = true;
+        } else if (std::strcmp(argv[i], "--type-stats") == 0) {
+            options.TypeStats = true;
+        } else if (std::strcmp(argv[i], "--const-values") == 0) {
+            options.ConstValues = true;
+        } else if (std::strcmp(argv[i], "--incremental") == 0) {
+            options.Incremental = true;
+        } else if (std::strcmp(argv[i], "--on-demand") == 0) {
+            options.OnDemand = true;
+        } else if (std::strncmp(argv[i], "--roots=", 8) == 0) {
+            options.OnDemand = true;
+            options.Roots    = argv[i] + 8;
+        } else if (std::strcmp(argv[i], "--flat-ast") == 0) {
+            options.FlatAst = true;
+        } else if (std::strcmp(argv[i], "--huge-pages") == 0) {
+            options.HugePages = true;
+        } else if (std::strncmp(argv[i], "--lex-threads=", 14) == 0) {
+            options.LexThreads = (u32)std::strtoul(argv[i] + 14, nullptr, 10);
+        } else if (std::strncmp(argv[i], "--resolve-threads=", 18) == 0) {
+            options.ResolveThreads = (u32)std::strtoul(argv[i] + 18, nullptr, 10);
+        } else if (argv[i][0] != '-') {
+            Array_Add(paths, (const char*)argv[i]);
+        } else {
+            Array_Clear(paths);
             break;
+        }
+    }
 
-        case AstKind::Procedure: {
-            Array<AstType*> argumentTypes = Array_Create<AstType*>();
-            for (u64 i = 0; i < ast->Procedure.Arguments.Length; i++) {
-                ResolveAst(ast->Procedure.Arguments[i]);
-                Array_Add(argumentTypes, ast->Procedure.Arguments[i]->Declaration.Type);
-            }
-            ResolveAst(ast->Procedure.ReturnType);
-            ResolveAst(ast->Procedure.Body);
-            ast->Type = Ast_CreateTypeProcedure(
-                ast->ParentFile, ast->ParentScope, ast->ParentStatement, { argumentTypes, ast->Procedure.ReturnType });
-        } break;
-
-        case AstKind::TypeName: {
-            std::function<void(AstScope*)> findFunc = [&](AstScope* scope) -> void {
-                if (scope == nullptr) {
-                    return;
-                }
-
-                for (u64 i = 0; i < scope->Scope.Statements.Length; i++) {
-                    if (scope->Scope.Statements[i] == ast || scope->Scope.Statements[i] == ast->ParentStatement) {
-                        break;
-                    }
-
-                    if (Ast_IsDeclaration(scope->Scope.Statements[i])) {
-                        if (scope->Scope.Statements[i]->Declaration.Name->Name.Identifier.Data.Name ==
-                            ast->TypeName.Name.Data.Name) {
-                            ResolveAst(scope->Scope.Statements[i]);
-                            ast->Type = scope->Scope.Statements[i]->Declaration.Type;
-                            std::memcpy(ast->Type, scope->Scope.Statements[i]->Declaration.Type, sizeof(Ast));
-                            return;
-                        }
-                    }
-                }
-
-                findFunc(scope->ParentScope);
-            };
-
-            String name = ast->TypeName.Name.Data.Name;
-            if (name == "type") {
-                std::memcpy(ast, TypeType, sizeof(Ast));
-            } else if (name == "void") {
-                std::memcpy(ast, TypeVoid, sizeof(Ast));
-            } else if (name == "int") {
-                std::memcpy(ast, TypeInt, sizeof(Ast));
-            } else {
-                findFunc(ast->ParentScope);
-                if (ast->Type == nullptr) {
-                    Error("Could not find name!");
-                }
-            }
-        } break;
-
-        case AstKind::TypePointer: {
-            ResolveAst(ast->TypePointer.PointerTo);
-            ast->Type = TypeType;
-        } break;
-
-        case AstKind::TypeDeref: {
-            ResolveAst(ast->TypeDeref.DerefedType);
-            if (!Ast_IsTypePointer(ast->TypeDeref.DerefedType)) {
-                Error("Unable to deref type that is not pointer!");
-            }
-            std::memcpy(ast, ast->TypeDeref.DerefedType, sizeof(Ast));
-            ast->Type = TypeType;
-        } break;
-
-        case AstKind::TypeProcedure: {
-            for (u64 i = 0; i < ast->TypeProcedure.Arguments.Length; i++) {
-                ResolveAst(ast->TypeProcedure.Arguments[i]);
-            }
-            ResolveAst(ast->TypeProcedure.ReturnType);
-            ast->Type = TypeType;
-        } break;
-
-        case AstKind::TypeInteger:
-        case AstKind::TypeFloat:
-        case AstKind::TypeVoid:
-        case AstKind::TypeType: {
-            ast->Type = TypeType;
-        } break;
+    if (paths.Length == 0) {
+        Error("Invalid arguments!\nUsage: %s [--interner-stats] [--ast-stats] [--type-stats] [--mem-stats] [--flat-ast] "
+              "[--const-values] [--incremental] [--on-demand] [--roots=NAME,...] [--lex-threads=N] [--resolve-threads=N] "
+              "[--huge-pages] file...",
+              argv[0]);
+    }
 
-        case AstKind::_Statement_Begin:
-        case AstKind::_Statement_End:
-        case AstKind::_Expression_Begin:
-        case AstKind::_Expression_End:
-        case AstKind::_Type_Begin:
-        case AstKind::_Type_End:
-            ASSERT(false);
+    // The files are compiled one after the other, each in the memory the one before it used. With --incremental they
+    // are revisions of the same file, each an edit of the one before it
+    CompilationSession session = CompilationSession_Create(options.HugePages);
+    for (u64 i = 0; i < paths.Length; i++) {
+        if (i != 0) {
+            Print("\n");
+        }
+        CompileFile(session, paths[i], options.Incremental && i != 0, options);
     }
 
-    ast->Completion = AstCompletion::Complete;
+    CompilationSession_Destroy(session);
+    Array_Destroy(paths);
+    return 0;
 }
@@ -0,0 +1,127 @@
+#include "Memory.hpp"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+MemoryStats GlobalMemoryStats;
+
+const char* GetMemoryCategoryName(MemoryCategory category) {
+    switch (category) {
+#define MEMORY_CATEGORY(name, str) \
+    case MemoryCategory::name:     \
+        return str;
+        MEMORY_CATEGORIES
+#undef MEMORY_CATEGORY
+        default:
+            return "";
+    }
+}
+
+static void MemoryCategoryStats_Add(MemoryCategoryStats& stats, u64 size) {
+    stats.Allocations.fetch_add(1, std::memory_order_relaxed);
+    stats.Bytes.fetch_add(size, std::memory_order_relaxed);
+
+    u64 live = stats.LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+    u64 peak = stats.PeakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !stats.PeakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void Memory_Track(MemoryCategory category, u64 size) {
+    MemoryCategoryStats_Add(GlobalMemoryStats.Categories[(u64)category], size);
+    MemoryCategoryStats_Add(GlobalMemoryStats.Total, size);
+}
+
+void Memory_Untrack(MemoryCategory category, u64 size) {
+    GlobalMemoryStats.Categories[(u64)category].LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+    GlobalMemoryStats.Total.LiveBytes.fetch_sub(size, std::memory_order_relaxed);
+}
+
+void* Memory_Allocate(MemoryCategory category, u64 size) {
+    void* pointer = std::malloc(size != 0 ? size : 1);
+    if (pointer == nullptr) {
+        Error("Out of memory, could not allocate %llu bytes for %s", size, GetMemoryCategoryName(category));
+    }
+    Memory_Track(category, size);
+    return pointer;
+}
+
+void* Memory_AllocateZeroed(MemoryCategory category, u64 size) {
+    void* pointer = std::calloc(size != 0 ? size : 1, 1);
+    if (pointer == nullptr) {
+        Error("Out of memory, could not allocate %llu bytes for %s", size, GetMemoryCategoryName(category));
+    }
+    Memory_Track(category, size);
+    return pointer;
+}
+
+void* Memory_Reallocate(MemoryCategory category, void* pointer, u64 oldSize, u64 newSize) {
+    void* newPointer = std::realloc(pointer, newSize != 0 ? newSize : 1);
+    if (newPointer == nullptr) {
+        Error("Out of memory, could not grow %s to %llu bytes", GetMemoryCategoryName(category), newSize);
+    }
+    if (pointer != nullptr) {
+        Memory_Untrack(category, oldSize);
+    }
+    Memory_Track(category, newSize);
+    return newPointer;
+}
+
+void Memory_Free(MemoryCategory category, void* pointer, u64 size) {
+    if (pointer == nullptr) {
+        return;
+    }
+    std::free(pointer);
+    Memory_Untrack(category, size);
+}
+
+u64 Memory_GetPeakResidentBytes() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return (u64)counters.PeakWorkingSetSize;
+#else
+    struct rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    #if defined(__APPLE__)
+    return (u64)usage.ru_maxrss;
+    #else
+    return (u64)usage.ru_maxrss * 1024; // In kilobytes on Linux
+    #endif
+#endif
+}
+
+static void MemoryCategoryStats_Print(const char* name, const MemoryCategoryStats& stats) {
+    PrintError("%-14s %12llu %14llu %14llu %14llu\n",
+               name,
+               (unsigned long long)stats.Allocations.load(std::memory_order_relaxed),
+               (unsigned long long)stats.Bytes.load(std::memory_order_relaxed),
+               (unsigned long long)stats.LiveBytes.load(std::memory_order_relaxed),
+               (unsigned long long)stats.PeakLiveBytes.load(std::memory_order_relaxed));
+}
+
+void MemoryStats_Print(const char* phase) {
+    PrintError("\nMemory Stats after %s:\n", phase);
+    PrintError("%-14s %12s %14s %14s %14s\n", "Category", "Allocations", "Bytes", "Live Bytes", "Peak Live");
+
+    for (u64 i = 0; i < MemoryCategoryCount; i++) {
+        const MemoryCategoryStats& stats = GlobalMemoryStats.Categories[i];
+        if (stats.Allocations.load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        MemoryCategoryStats_Print(GetMemoryCategoryName((MemoryCategory)i), stats);
+    }
+    MemoryCategoryStats_Print("Total", GlobalMemoryStats.Total);
+
+    PrintError("Peak Resident: %.1f MB\n", (f64)Memory_GetPeakResidentBytes() / (1024.0 * 1024.0));
+}
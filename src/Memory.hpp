@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Defines.hpp"
+
+#include <atomic>
+
+// What memory is for. Every heap allocation and every arena page is counted under one of these
+#define MEMORY_CATEGORIES                       \
+    MEMORY_CATEGORY(Source, "source")           \
+    MEMORY_CATEGORY(Tokens, "tokens")           \
+    MEMORY_CATEGORY(Identifiers, "identifiers") \
+    MEMORY_CATEGORY(Ast, "ast")                 \
+    MEMORY_CATEGORY(Types, "types")             \
+    MEMORY_CATEGORY(Constants, "constants")     \
+    MEMORY_CATEGORY(Queries, "queries")         \
+    MEMORY_CATEGORY(Diagnostics, "diagnostics") \
+    MEMORY_CATEGORY(Arrays, "arrays")
+
+enum struct MemoryCategory : u8 {
+#define MEMORY_CATEGORY(name, str) name,
+    MEMORY_CATEGORIES
+#undef MEMORY_CATEGORY
+};
+
+constexpr u64 MemoryCategoryCount = 0
+#define MEMORY_CATEGORY(name, str) +1
+    MEMORY_CATEGORIES
+#undef MEMORY_CATEGORY
+    ;
+
+const char* GetMemoryCategoryName(MemoryCategory category);
+
+// Atomic, the parallel lexer allocates from several threads at once
+struct MemoryCategoryStats {
+    std::atomic<u64> Allocations;
+    std::atomic<u64> Bytes; // Everything ever allocated, growing counts the new size
+    std::atomic<u64> LiveBytes;
+    std::atomic<u64> PeakLiveBytes;
+};
+
+struct MemoryStats {
+    MemoryCategoryStats Categories[MemoryCategoryCount];
+    MemoryCategoryStats Total;
+};
+
+extern MemoryStats GlobalMemoryStats;
+
+// For memory that does not come from these functions, like arena pages and mapped files
+void Memory_Track(MemoryCategory category, u64 size);
+void Memory_Untrack(MemoryCategory category, u64 size);
+
+// All of these exit when out of memory. The sizes given back have to be the ones that were asked for
+void* Memory_Allocate(MemoryCategory category, u64 size);
+void* Memory_AllocateZeroed(MemoryCategory category, u64 size);
+void* Memory_Reallocate(MemoryCategory category, void* pointer, u64 oldSize, u64 newSize);
+void Memory_Free(MemoryCategory category, void* pointer, u64 size);
+
+#define Alloc(category, size)            Memory_Allocate(MemoryCategory::category, size)
+#define Dealloc(category, pointer, size) Memory_Free(MemoryCategory::category, pointer, size)
+
+// The most memory the process has had resident at once, 0 where that is not known
+u64 Memory_GetPeakResidentBytes();
+
+// One line per category that was used, then the peak resident size
+void MemoryStats_Print(const char* phase);
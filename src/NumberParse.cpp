@@ -0,0 +1,123 @@
+#include "NumberParse.hpp"
+#include "Bits.hpp"
+#include "Memory.hpp"
+
+#include <cfloat>
+#include <cmath>
+
+static const f64 ExactPowersOfTen[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+static f64 Number_MakeFloat(u64 significand, s64 power2) {
+    u64 bits = significand | ((u64)power2 << 52);
+    f64 result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+bool Number_ComputeFloat(u64 mantissa, s64 exponent, f64& result) {
+    if (mantissa == 0 || exponent < NUMBER_SMALLEST_POWER_OF_TEN) {
+        result = 0.0;
+        return true;
+    }
+    if (exponent > NUMBER_LARGEST_POWER_OF_TEN) {
+        result = HUGE_VAL;
+        return true;
+    }
+
+#if FLT_EVAL_METHOD == 0
+    // Both operands are exact, so the one rounding of the multiply or divide is the correct one
+    if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+        result = exponent < 0 ? (f64)mantissa / ExactPowersOfTen[-exponent] : (f64)mantissa * ExactPowersOfTen[exponent];
+        return true;
+    }
+#endif
+
+    // Eisel-Lemire: multiply the normalized mantissa by a 128 bit approximation of the power of five,
+    // the power of two part only moves the exponent
+    u32 leadingZeros = Bits_CountLeadingZeros64(mantissa);
+    mantissa <<= leadingZeros;
+
+    const u64* power = NumberPowersOfFive[exponent - NUMBER_SMALLEST_POWER_OF_TEN];
+    u64 high;
+    u64 low = Bits_Multiply128(mantissa, power[0], high);
+    // 52 stored bits, the implicit one, one to round with and one more when the product has a leading zero,
+    // if everything below those is set the second half of the power could still carry into them
+    if ((high & 0x1FF) == 0x1FF) {
+        u64 secondHigh;
+        Bits_Multiply128(mantissa, power[1], secondHigh);
+        low += secondHigh;
+        if (secondHigh > low) {
+            high++;
+        }
+    }
+    if (low == 0xFFFFFFFFFFFFFFFF && (exponent < -27 || exponent > 55)) {
+        return false;
+    }
+
+    u32 upperBit    = (u32)(high >> 63);
+    u32 shift       = upperBit + 64 - 52 - 3;
+    u64 significand = high >> shift;
+    // floor(log2(10^exponent)) + 63 is where the product's top bit is, 1023 is the exponent bias
+    s64 power2 = ((((152170 + 65536) * exponent) >> 16) + 63) + upperBit - leadingZeros + 1023;
+
+    if (power2 <= 0) {
+        // Subnormal, or rounds to 0
+        if (-power2 + 1 >= 64) {
+            result = 0.0;
+            return true;
+        }
+        significand >>= -power2 + 1;
+        significand += significand & 1;
+        significand >>= 1;
+        // Rounding up can carry into the smallest normal number
+        power2 = significand < (1ULL << 52) ? 0 : 1;
+        result = Number_MakeFloat(significand & ((1ULL << 52) - 1), power2);
+        return true;
+    }
+
+    // Exactly halfway between two floats, which is only possible for small powers, rounds to even
+    if (low <= 1 && exponent >= -4 && exponent <= 23 && (significand & 3) == 1) {
+        if ((significand << shift) == high) {
+            significand &= ~1ULL;
+        }
+    }
+
+    significand += significand & 1;
+    significand >>= 1;
+    if (significand >= (2ULL << 52)) {
+        significand = 1ULL << 52;
+        power2++;
+    }
+    significand &= ~(1ULL << 52);
+
+    if (power2 >= 0x7FF) {
+        result = HUGE_VAL;
+        return true;
+    }
+
+    result = Number_MakeFloat(significand, power2);
+    return true;
+}
+
+f64 Number_ParseFloatExact(const u8* data, u64 length) {
+    char stackBuffer[128];
+    char* buffer = length < sizeof(stackBuffer) ? stackBuffer : (char*)Alloc(Tokens, length + 1);
+
+    u64 count = 0;
+    for (u64 i = 0; i < length; i++) {
+        if (data[i] != '_') {
+            buffer[count++] = (char)data[i];
+        }
+    }
+    buffer[count] = '\0';
+
+    f64 result = std::strtod(buffer, nullptr);
+
+    if (buffer != stackBuffer) {
+        Dealloc(Tokens, buffer, length + 1);
+    }
+    return result;
+}
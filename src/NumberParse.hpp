@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Bits.hpp"
+
+// The range of powers of ten that can change the result, past these everything is 0 or infinity
+#define NUMBER_SMALLEST_POWER_OF_TEN -342
+#define NUMBER_LARGEST_POWER_OF_TEN  308
+
+extern const u64 NumberPowersOfFive[NUMBER_LARGEST_POWER_OF_TEN - NUMBER_SMALLEST_POWER_OF_TEN + 1][2];
+
+struct NumberDigitTable {
+    u8 Values[256];
+};
+
+constexpr NumberDigitTable NumberDigitTable_Create() {
+    NumberDigitTable table = {};
+    for (u32 i = 0; i < 256; i++) {
+        table.Values[i] = 0xFF;
+    }
+
+    for (u8 c = '0'; c <= '9'; c++) {
+        table.Values[c] = c - '0';
+    }
+    for (u8 c = 'a'; c <= 'f'; c++) {
+        table.Values[c]             = c - 'a' + 10;
+        table.Values[c - 'a' + 'A'] = c - 'a' + 10;
+    }
+
+    return table;
+}
+
+// 0xFF for anything that is not a hex digit
+inline constexpr NumberDigitTable NumberDigits = NumberDigitTable_Create();
+
+inline u64 Number_LoadEightBytes(const u8* data) {
+    u64 value;
+    std::memcpy(&value, data, sizeof(value));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    value = __builtin_bswap64(value);
+#endif
+    return value;
+}
+
+// How many of the 8 bytes in 'word' are '0'..'9' before the first one that is not
+inline u32 Number_CountDigits(u64 word) {
+    // Borrows and carries only move towards later bytes, so the first non digit is always flagged correctly
+    u64 nonDigits = ((word + 0x4646464646464646) | (word - 0x3030303030303030)) & 0x8080808080808080;
+    return nonDigits == 0 ? 8 : Bits_CountTrailingZeros64(nonDigits) / 8;
+}
+
+// Converts 8 digits with 3 multiplies instead of a chain of 8, the bytes must be '0'..'9'
+inline u32 Number_ParseEightDigits(u64 word) {
+    u64 value = word - 0x3030303030303030;
+    value     = value * 10 + (value >> 8); // Every other byte now holds a 2 digit number
+    value     = ((value & 0x000000FF000000FF) * (100 + (1000000ULL << 32)) +
+             ((value >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))) >>
+            32;
+    return (u32)value;
+}
+
+// Converts the first 'count' (1 to 8) digits in 'word' by shifting them to the end and padding the front with '0'
+inline u32 Number_ParseDigits(u64 word, u32 count) {
+    u32 padding = (8 - count) * 8;
+    return Number_ParseEightDigits(count == 8 ? word : (word << padding) | (0x3030303030303030 >> (64 - padding)));
+}
+
+// Sets 'result' to 'mantissa' * 10^'exponent' correctly rounded, returns false in the rare cases
+// where 128 bits of the power of ten are not enough to be sure, then Number_ParseFloatExact has to be used
+bool Number_ComputeFloat(u64 mantissa, s64 exponent, f64& result);
+
+// The slow but always correct conversion of a decimal float literal, '_' separators are skipped
+f64 Number_ParseFloatExact(const u8* data, u64 length);
@@ -1,30 +1,110 @@
 #include "Parser.hpp"
 
-Parser::Parser(const String& source)
-    : Lexer(source)
-    , Errors(Array_Create<String>())
-    , Current(this->Lexer.NextToken())
+ParserStorage ParserStorage_Create() {
+    ParserStorage storage  = {};
+    storage.Lexer          = LexerStorage_Create();
+    storage.Tokens         = Array_Create<Token>(0, MemoryCategory::Tokens);
+    storage.Children       = Array_Create<Ast*>(0, MemoryCategory::Ast);
+    storage.OpenScopeNodes = Array_Create<Ast*>(0, MemoryCategory::Ast);
+    storage.Symbols        = Array_Create<AstScopeSymbol>(0, MemoryCategory::Ast);
+    return storage;
+}
+
+void ParserStorage_Destroy(ParserStorage& storage) {
+    LexerStorage_Destroy(storage.Lexer);
+    Array_Destroy(storage.Tokens);
+    Array_Destroy(storage.Children);
+    Array_Destroy(storage.OpenScopeNodes);
+    Array_Destroy(storage.Symbols);
+}
+
+Parser::Parser(const String& source, Arena& nodes, ParserMode mode, u32 lexThreads, ParserStorage* storage)
+    : Lexer(source, GlobalInterner, Scanner_GetBest(), storage != nullptr ? &storage->Lexer : nullptr)
+    , Nodes(&nodes)
+    , Storage(storage)
+    , Mode(mode)
+    , Tokens(Array_Create<Token>(0, MemoryCategory::Tokens))
+    , TokenIndex(0)
+    , Current({})
+    , Children(Array_Create<Ast*>(0, MemoryCategory::Ast))
+    , OpenScopeNodes(Array_Create<Ast*>(0, MemoryCategory::Ast))
+    , Symbols(Array_Create<AstScopeSymbol>(0, MemoryCategory::Ast))
     , ParentFile(nullptr)
     , ParentScope(nullptr)
-    , ParentStatement(nullptr) {}
+    , ParentStatement(nullptr)
+    , Ordinal(0) {
+    if (storage != nullptr) {
+        this->Tokens         = storage->Tokens;
+        this->Children       = storage->Children;
+        this->OpenScopeNodes = storage->OpenScopeNodes;
+        this->Symbols        = storage->Symbols;
+        Array_Clear(this->Tokens);
+        Array_Clear(this->Children);
+        Array_Clear(this->OpenScopeNodes);
+        Array_Clear(this->Symbols);
+    }
+    DiagnosticList_UseArena(this->Lexer.Diagnostics, nodes);
 
-Parser::~Parser() = default;
+    if (this->Mode == ParserMode::Batched) {
+        if (lexThreads > 1) {
+            this->Lexer.TokenizeAllParallel(this->Tokens, lexThreads);
+        } else {
+            this->Lexer.TokenizeAll(this->Tokens);
+        }
+    }
+    this->Current = this->PeekToken(0);
+}
+
+Parser::~Parser() {
+    if (this->Storage != nullptr) {
+        this->Storage->Tokens         = this->Tokens;
+        this->Storage->Children       = this->Children;
+        this->Storage->OpenScopeNodes = this->OpenScopeNodes;
+        this->Storage->Symbols        = this->Symbols;
+    } else {
+        Array_Destroy(this->Tokens);
+        Array_Destroy(this->Children);
+        Array_Destroy(this->OpenScopeNodes);
+        Array_Destroy(this->Symbols);
+    }
+}
 
 Token Parser::NextToken() {
-    Token token   = this->Current;
-    this->Current = this->Lexer.NextToken();
+    Token token = this->Current;
+    if (!Token_IsEndOfFile(token)) {
+        this->TokenIndex++;
+        if (this->Mode == ParserMode::Streaming && this->TokenIndex == this->Tokens.Length) {
+            // Nothing has been looked ahead at, so the buffer can start over
+            Array_Clear(this->Tokens);
+            this->TokenIndex = 0;
+        }
+    }
+    this->Current = this->PeekToken(0);
     return token;
 }
 
+Token Parser::PeekToken(u64 offset) {
+    u64 index = this->TokenIndex + offset;
+    while (index >= this->Tokens.Length) {
+        // Only streaming mode ever gets here without having seen the EndOfFile token
+        if (this->Tokens.Length != 0 && Token_IsEndOfFile(this->Tokens[this->Tokens.Length - 1])) {
+            return this->Tokens[this->Tokens.Length - 1];
+        }
+        Array_Add(this->Tokens, this->Lexer.NextToken());
+    }
+    return this->Tokens[index];
+}
+
+void Parser::Report(DiagnosticKind kind, const Token& token, DiagnosticArgument argument0, DiagnosticArgument argument1) {
+    DiagnosticList_Add(this->Lexer.Diagnostics, kind, token.Position, token.Length, argument0, argument1);
+}
+
 Token Parser::ExpectToken(TokenKind kind) {
     if (this->Current.Kind != kind) {
-        const char* message = "Expected '%.*s' got '%.*s'";
-        String name1        = GetTokenKindName(kind);
-        String name2        = GetTokenKindName(this->Current.Kind);
-        u64 size            = std::snprintf(nullptr, 0, message, (u32)name1.Length, name1.Data, (u32)name2.Length, name2.Data);
-        char* buffer        = new char[size];
-        std::sprintf(buffer, message, (u32)name1.Length, name1.Data, (u32)name2.Length, name2.Data);
-        Array_Add(this->Errors, String(buffer));
+        this->Report(DiagnosticKind::ExpectedToken,
+                     this->Current,
+                     DiagnosticArgument_TokenKind(kind),
+                     DiagnosticArgument_TokenKind(this->Current.Kind));
 
         // TODO: Think about this
         return {};
@@ -33,19 +113,110 @@ Token Parser::ExpectToken(TokenKind kind) {
     }
 }
 
-AstScope* Parser::ParseScope(Array<Ast*> extraVarsInScope) {
+Ast* Parser::Track(Ast* node) {
+    node->Ordinal = this->Ordinal;
+    if (this->ParentScope != nullptr) {
+        Array_Add(this->OpenScopeNodes, node);
+    }
+    return node;
+}
+
+AstList<AstScopeSymbol> Parser::BuildSymbols(AstList<Ast*> statements, AstList<Ast*> extraVarsInScope) {
+    Array_Clear(this->Symbols);
+
+    u64 count = extraVarsInScope.Length;
+    for (u64 i = 0; i < statements.Length; i++) {
+        count += Ast_IsDeclaration(statements[i]);
+    }
+    if (count == 0) {
+        return {};
+    }
+
+    u64 slotCount = 4;
+    while (slotCount < count * 2) {
+        slotCount *= 2;
+    }
+    Array_Reserve(this->Symbols, slotCount);
+    for (u64 i = 0; i < slotCount; i++) {
+        Array_Add(this->Symbols, AstScopeSymbol{});
+    }
+
+    // Only the first declaration of a name goes in, it is the one a name after both of them finds
+    u64 mask = slotCount - 1;
+    auto add = [&](Ast* declaration, u32 ordinal) {
+        if (!Ast_IsDeclaration(declaration) || !Ast_IsName(declaration->Declaration().Name)) {
+            return;
+        }
+
+        Symbol name = declaration->Declaration().Name->Name().Identifier.Data.Name;
+        for (u64 index = AstScope_GetSymbolSlot(name, mask);; index = (index + 1) & mask) {
+            AstScopeSymbol& symbol = this->Symbols[index];
+            if (symbol.Name == name) {
+                return;
+            }
+            if (symbol.Name == Symbol_None) {
+                symbol.Name        = name;
+                symbol.Ordinal     = ordinal;
+                symbol.Declaration = declaration;
+                return;
+            }
+        }
+    };
+
+    // Arguments are in scope from the first statement on
+    for (u64 i = 0; i < extraVarsInScope.Length; i++) {
+        add(extraVarsInScope[i], 0);
+    }
+    for (u64 i = 0; i < statements.Length; i++) {
+        add(statements[i], (u32)(i + 1));
+    }
+    return AstList_Create(this->Symbols.Data, this->Symbols.Length);
+}
+
+AstScope* Parser::ParseScope(AstList<Ast*> extraVarsInScope) {
     this->ExpectToken(TokenKind::LBrace);
-    AstScope* scope = Ast_CreateScope(
-        this->ParentFile, this->ParentScope, this->ParentStatement, { Array_Create<AstStatement*>(), extraVarsInScope });
-    this->ParentScope     = scope;
-    this->ParentStatement = scope;
+
+    // The statements are stored behind the scope node, so it can only be made once they are all parsed.
+    // Until then the nodes in the scope point at 'open', and get pointed at the real node at the end
+    Ast open             = {};
+    open.Kind            = AstKind::Scope;
+    open.ParentFile      = this->ParentFile;
+    open.ParentScope     = this->ParentScope;
+    open.ParentStatement = this->ParentStatement;
+
+    u64 firstChild        = this->Children.Length;
+    u64 firstNode         = this->OpenScopeNodes.Length;
+    u32 outerOrdinal      = this->Ordinal;
+    this->ParentScope     = &open;
+    this->ParentStatement = &open;
     while (!Token_IsRBrace(this->Current) && !Token_IsEndOfFile(this->Current)) {
-        Array_Add(scope->Scope.Statements, this->ParseStatement());
+        this->Ordinal           = (u32)(this->Children.Length - firstChild + 1);
+        AstStatement* statement = this->ParseStatement();
+        Array_Add(this->Children, statement);
     }
     this->ExpectToken(TokenKind::RBrace);
-    this->ParentScope     = scope->ParentScope;
-    this->ParentStatement = scope->ParentStatement;
-    return scope;
+    this->ParentScope     = open.ParentScope;
+    this->ParentStatement = open.ParentStatement;
+    this->Ordinal         = outerOrdinal;
+
+    AstList<Ast*> statements        = AstList_Create(&this->Children[firstChild], this->Children.Length - firstChild);
+    AstList<AstScopeSymbol> symbols = this->BuildSymbols(statements, extraVarsInScope);
+    AstScope* scope                 = Ast_CreateScope(
+        *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { statements, extraVarsInScope, symbols });
+    this->Children.Length = firstChild;
+
+    for (u64 i = firstNode; i < this->OpenScopeNodes.Length; i++) {
+        Ast* node = this->OpenScopeNodes[i];
+        if (node->ParentScope == &open) {
+            node->ParentScope = scope;
+        }
+        if (node->ParentStatement == &open) {
+            node->ParentStatement = scope;
+        }
+    }
+    this->OpenScopeNodes.Length = firstNode;
+
+    return this->Track(scope);
 }
 
 AstStatement* Parser::ParseStatement() {
@@ -59,15 +230,10 @@ AstStatement* Parser::ParseStatement() {
     switch (this->Current.Kind) {
         case TokenKind::Colon: {
             if (!Ast_IsName(expression)) {
-                const char* message = "Expected 'Name' got '%.*s'";
-                String name         = GetAstKindName(expression->Kind);
-                u64 size            = std::snprintf(nullptr, 0, message, (u32)name.Length, name.Data);
-                char* buffer        = new char[size];
-                std::sprintf(buffer, message, (u32)name.Length, name.Data);
-                Array_Add(this->Errors, String(message));
+                this->Report(DiagnosticKind::ExpectedName, this->Current, DiagnosticArgument_AstKind(expression->Kind));
             }
             AstDeclaration* declaration = this->ParseDeclaration(expression);
-            if (declaration != nullptr && !Ast_IsProcedure(declaration->Declaration.Value)) {
+            if (declaration != nullptr && !Ast_IsProcedure(declaration->Declaration().Value)) {
                 this->ExpectToken(TokenKind::Semicolon);
             }
             return declaration;
@@ -80,37 +246,40 @@ AstStatement* Parser::ParseStatement() {
 }
 
 AstDeclaration* Parser::ParseDeclaration(AstName* name) {
-    AstDeclaration* declaration = Ast_CreateDeclaration(this->ParentFile, this->ParentScope, this->ParentStatement, {});
-    this->ParentStatement       = declaration;
+    AstDeclaration* declaration = this->Track(
+        Ast_CreateDeclaration(*this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, {}));
+    this->ParentStatement = declaration;
 
-    name->ParentStatement         = declaration;
-    declaration->Declaration.Name = name;
+    name->ParentStatement           = declaration;
+    declaration->Declaration().Name = name;
 
     this->ExpectToken(TokenKind::Colon);
 
-    declaration->Declaration.Type = nullptr;
+    declaration->Declaration().Type = nullptr;
     if (this->Current.Kind != TokenKind::Colon && this->Current.Kind != TokenKind::Equals) {
-        declaration->Declaration.Type = this->ParseType();
+        declaration->Declaration().Type = this->ParseType();
     }
 
     if (Token_IsColon(this->Current)) {
         this->ExpectToken(TokenKind::Colon);
-        declaration->Declaration.Constant = true;
-        declaration->Declaration.Value    = this->ParseExpression();
+        declaration->Declaration().Constant = true;
+        declaration->Declaration().Value    = this->ParseExpression();
         this->ParentStatement             = declaration->ParentStatement;
         return declaration;
     } else if (Token_IsEquals(this->Current)) {
         this->ExpectToken(TokenKind::Equals);
-        declaration->Declaration.Constant = false;
-        declaration->Declaration.Value    = this->ParseExpression();
+        declaration->Declaration().Constant = false;
+        declaration->Declaration().Value    = this->ParseExpression();
         this->ParentStatement             = declaration->ParentStatement;
         return declaration;
     } else {
-        if (declaration->Declaration.Type == nullptr) {
-            Array_Add(this->Errors, String("Cannot declare variable with nether type nor value"));
+        if (declaration->Declaration().Type == nullptr) {
+            // 'name' is only a Name if ExpectedName was not reported for it
+            this->Report(DiagnosticKind::DeclarationWithoutTypeOrValue,
+                         Ast_IsName(name) ? name->Name().Identifier : this->Current);
         }
-        declaration->Declaration.Constant = false;
-        declaration->Declaration.Value    = nullptr;
+        declaration->Declaration().Constant = false;
+        declaration->Declaration().Value    = nullptr;
         this->ParentStatement             = declaration->ParentStatement;
         return declaration;
     }
@@ -123,84 +292,51 @@ AstExpression* Parser::ParseExpression() {
 AstExpression* Parser::ParsePrimaryExpression() {
     switch (this->Current.Kind) {
         case TokenKind::Identifier:
-            return Ast_CreateName(this->ParentFile, this->ParentScope, this->ParentStatement, { this->NextToken() });
-
-        case TokenKind::Integer:
-            return Ast_CreateIntegerLiteral(this->ParentFile, this->ParentScope, this->ParentStatement, { this->NextToken() });
+            return this->Track(Ast_CreateName(
+                *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { this->NextToken() }));
+
+        case TokenKind::Integer: {
+            Token token = this->NextToken();
+            u64 value   = Token_GetIntValue(token, this->Lexer.Values);
+            return this->Track(Ast_CreateIntegerLiteral(
+                *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { token, value }));
+        } break;
 
-        case TokenKind::Float:
-            return Ast_CreateFloatLiteral(this->ParentFile, this->ParentScope, this->ParentStatement, { this->NextToken() });
+        case TokenKind::Float: {
+            Token token = this->NextToken();
+            f64 value   = Token_GetFloatValue(token, this->Lexer.Values);
+            return this->Track(Ast_CreateFloatLiteral(
+                *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { token, value }));
+        } break;
 
         case TokenKind::LParen: {
-            this->NextToken();
-            if (Token_IsRParen(this->Current)) {
+            // '()' and '(name:' can only start a procedure, anything else is a parenthesized expression
+            Token next = this->PeekToken(1);
+            if (Token_IsRParen(next) || (Token_IsIdentifier(next) && Token_IsColon(this->PeekToken(2)))) {
                 return this->ParseProcedure();
             }
+            this->NextToken();
             AstExpression* expression = this->ParseExpression();
-            if (Token_IsColon(this->Current)) {
-                if (!Ast_IsName(expression)) {
-                    Array_Add(this->Errors, String("Expected name")); // TODO: Better error
-                }
-                return this->ParseProcedure(expression);
-            }
             this->ExpectToken(TokenKind::RParen);
             return expression;
         } break;
 
         default: {
-            const char* message = "Unexpected '%.*s'";
-            String name         = GetTokenKindName(this->NextToken().Kind);
-            u64 size            = std::snprintf(nullptr, 0, message, (u32)name.Length, name.Data);
-            char* buffer        = new char[size];
-            std::sprintf(buffer, message, (u32)name.Length, name.Data);
-            Array_Add(this->Errors, String(buffer));
+            Token token = this->NextToken();
+            this->Report(DiagnosticKind::UnexpectedToken, token, DiagnosticArgument_TokenKind(token.Kind));
             return nullptr;
         } break;
     }
 }
 
-inline static u64 GetUnaryOperatorPrecedence(const Token& token) {
-    switch (token.Kind) {
-        case TokenKind::Plus:
-        case TokenKind::Minus:
-        case TokenKind::Asterisk:
-        case TokenKind::Caret:
-            return 4;
-
-        default:
-            return 0;
-    }
-}
-
-inline static u64 GetBinaryOperatorPrecedence(const Token& token) {
-    switch (token.Kind) {
-        case TokenKind::Asterisk:
-        case TokenKind::Slash:
-        case TokenKind::Percent:
-            return 3;
-
-        case TokenKind::Plus:
-        case TokenKind::Minus:
-            return 2;
-
-        case TokenKind::LessThan:
-        case TokenKind::LessThanEquals:
-        case TokenKind::GreaterThan:
-        case TokenKind::GreaterThanEquals:
-            return 1;
-
-        default:
-            return 0;
-    }
-}
-
 AstExpression* Parser::ParseBinaryExpression(u64 parentPrecedence) {
     AstExpression* left;
     u64 unaryPrecedence = GetUnaryOperatorPrecedence(this->Current);
     if (unaryPrecedence > parentPrecedence) {
         Token operator_        = this->NextToken();
         AstExpression* operand = this->ParseBinaryExpression(unaryPrecedence);
-        left = Ast_CreateUnary(this->ParentFile, this->ParentScope, this->ParentStatement, { operator_, operand });
+        left = this->Track(
+            Ast_CreateUnary(*this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { operator_, operand }));
     } else {
         left = this->ParsePrimaryExpression();
     }
@@ -213,7 +349,8 @@ AstExpression* Parser::ParseBinaryExpression(u64 parentPrecedence) {
 
         Token operator_      = this->NextToken();
         AstExpression* right = this->ParseBinaryExpression(precedence);
-        left = Ast_CreateBinary(this->ParentFile, this->ParentScope, this->ParentStatement, { left, operator_, right });
+        left = this->Track(Ast_CreateBinary(
+            *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { left, operator_, right }));
     }
 
     return left;
@@ -223,17 +360,20 @@ AstType* Parser::ParseType() {
     switch (this->Current.Kind) {
         case TokenKind::Caret: {
             this->ExpectToken(TokenKind::Caret);
-            return Ast_CreateTypePointer(this->ParentFile, this->ParentScope, this->ParentStatement, { this->ParseType() });
+            return this->Track(Ast_CreateTypePointer(
+                *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { this->ParseType() }));
         } break;
 
         case TokenKind::Asterisk: {
             this->ExpectToken(TokenKind::Asterisk);
-            return Ast_CreateTypeDeref(this->ParentFile, this->ParentScope, this->ParentStatement, { this->ParseType() });
+            return this->Track(Ast_CreateTypeDeref(
+                *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { this->ParseType() }));
         } break;
 
         case TokenKind::Identifier: {
             Token token = this->ExpectToken(TokenKind::Identifier);
-            return Ast_CreateTypeName(this->ParentFile, this->ParentScope, this->ParentStatement, { token });
+            return this->Track(
+                Ast_CreateTypeName(*this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { token }));
         } break;
 
         case TokenKind::LParen: {
@@ -245,49 +385,23 @@ AstType* Parser::ParseType() {
         } break;
 
         default: {
-            const char* message = "Unexpected '%.*s'";
-            String name         = GetTokenKindName(this->NextToken().Kind);
-            u64 size            = std::snprintf(nullptr, 0, message, (u32)name.Length, name.Data);
-            char* buffer        = new char[size];
-            std::sprintf(buffer, message, (u32)name.Length, name.Data);
-            Array_Add(this->Errors, String(buffer));
+            Token token = this->NextToken();
+            this->Report(DiagnosticKind::UnexpectedToken, token, DiagnosticArgument_TokenKind(token.Kind));
             return nullptr;
         } break;
     }
 }
 
-AstProcedure* Parser::ParseProcedure(AstName* firstArgName) {
-    Array<AstDeclaration*> arguments = Array_Create<AstDeclaration*>();
-
-    if (firstArgName != nullptr) {
-        this->ExpectToken(TokenKind::Colon);
-
-        AstType* type = nullptr;
-        if (!Token_IsEquals(this->Current)) {
-            type = this->ParseType();
-        }
-
-        AstExpression* value = nullptr;
-        if (Token_IsEquals(this->Current)) {
-            value = this->ParseExpression();
-        }
-
-        if (type == nullptr && value == nullptr) {
-            Array_Add(this->Errors, String("Cannot have a declaration with no type nor value"));
-        }
-
-        Array_Add(arguments,
-                  Ast_CreateDeclaration(
-                      this->ParentFile, this->ParentScope, this->ParentStatement, { false, firstArgName, type, value }));
-
-        if (!Token_IsRParen(this->Current)) {
-            this->ExpectToken(TokenKind::Comma);
-        }
-    }
+AstProcedure* Parser::ParseProcedure() {
+    u64 firstArgument = this->Children.Length;
 
+    this->ExpectToken(TokenKind::LParen);
     while (!Token_IsRParen(this->Current) && !Token_IsEndOfFile(this->Current)) {
-        AstName* name = Ast_CreateName(
-            this->ParentFile, this->ParentScope, this->ParentStatement, { this->ExpectToken(TokenKind::Identifier) });
+        AstName* name = this->Track(Ast_CreateName(*this->Nodes,
+                                                   this->ParentFile,
+                                                   this->ParentScope,
+                                                   this->ParentStatement,
+                                                   { this->ExpectToken(TokenKind::Identifier) }));
         this->ExpectToken(TokenKind::Colon);
 
         AstType* type = nullptr;
@@ -301,12 +415,12 @@ AstProcedure* Parser::ParseProcedure(AstName* firstArgName) {
         }
 
         if (type == nullptr && value == nullptr) {
-            Array_Add(this->Errors, String("Cannot have a declaration with no type nor value"));
+            this->Report(DiagnosticKind::ArgumentWithoutTypeOrValue, name->Name().Identifier);
         }
 
-        Array_Add(
-            arguments,
-            Ast_CreateDeclaration(this->ParentFile, this->ParentScope, this->ParentStatement, { false, name, type, value }));
+        AstDeclaration* argument = this->Track(Ast_CreateDeclaration(
+            *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { false, name, type, value }));
+        Array_Add(this->Children, argument);
 
         if (!Token_IsRParen(this->Current)) {
             this->ExpectToken(TokenKind::Comma);
@@ -321,28 +435,32 @@ AstProcedure* Parser::ParseProcedure(AstName* firstArgName) {
         this->ExpectToken(TokenKind::GreaterThan);
         returnType = this->ParseType();
     } else {
-        returnType = Ast_CreateTypeVoid(this->ParentFile, this->ParentScope, this->ParentStatement, {});
+        returnType = this->Track(
+            Ast_CreateTypeVoid(*this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, {}));
     }
 
+    AstList<Ast*> arguments = AstList_Create(&this->Children[firstArgument], this->Children.Length - firstArgument);
     if (Token_IsLBrace(this->Current)) {
-        AstProcedure* procedure =
-            Ast_CreateProcedure(this->ParentFile, this->ParentScope, this->ParentStatement, { arguments, returnType, nullptr });
-        Array<Ast*> scopeParams = Array_Create<Ast*>();
-        for (u64 i = 0; i < procedure->Procedure.Arguments.Length; i++) {
-            Array_Add(scopeParams, procedure->Procedure.Arguments[i]);
-        }
-        AstScope* body            = this->ParseScope(scopeParams);
-        procedure->Procedure.Body = body;
+        AstProcedure* procedure = this->Track(Ast_CreateProcedure(
+            *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { arguments, returnType, nullptr }));
+        this->Children.Length = firstArgument;
+
+        AstScope* body              = this->ParseScope(procedure->Procedure().Arguments);
+        procedure->Procedure().Body = body;
         return procedure;
     } else {
-        Array<AstType*> argumentTypes = Array_Create<AstType*>();
+        // The argument types take the place of the declarations they came from
         for (u64 i = 0; i < arguments.Length; i++) {
-            AstType* type = arguments[i]->Declaration.Type;
+            AstType* type = arguments[i]->Declaration().Type;
             if (type == nullptr) {
-                Array_Add(this->Errors, String("Must always have argument type for procedure type!"));
+                this->Report(DiagnosticKind::ProcedureTypeArgumentWithoutType,
+                             arguments[i]->Declaration().Name->Name().Identifier);
             }
-            Array_Add(argumentTypes, type);
+            arguments[i] = type;
         }
-        return Ast_CreateTypeProcedure(this->ParentFile, this->ParentScope, this->ParentStatement, { argumentTypes, returnType });
+        AstTypeProcedure* type = this->Track(Ast_CreateTypeProcedure(
+            *this->Nodes, this->ParentFile, this->ParentScope, this->ParentStatement, { arguments, returnType }));
+        this->Children.Length = firstArgument;
+        return type;
     }
 }
@@ -6,12 +6,35 @@
 #include "Lexer.hpp"
 #include "Ast.hpp"
 
+enum struct ParserMode {
+    Streaming, // Lexes one token at a time, as the parser asks for them
+    Batched,   // Lexes the whole source up front and walks the buffer
+};
+
+// What a Parser fills in besides the AST, lent to it the same way as LexerStorage
+struct ParserStorage {
+    LexerStorage Lexer;
+    Array<Token> Tokens;
+    Array<Ast*> Children;
+    Array<Ast*> OpenScopeNodes;
+    Array<AstScopeSymbol> Symbols;
+};
+
+ParserStorage ParserStorage_Create();
+void ParserStorage_Destroy(ParserStorage& storage);
+
 class Parser {
 public:
-    Parser(const String& source);
+    // Every node, node array and diagnostic is allocated from 'nodes', which has to outlive the AST.
+    // 'lexThreads' only applies to batched mode. Without 'storage' the Parser has its own
+    Parser(const String& source,
+           Arena& nodes,
+           ParserMode mode        = ParserMode::Batched,
+           u32 lexThreads         = 1,
+           ParserStorage* storage = nullptr);
     ~Parser();
 public:
-    AstScope* ParseScope(Array<Ast*> extraVarsInScope = Array_Create<Ast*>());
+    AstScope* ParseScope(AstList<Ast*> extraVarsInScope = {});
 
     AstStatement* ParseStatement();
     AstDeclaration* ParseDeclaration(AstName* name);
@@ -22,16 +45,35 @@ public:
 
     AstType* ParseType();
 
-    AstProcedure* ParseProcedure(AstName* firstArgName = nullptr);
+    AstProcedure* ParseProcedure();
 private:
     Token NextToken();
     Token ExpectToken(TokenKind kind);
+    // 0 is the current token, looking past the end gives back the EndOfFile token
+    Token PeekToken(u64 offset);
+    void Report(DiagnosticKind kind, const Token& token, DiagnosticArgument argument0 = {}, DiagnosticArgument argument1 = {});
+    // Every node the parser makes goes through here, so the ones in an open scope can be fixed up when it closes
+    Ast* Track(Ast* node);
+    // The symbol table of a scope, valid until the next scope closes
+    AstList<AstScopeSymbol> BuildSymbols(AstList<Ast*> statements, AstList<Ast*> extraVarsInScope);
 public:
     Lexer Lexer;
-    Array<String> Errors;
 private:
+    Arena* Nodes;
+    ParserStorage* Storage;
+    ParserMode Mode;
+    Array<Token> Tokens;
+    u64 TokenIndex;
     Token Current;
+    // Statements and arguments waiting for the node they are stored behind, shared by every nesting level
+    Array<Ast*> Children;
+    // Nodes made while a scope is open, which still point at its stand-in, see ParseScope
+    Array<Ast*> OpenScopeNodes;
+    // Scratch space for BuildSymbols
+    Array<AstScopeSymbol> Symbols;
     AstFile* ParentFile;
     AstScope* ParentScope;
     AstStatement* ParentStatement;
+    // Given to every node made, see Ast::Ordinal
+    u32 Ordinal;
 };
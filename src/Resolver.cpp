@@ -0,0 +1,528 @@
+#include "Resolver.hpp"
+#include "Evaluator.hpp"
+#include "SmallArray.hpp"
+#include "TypeTable.hpp"
+
+#include <mutex>
+
+// The type table is not thread safe, shared resolution holds this around every lookup
+static std::mutex TypesLock;
+
+static AstType* GetCanonical(AstType* type, bool shared) {
+    if (!shared) {
+        return TypeTable_GetCanonical(GlobalTypes, type);
+    }
+    std::lock_guard<std::mutex> lock(TypesLock);
+    return TypeTable_GetCanonical(GlobalTypes, type);
+}
+
+static AstType* GetProcedure(AstList<AstType*> arguments, AstType* returnType, bool shared) {
+    if (!shared) {
+        return TypeTable_GetProcedure(GlobalTypes, arguments, returnType);
+    }
+    std::lock_guard<std::mutex> lock(TypesLock);
+    return TypeTable_GetProcedure(GlobalTypes, arguments, returnType);
+}
+
+static AstType* GetPointer(AstType* pointerTo, bool shared) {
+    if (!shared) {
+        return TypeTable_GetPointer(GlobalTypes, pointerTo);
+    }
+    std::lock_guard<std::mutex> lock(TypesLock);
+    return TypeTable_GetPointer(GlobalTypes, pointerTo);
+}
+
+AstDeclaration* Resolve_FindDeclaration(Ast* ast, Symbol name) {
+    u32 before = ast->Ordinal;
+    for (AstScope* scope = ast->ParentScope; scope != nullptr; scope = scope->ParentScope) {
+        const AstScopeSymbol* symbol = AstScope_FindSymbol(scope, name);
+        if (symbol != nullptr && symbol->Ordinal < before) {
+            return symbol->Declaration;
+        }
+        before = UINT32_MAX;
+    }
+    return nullptr;
+}
+
+bool Resolve_IsBuiltinName(Symbol name) {
+    return name == Symbol_Type || name == Symbol_Void || name == Symbol_Int;
+}
+
+AstScope* Resolve_FindTopLevelScope(Ast* ast) {
+    if (Ast_IsFile(ast)) {
+        return ast->File().Scope;
+    } else if (Ast_IsDeclaration(ast) && Ast_IsProcedure(ast->Declaration().Value)) {
+        return ast->Declaration().Value->Procedure().Body;
+    } else if (Ast_IsScope(ast)) {
+        return ast;
+    }
+    return nullptr;
+}
+
+static AstType* GetBuiltinType(Symbol name) {
+    if (name == Symbol_Type) {
+        return GlobalTypes.TypeType;
+    } else if (name == Symbol_Void) {
+        return GlobalTypes.TypeVoid;
+    } else {
+        return GlobalTypes.TypeInt;
+    }
+}
+
+static Symbol GetReferencedName(Ast* ast) {
+    return Ast_IsName(ast) ? ast->Name().Identifier.Data.Name : ast->TypeName().Name.Data.Name;
+}
+
+// Hands out the dependency of 'frame.Node' numbered 'frame.Step', children in source order and a name's declaration.
+// False once there are none left, 'Waiting' is then still the last one. Null dependencies are skipped by the caller
+static bool NextDependency(ResolveFrame& frame, ResolveDemand* demand) {
+    Ast* ast       = frame.Node;
+    u32 step       = frame.Step++;
+    Ast* waiting   = nullptr;
+    AstType** slot = nullptr;
+
+    switch (ast->Kind) {
+        case AstKind::Declaration: {
+            if (step == 0) {
+                slot = &ast->Declaration().Type;
+            } else if (step == 1) {
+                waiting = ast->Declaration().Value;
+            } else {
+                return false;
+            }
+        } break;
+
+        case AstKind::File: {
+            if (step != 0) {
+                return false;
+            }
+            waiting = ast->File().Scope;
+        } break;
+
+        case AstKind::Scope: {
+            AstScopeData& scope = ast->Scope();
+            if (step < scope.ExtraVariablesInScope.Length) {
+                waiting = scope.ExtraVariablesInScope[step];
+            } else if (step < scope.ExtraVariablesInScope.Length + scope.Statements.Length) {
+                waiting = scope.Statements[step - scope.ExtraVariablesInScope.Length];
+                if (demand != nullptr && ast == demand->TopLevel && Ast_IsDeclaration(waiting) &&
+                    waiting->Declaration().Constant) {
+                    waiting = nullptr;
+                }
+            } else {
+                return false;
+            }
+        } break;
+
+        case AstKind::Name:
+        case AstKind::TypeName: {
+            Symbol name = GetReferencedName(ast);
+            if (step != 0 || Resolve_IsBuiltinName(name)) {
+                return false;
+            }
+            waiting = Resolve_FindDeclaration(ast, name);
+        } break;
+
+        case AstKind::Procedure: {
+            AstProcedureData& procedure = ast->Procedure();
+            if (step < procedure.Arguments.Length) {
+                waiting = procedure.Arguments[step];
+            } else if (step == procedure.Arguments.Length) {
+                slot = &procedure.ReturnType;
+            } else if (step == procedure.Arguments.Length + 1) {
+                waiting = procedure.Body;
+            } else {
+                return false;
+            }
+        } break;
+
+        // The operand of INT64_MIN written out is no int on its own, FinishUnary folds both at once
+        case AstKind::Unary: {
+            if (step != 0 || Const_IsNegatedMinimum(ast->Unary().Operator.Kind, ast->Unary().Operand)) {
+                return false;
+            }
+            waiting = ast->Unary().Operand;
+        } break;
+
+        case AstKind::Binary: {
+            if (step == 0) {
+                waiting = ast->Binary().Left;
+            } else if (step == 1) {
+                waiting = ast->Binary().Right;
+            } else {
+                return false;
+            }
+        } break;
+
+        case AstKind::TypePointer: {
+            if (step != 0) {
+                return false;
+            }
+            slot = &ast->TypePointer().PointerTo;
+        } break;
+
+        case AstKind::TypeDeref: {
+            if (step != 0) {
+                return false;
+            }
+            slot = &ast->TypeDeref().DerefedType;
+        } break;
+
+        case AstKind::TypeProcedure: {
+            AstTypeProcedureData& type = ast->TypeProcedure();
+            if (step < type.Arguments.Length) {
+                slot = &type.Arguments[step];
+            } else if (step == type.Arguments.Length) {
+                slot = &type.ReturnType;
+            } else {
+                return false;
+            }
+        } break;
+
+        case AstKind::IntegerLiteral:
+        case AstKind::FloatLiteral:
+        case AstKind::TypeInteger:
+        case AstKind::TypeFloat:
+        case AstKind::TypeVoid:
+        case AstKind::TypeType:
+            return false;
+
+        case AstKind::_Statement_Begin:
+        case AstKind::_Statement_End:
+        case AstKind::_Expression_Begin:
+        case AstKind::_Expression_End:
+        case AstKind::_Type_Begin:
+        case AstKind::_Type_End:
+            ASSERT(false);
+    }
+
+    frame.Waiting = slot != nullptr ? *slot : waiting;
+    frame.Slot    = slot;
+    return true;
+}
+
+static bool IsNumberType(AstType* type) {
+    return Ast_IsTypeInteger(type) || Ast_IsTypeFloat(type);
+}
+
+// Declarations are complete before the names that refer to them, so their values are folded already
+Ast* Resolve_GetFoldedOperand(Ast* ast) {
+    while (Ast_IsName(ast)) {
+        Symbol name = ast->Name().Identifier.Data.Name;
+        if (Resolve_IsBuiltinName(name)) {
+            return nullptr;
+        }
+        AstDeclaration* declaration = Resolve_FindDeclaration(ast, name);
+        if (declaration == nullptr || !declaration->Declaration().Constant) {
+            return nullptr;
+        }
+        ast = declaration->Declaration().Value;
+    }
+    return Ast_IsIntegerLiteral(ast) || Ast_IsFloatLiteral(ast) ? ast : nullptr;
+}
+
+static ConstValue GetLiteralValue(Ast* literal) {
+    if (Ast_IsIntegerLiteral(literal)) {
+        ConstValue value = {};
+        if (Const_GetIntegerLiteral(literal, value) != EvalStatus::Done) {
+            Error("Integer literal does not fit in an int!");
+        }
+        return value;
+    }
+    return ConstValue_Float(literal->FloatLiteral().Value);
+}
+
+static_assert(sizeof(AstIntegerLiteralData) <= sizeof(AstUnaryData) && sizeof(AstFloatLiteralData) <= sizeof(AstUnaryData),
+              "An operator node has to have room for the literal it is folded into");
+
+// Turns the operator node 'ast' into the literal for what 'status' and 'value' say it comes to. Its type stays the
+// same, and it takes the place of the operator wherever that was, so nothing pointing at it has to change
+static void FoldInto(Ast* ast, EvalStatus status, const ConstValue& value, const Token& operator_) {
+    if (status == EvalStatus::Overflow) {
+        Error("Constant expression overflows!");
+    } else if (status == EvalStatus::DivisionByZero) {
+        Error("Division by zero in constant expression!");
+    } else if (status != EvalStatus::Done) {
+        return;
+    }
+
+    if (value.Kind == ConstKind::Integer) {
+        AstIntegerLiteralData data = { operator_, (u64)value.Integer };
+        ast->Kind                  = AstKind::IntegerLiteral;
+        std::memcpy(&ast->IntegerLiteral(), &data, sizeof(data));
+    } else {
+        AstFloatLiteralData data = { operator_, value.Float };
+        ast->Kind                = AstKind::FloatLiteral;
+        std::memcpy(&ast->FloatLiteral(), &data, sizeof(data));
+    }
+}
+
+// '+' and '-' keep the type of a number, '*' goes through a pointer and '^' makes one
+static void FinishUnary(Ast* ast, bool shared) {
+    AstUnaryData& unary = ast->Unary();
+    if (Const_IsNegatedMinimum(unary.Operator.Kind, unary.Operand)) {
+        ast->Type = GlobalTypes.TypeInt;
+        FoldInto(ast, EvalStatus::Done, ConstValue_Integer(INT64_MIN), unary.Operator);
+        return;
+    }
+
+    AstType* operand    = unary.Operand->Type;
+    switch (unary.Operator.Kind) {
+        case TokenKind::Plus:
+        case TokenKind::Minus: {
+            if (!IsNumberType(operand)) {
+                Error("Operator cannot be applied to this type!");
+            }
+            ast->Type = operand;
+        } break;
+
+        case TokenKind::Asterisk: {
+            if (!Ast_IsTypePointer(operand)) {
+                Error("Unable to deref value that is not pointer!");
+            }
+            ast->Type = operand->TypePointer().PointerTo;
+        } break;
+
+        case TokenKind::Caret: {
+            ast->Type = GetPointer(operand, shared);
+        } break;
+
+        default:
+            ASSERT(false);
+    }
+
+    Ast* literal = Resolve_GetFoldedOperand(unary.Operand);
+    if (literal != nullptr) {
+        ConstValue value  = {};
+        EvalStatus status = Const_ApplyUnary(unary.Operator.Kind, GetLiteralValue(literal), value);
+        FoldInto(ast, status, value, unary.Operator);
+    }
+}
+
+// Both sides have to be the same kind of number, which is what the operator gives but for comparisons
+static void FinishBinary(Ast* ast) {
+    AstBinaryData& binary = ast->Binary();
+    AstType* left         = binary.Left->Type;
+    if (!TypesEqual(left, binary.Right->Type)) {
+        Error("Types not compatible!");
+    }
+    if (!IsNumberType(left)) {
+        Error("Operator cannot be applied to this type!");
+    }
+    bool comparison = GetBinaryOperatorPrecedence(binary.Operator) == OPERATOR_PRECEDENCE_COMPARISON;
+    ast->Type       = comparison ? GlobalTypes.TypeInt : left;
+
+    Ast* leftLiteral  = Resolve_GetFoldedOperand(binary.Left);
+    Ast* rightLiteral = Resolve_GetFoldedOperand(binary.Right);
+    if (leftLiteral != nullptr && rightLiteral != nullptr) {
+        ConstValue value  = {};
+        EvalStatus status = Const_ApplyBinary(
+            binary.Operator.Kind, GetLiteralValue(leftLiteral), GetLiteralValue(rightLiteral), value);
+        FoldInto(ast, status, value, binary.Operator);
+    }
+}
+
+// Gives 'frame.Node' its type once everything it depends on is resolved
+static void FinishNode(ResolveFrame& frame, bool shared) {
+    Ast* ast = frame.Node;
+    switch (ast->Kind) {
+        case AstKind::Declaration: {
+            // Arguments can be given only a type, there is nothing to check it against
+            AstExpression* value = ast->Declaration().Value;
+            if (value != nullptr && ast->Declaration().Type == nullptr) {
+                ast->Declaration().Type = value->Type;
+            } else if (value != nullptr) {
+                if (!TypesEqual(ast->Declaration().Type, value->Type)) {
+                    Error("Types not compatible!");
+                }
+            }
+
+            ast->Type = GlobalTypes.TypeVoid;
+        } break;
+
+        case AstKind::File:
+        case AstKind::Scope: {
+            ast->Type = GlobalTypes.TypeVoid;
+        } break;
+
+        case AstKind::IntegerLiteral: {
+            GetLiteralValue(ast);
+            ast->Type = GlobalTypes.TypeInt;
+        } break;
+
+        case AstKind::FloatLiteral: {
+            ast->Type = GlobalTypes.TypeFloat;
+        } break;
+
+        // The declaration was the one dependency, it is still in 'Waiting'
+        case AstKind::Name:
+        case AstKind::TypeName: {
+            Symbol name = GetReferencedName(ast);
+            if (Resolve_IsBuiltinName(name)) {
+                ast->Type = GetBuiltinType(name);
+            } else if (frame.Waiting != nullptr) {
+                ast->Type = frame.Waiting->Declaration().Type;
+            }
+            if (ast->Type == nullptr) {
+                Error("Could not find name!");
+            }
+        } break;
+
+        case AstKind::Unary: {
+            FinishUnary(ast, shared);
+        } break;
+
+        case AstKind::Binary: {
+            FinishBinary(ast);
+        } break;
+
+        case AstKind::Procedure: {
+            // Most procedures take a few arguments, those never touch the heap
+            SmallArray<AstType*, 8> argumentTypes = SmallArray_Create<AstType*, 8>();
+            for (u64 i = 0; i < ast->Procedure().Arguments.Length; i++) {
+                SmallArray_Add(argumentTypes, ast->Procedure().Arguments[i]->Declaration().Type);
+            }
+            ast->Type = GetProcedure(
+                AstList_Create(argumentTypes.Data(), argumentTypes.Length), ast->Procedure().ReturnType, shared);
+            SmallArray_Destroy(argumentTypes);
+        } break;
+
+        case AstKind::TypePointer: {
+            ast->Type = GlobalTypes.TypeType;
+        } break;
+
+        case AstKind::TypeDeref: {
+            if (!Ast_IsTypePointer(ast->TypeDeref().DerefedType)) {
+                Error("Unable to deref type that is not pointer!");
+            }
+            ast->Type = ast->TypeDeref().DerefedType;
+        } break;
+
+        case AstKind::TypeProcedure:
+        case AstKind::TypeInteger:
+        case AstKind::TypeFloat:
+        case AstKind::TypeVoid:
+        case AstKind::TypeType: {
+            ast->Type = GlobalTypes.TypeType;
+        } break;
+
+        case AstKind::_Statement_Begin:
+        case AstKind::_Statement_End:
+        case AstKind::_Expression_Begin:
+        case AstKind::_Expression_End:
+        case AstKind::_Type_Begin:
+        case AstKind::_Type_End:
+            ASSERT(false);
+    }
+}
+
+void Resolve_PrintName(Ast* declaration) {
+    String name = Interner_GetString(GlobalInterner, declaration->Declaration().Name->Name().Identifier.Data.Name);
+    PrintError("'%.*s'", (u32)name.Length, name.Data);
+}
+
+void ResolveStack_PrintPath(const ResolveStack& stack, u64 first) {
+    for (u64 i = first; i < stack.Length; i++) {
+        Ast* node = stack[i].Node;
+        if (Ast_IsDeclaration(node) && Ast_IsName(node->Declaration().Name)) {
+            Resolve_PrintName(node);
+            PrintError(" -> ");
+        }
+    }
+}
+
+u64 ResolveStack_Find(const ResolveStack& stack, Ast* node) {
+    for (u64 i = 0; i < stack.Length; i++) {
+        if (stack[i].Node == node) {
+            return i;
+        }
+    }
+    return stack.Length;
+}
+
+bool ResolveStack_Push(ResolveStack& stack, Ast* ast, bool shared) {
+    if (shared) {
+        AstCompletion expected = AstCompletion::Incomplete;
+        if (!ast->Completion.compare_exchange_strong(expected, AstCompletion::Completing, std::memory_order_acquire)) {
+            return false;
+        }
+    } else {
+        if (ast->Completion.load(std::memory_order_relaxed) != AstCompletion::Incomplete) {
+            return false;
+        }
+        ast->Completion.store(AstCompletion::Completing, std::memory_order_relaxed);
+    }
+    SmallArray_Add(stack, { ast, 0, false, nullptr, nullptr });
+    return true;
+}
+
+ResolveStatus ResolveStack_Run(ResolveStack& stack, bool shared, ResolveDemand* demand) {
+    while (stack.Length != 0) {
+        ResolveFrame& top = stack[stack.Length - 1];
+        if (top.Blocked) {
+            top.Blocked = false;
+        } else {
+            if (top.Slot != nullptr) {
+                *top.Slot = GetCanonical(*top.Slot, shared);
+            }
+
+            if (!NextDependency(top, demand)) {
+                FinishNode(top, shared);
+                if (demand != nullptr) {
+                    demand->Finished++;
+                    bool topLevel = Ast_IsDeclaration(top.Node) && top.Node->ParentStatement == demand->TopLevel;
+                    demand->FinishedDeclarations += topLevel ? 1 : 0;
+                }
+                // Whoever sees it complete sees its type too
+                top.Node->Completion.store(AstCompletion::Complete, std::memory_order_release);
+                stack.Length--;
+                continue;
+            }
+        }
+
+        Ast* next = top.Waiting;
+        if (next == nullptr) {
+            top.Slot = nullptr;
+            continue;
+        }
+        if (ResolveStack_Push(stack, next, shared)) {
+            continue;
+        }
+
+        AstCompletion completion = next->Completion.load(std::memory_order_acquire);
+        if (completion == AstCompletion::Complete) {
+            continue;
+        }
+
+        // Completing. Only a cycle when it is this stack that is completing it, which it always is when nothing is shared
+        u64 first = ResolveStack_Find(stack, next);
+        if (first == stack.Length) {
+            ASSERT(shared);
+            top.Blocked = true;
+            return ResolveStatus::Blocked;
+        }
+
+        PrintError("Cyclic dependency found!\n");
+        ResolveStack_PrintPath(stack, first);
+        Resolve_PrintName(next);
+        PrintError("\n");
+        return ResolveStatus::Cycle;
+    }
+    return ResolveStatus::Complete;
+}
+
+bool ResolveAst(Ast* ast) {
+    if (ast == nullptr) {
+        return true;
+    }
+
+    ResolveStack stack   = SmallArray_Create<ResolveFrame, RESOLVE_INLINE_DEPTH>();
+    ResolveStatus status = ResolveStatus::Complete;
+    if (ResolveStack_Push(stack, ast, false)) {
+        status = ResolveStack_Run(stack, false, nullptr);
+    }
+    ASSERT(status != ResolveStatus::Blocked);
+
+    SmallArray_Destroy(stack);
+    return status == ResolveStatus::Complete;
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Array.hpp"
+#include "Ast.hpp"
+#include "SmallArray.hpp"
+
+// Resolved types are canonical, see TypeTable, so the same type is always the same node
+inline bool TypesEqual(AstType* a, AstType* b) {
+    return a == b;
+}
+
+// Gives every node under 'ast' its type, exits on the first type error. Takes no C++ stack per level of nesting.
+// A dependency cycle is reported with the declarations around it, then this gives back false and the nodes on it are
+// left incomplete
+bool ResolveAst(Ast* ast);
+
+// The same result as ResolveAst, with each top level declaration resolved as a task on one of 'threadCount' threads.
+// A task that needs a declaration another thread is still completing is parked until it is complete, and a cycle is
+// only reported once every task left waits on another one. In ResolverParallel.cpp
+bool ResolveAstParallel(Ast* ast, u32 threadCount);
+
+struct ResolveDemandStats {
+    u64 Roots;
+    u64 DeclarationsResolved; // Top level ones
+    u64 DeclarationsSkipped;  // Top level ones that were only checked, see ResolveAstOnDemand
+    u64 NodesResolved;
+    u64 NodesChecked;
+    f64 ResolveSeconds;
+    f64 CheckSeconds;
+};
+
+// Resolves only the declarations named 'roots' and what they refer to, for builds that use a few procedures out of a
+// large library. Roots are looked up as the declaration 'ast' is and then among the top level declarations. A reached
+// declaration is resolved whole, but the constant top level declarations wait until a name refers to them. Those no
+// name reaches only have the names in their type, their value or a procedure's arguments and return type looked up;
+// a procedure's body is not looked at. Nothing about them is typed and a cycle among them is not found. In
+// ResolverDemand.cpp
+bool ResolveAstOnDemand(Ast* ast, const Array<Symbol>& roots, ResolveDemandStats& stats);
+
+// What resolving would have cost for the declarations that were only checked, going by what it cost for the others,
+// less what checking them cost. Never below 0. False when skipped declarations have no resolved ones to go by, which
+// is the case whenever the root is the declaration around the rest
+bool ResolveDemandStats_EstimateSaved(const ResolveDemandStats& stats, f64& saved);
+void ResolveDemandStats_Print(const ResolveDemandStats& stats);
+
+// The declaration 'name' refers to where 'ast' is, or null. In the scope 'ast' is in only the statements before its
+// own count, in the scopes around that one all of them do
+AstDeclaration* Resolve_FindDeclaration(Ast* ast, Symbol name);
+
+// 'type', 'void' and 'int', which have no declaration
+bool Resolve_IsBuiltinName(Symbol name);
+
+// The literal 'ast' stands for once it is resolved, following names of constants, or null
+Ast* Resolve_GetFoldedOperand(Ast* ast);
+
+// The scope whose statements are the top level declarations: the file's, or the body of the procedure 'ast' declares.
+// Null when 'ast' is neither
+AstScope* Resolve_FindTopLevelScope(Ast* ast);
+
+// What the two resolvers share
+
+#define RESOLVE_INLINE_DEPTH 64
+
+// A node being resolved and how far it has got. Nodes wait for what they depend on here instead of on the C++ stack,
+// so how deep the tree goes only changes how long this gets
+struct ResolveFrame {
+    Ast* Node;
+    u32 Step;       // How many of its dependencies have been handed out
+    bool Blocked;   // 'Waiting' was being completed by another thread, and has to be tried again
+    Ast* Waiting;   // The last of them
+    AstType** Slot; // Where 'Waiting' is when it is a written type, swapped for the canonical type once it is resolved
+};
+
+using ResolveStack = SmallArray<ResolveFrame, RESOLVE_INLINE_DEPTH>;
+
+enum struct ResolveStatus {
+    Complete, // Everything on the stack is, and it is empty
+    Blocked,  // The top frame waits on a node another thread is completing, running the stack again tries it again
+    Cycle,    // Reported already, the stack is left as it was
+};
+
+// Set when resolving on demand, the constant top level declarations are handed out only when a name refers to them
+struct ResolveDemand {
+    AstScope* TopLevel;
+    u64 Finished;             // Nodes
+    u64 FinishedDeclarations; // Of the top level
+};
+
+// Claims 'ast' and puts it on 'stack', false when it is complete or someone else has claimed it
+bool ResolveStack_Push(ResolveStack& stack, Ast* ast, bool shared);
+
+// Resolves until the stack is empty. 'shared' is for when other threads resolve the same tree at the same time: nodes
+// are claimed with a compare and swap, the type table is locked around every lookup, and a node that is completing
+// but not on this stack blocks instead of being a cycle. 'demand' is null unless resolving on demand
+ResolveStatus ResolveStack_Run(ResolveStack& stack, bool shared, ResolveDemand* demand);
+
+// Where 'node' is on 'stack', or its length
+u64 ResolveStack_Find(const ResolveStack& stack, Ast* node);
+
+// Names the declarations of the frames from 'first' up, each followed by ' -> '. Cycle reports end with the name
+// they started at, which is what Resolve_PrintName is for
+void ResolveStack_PrintPath(const ResolveStack& stack, u64 first);
+void Resolve_PrintName(Ast* declaration);
@@ -0,0 +1,164 @@
+#include "Resolver.hpp"
+#include "Evaluator.hpp"
+
+#include <chrono>
+
+// The declaration the entry point 'name' is, or null
+static AstDeclaration* FindRoot(Ast* ast, Symbol name) {
+    if (Ast_IsDeclaration(ast) && Ast_IsName(ast->Declaration().Name) &&
+        ast->Declaration().Name->Name().Identifier.Data.Name == name) {
+        return ast;
+    }
+
+    AstScope* topLevel = Resolve_FindTopLevelScope(ast);
+    if (topLevel == nullptr) {
+        return nullptr;
+    }
+    // Arguments are in the table too, they are not entry points
+    const AstScopeSymbol* symbol = AstScope_FindSymbol(topLevel, name);
+    return symbol != nullptr && symbol->Ordinal != 0 ? symbol->Declaration : nullptr;
+}
+
+// What a top level declaration no name reached gets instead of being resolved: every name in what it declares has to
+// be declared where it is used, and every integer literal has to be an int. A procedure's body is not looked at,
+// nothing is typed and none of the names is followed
+struct DemandCheckPass : AstVisitor<DemandCheckPass> {
+    u64 Nodes         = 0;
+    Ast* DeclaredName = nullptr; // Is not looked up
+    Ast* Minimum      = nullptr; // 2^63 right after a '-', which is INT64_MIN
+
+    void EnterNode(Ast* node) {
+        this->Nodes++;
+    }
+
+    void EnterDeclaration(AstDeclaration* node) {
+        this->DeclaredName = node->Declaration().Name;
+    }
+
+    void EnterName(AstName* node) {
+        if (node != this->DeclaredName) {
+            Check(node, node->Name().Identifier.Data.Name);
+        }
+    }
+
+    void EnterTypeName(AstTypeName* node) {
+        Check(node, node->TypeName().Name.Data.Name);
+    }
+
+    void EnterUnary(AstUnary* node) {
+        if (Const_IsNegatedMinimum(node->Unary().Operator.Kind, node->Unary().Operand)) {
+            this->Minimum = node->Unary().Operand;
+        }
+    }
+
+    void EnterIntegerLiteral(AstIntegerLiteral* node) {
+        ConstValue value = {};
+        if (node != this->Minimum && Const_GetIntegerLiteral(node, value) != EvalStatus::Done) {
+            Error("Integer literal does not fit in an int!");
+        }
+    }
+
+    static void Check(Ast* node, Symbol name) {
+        if (!Resolve_IsBuiltinName(name) && Resolve_FindDeclaration(node, name) == nullptr) {
+            Error("Could not find name!");
+        }
+    }
+
+    void CheckStatement(AstStatement* statement) {
+        if (!Ast_IsDeclaration(statement)) {
+            this->Walk(statement);
+            return;
+        }
+
+        AstExpression* value = statement->Declaration().Value;
+        this->Walk(statement->Declaration().Type);
+        if (value != nullptr && Ast_IsProcedure(value)) {
+            for (u64 i = 0; i < value->Procedure().Arguments.Length; i++) {
+                this->Walk(value->Procedure().Arguments[i]);
+            }
+            this->Walk(value->Procedure().ReturnType);
+        } else {
+            this->Walk(value);
+        }
+    }
+};
+
+bool ResolveAstOnDemand(Ast* ast, const Array<Symbol>& roots, ResolveDemandStats& stats) {
+    stats = {};
+    if (ast == nullptr) {
+        return true;
+    }
+
+    auto start           = std::chrono::steady_clock::now();
+    ResolveDemand demand = { Resolve_FindTopLevelScope(ast), 0, 0 };
+    ResolveStack stack   = SmallArray_Create<ResolveFrame, RESOLVE_INLINE_DEPTH>();
+    ResolveStatus status = ResolveStatus::Complete;
+    for (u64 i = 0; i < roots.Length && status == ResolveStatus::Complete; i++) {
+        AstDeclaration* root = FindRoot(ast, roots[i]);
+        if (root == nullptr) {
+            String name = Interner_GetString(GlobalInterner, roots[i]);
+            Error("Could not find entry point '%.*s'!", (u32)name.Length, name.Data);
+        }
+
+        stats.Roots++;
+        if (ResolveStack_Push(stack, root, false)) {
+            status = ResolveStack_Run(stack, false, &demand);
+        }
+    }
+    ASSERT(status != ResolveStatus::Blocked);
+    SmallArray_Destroy(stack);
+
+    auto checkStart            = std::chrono::steady_clock::now();
+    stats.ResolveSeconds       = std::chrono::duration<f64>(checkStart - start).count();
+    stats.NodesResolved        = demand.Finished;
+    stats.DeclarationsResolved = demand.FinishedDeclarations;
+
+    // Whatever is left of the top level, which is all of it when the roots are in it rather than the declaration
+    // around it
+    if (status == ResolveStatus::Complete && demand.TopLevel != nullptr) {
+        DemandCheckPass check;
+        AstList<AstStatement*> statements = demand.TopLevel->Scope().Statements;
+        for (u64 i = 0; i < statements.Length; i++) {
+            if (statements[i]->Completion.load(std::memory_order_relaxed) == AstCompletion::Incomplete) {
+                check.CheckStatement(statements[i]);
+                stats.DeclarationsSkipped++;
+            }
+        }
+        stats.NodesChecked = check.Nodes;
+    }
+    stats.CheckSeconds = std::chrono::duration<f64>(std::chrono::steady_clock::now() - checkStart).count();
+
+    return status == ResolveStatus::Complete;
+}
+
+bool ResolveDemandStats_EstimateSaved(const ResolveDemandStats& stats, f64& saved) {
+    saved = 0.0;
+    if (stats.DeclarationsSkipped == 0) {
+        return true;
+    }
+    if (stats.DeclarationsResolved == 0) {
+        return false;
+    }
+
+    f64 resolve = stats.ResolveSeconds * (f64)stats.DeclarationsSkipped / (f64)stats.DeclarationsResolved;
+    // Checking can cost more than what resolving is guessed to, then nothing was saved
+    saved = resolve > stats.CheckSeconds ? resolve - stats.CheckSeconds : 0.0;
+    return true;
+}
+
+void ResolveDemandStats_Print(const ResolveDemandStats& stats) {
+    PrintError("\nDemand Stats:\n");
+    PrintError("Entry Points: %llu\n", stats.Roots);
+    PrintError("Top Level Declarations Resolved: %llu\n", stats.DeclarationsResolved);
+    PrintError("Top Level Declarations Skipped: %llu\n", stats.DeclarationsSkipped);
+    PrintError("Nodes Resolved: %llu\n", stats.NodesResolved);
+    PrintError("Nodes Only Checked: %llu\n", stats.NodesChecked);
+    PrintError("Resolving: %.3f ms\n", stats.ResolveSeconds * 1e3);
+    PrintError("Checking: %.3f ms\n", stats.CheckSeconds * 1e3);
+    f64 saved = 0.0;
+    if (ResolveDemandStats_EstimateSaved(stats, saved)) {
+        PrintError("Estimated Time Saved: %.3f ms\n", saved * 1e3);
+    } else {
+        PrintError("Estimated Time Saved: unknown\n");
+    }
+}
@@ -0,0 +1,241 @@
+#include "Resolver.hpp"
+
+#include <mutex>
+#include <thread>
+
+#define RESOLVE_MAX_THREADS 64
+
+// The statements a thread has left to start, as a range packed into one word so it can be taken from with a single
+// compare and swap. The owner takes from the front, thieves take the back half
+struct alignas(64) ResolveWorker {
+    std::atomic<u64> Range;
+};
+
+static u64 Range_Pack(u32 begin, u32 end) {
+    return (u64)begin | ((u64)end << 32);
+}
+
+static u32 Range_Begin(u64 range) {
+    return (u32)range;
+}
+
+static u32 Range_End(u64 range) {
+    return (u32)(range >> 32);
+}
+
+struct ResolvePool {
+    AstList<AstStatement*> Tasks;
+    ResolveWorker Workers[RESOLVE_MAX_THREADS];
+    u32 WorkerCount;
+    // Threads that are running a task or looking for one, so none can be on the way while a thread decides it is done
+    std::atomic<u32> Running;
+    std::atomic<bool> Stopped;
+
+    std::mutex ParkedLock;
+    // Tasks whose top frame waits on a node another task is completing
+    Array<ResolveStack> Parked;
+    bool Failed;
+};
+
+static bool ResolvePool_TakeOwn(ResolvePool& pool, u32 index, u32& task) {
+    ResolveWorker& worker = pool.Workers[index];
+    u64 range             = worker.Range.load(std::memory_order_relaxed);
+    while (Range_Begin(range) < Range_End(range)) {
+        u64 rest = Range_Pack(Range_Begin(range) + 1, Range_End(range));
+        if (worker.Range.compare_exchange_weak(range, rest, std::memory_order_relaxed)) {
+            task = Range_Begin(range);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Takes the back half of the first range that is not empty, runs its first task and keeps the rest as its own
+static bool ResolvePool_Steal(ResolvePool& pool, u32 index, u32& task) {
+    for (u32 i = 1; i < pool.WorkerCount; i++) {
+        ResolveWorker& victim = pool.Workers[(index + i) % pool.WorkerCount];
+        u64 range             = victim.Range.load(std::memory_order_relaxed);
+        while (Range_Begin(range) < Range_End(range)) {
+            u32 middle = Range_Begin(range) + (Range_End(range) - Range_Begin(range)) / 2;
+            if (victim.Range.compare_exchange_weak(range, Range_Pack(Range_Begin(range), middle), std::memory_order_relaxed)) {
+                pool.Workers[index].Range.store(Range_Pack(middle + 1, Range_End(range)), std::memory_order_relaxed);
+                task = middle;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+static bool ResolvePool_RangesEmpty(ResolvePool& pool) {
+    for (u32 i = 0; i < pool.WorkerCount; i++) {
+        u64 range = pool.Workers[i].Range.load(std::memory_order_relaxed);
+        if (Range_Begin(range) < Range_End(range)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool Parked_IsReady(const ResolveStack& stack) {
+    Ast* waiting = stack[stack.Length - 1].Waiting;
+    return waiting->Completion.load(std::memory_order_acquire) == AstCompletion::Complete;
+}
+
+// Swaps 'stack', which is empty, for a parked one that can go on
+static bool ResolvePool_Resume(ResolvePool& pool, ResolveStack& stack) {
+    std::lock_guard<std::mutex> lock(pool.ParkedLock);
+    for (u64 i = 0; i < pool.Parked.Length; i++) {
+        if (Parked_IsReady(pool.Parked[i])) {
+            SmallArray_Destroy(stack);
+            stack          = pool.Parked[i];
+            pool.Parked[i] = pool.Parked[pool.Parked.Length - 1];
+            pool.Parked.Length--;
+            return true;
+        }
+    }
+    return false;
+}
+
+static u64 Parked_FindOwner(const ResolvePool& pool, Ast* node) {
+    for (u64 i = 0; i < pool.Parked.Length; i++) {
+        if (ResolveStack_Find(pool.Parked[i], node) != pool.Parked[i].Length) {
+            return i;
+        }
+    }
+    ASSERT(false);
+    return 0;
+}
+
+// Nothing runs and every parked task waits on a node another one is completing. Following who waits on whom from any
+// of them has to come around to a task it has seen, and from there it goes around the cycle
+static void ResolvePool_ReportCycle(ResolvePool& pool) {
+    Array<u8> seen = Array_Create<u8>(pool.Parked.Length);
+    for (u64 i = 0; i < pool.Parked.Length; i++) {
+        Array_Add(seen, (u8)0);
+    }
+
+    u64 task = 0;
+    while (seen[task] == 0) {
+        seen[task] = 1;
+        task       = Parked_FindOwner(pool, pool.Parked[task][pool.Parked[task].Length - 1].Waiting);
+    }
+
+    // 'task' is on the cycle, the path starts at the node it waits on
+    Ast* repeated = pool.Parked[task][pool.Parked[task].Length - 1].Waiting;
+    Ast* entry    = repeated;
+    u64 first     = Parked_FindOwner(pool, repeated);
+    u64 current   = first;
+    PrintError("Cyclic dependency found!\n");
+    do {
+        const ResolveStack& stack = pool.Parked[current];
+        ResolveStack_PrintPath(stack, ResolveStack_Find(stack, entry));
+        entry   = stack[stack.Length - 1].Waiting;
+        current = Parked_FindOwner(pool, entry);
+    } while (current != first);
+    Resolve_PrintName(repeated);
+    PrintError("\n");
+
+    Array_Destroy(seen);
+}
+
+// Called by a thread that found nothing to do. Decides whether everything is done, or stuck on a cycle
+static void ResolvePool_Idle(ResolvePool& pool) {
+    {
+        std::lock_guard<std::mutex> lock(pool.ParkedLock);
+        // Ranges only ever get emptier and tasks are only parked by running threads, so once both checks pass nothing
+        // can change any more
+        if (ResolvePool_RangesEmpty(pool) && pool.Running.load(std::memory_order_acquire) == 0) {
+            bool ready = false;
+            for (u64 i = 0; i < pool.Parked.Length && !ready; i++) {
+                ready = Parked_IsReady(pool.Parked[i]);
+            }
+
+            if (pool.Parked.Length != 0 && !ready) {
+                ResolvePool_ReportCycle(pool);
+                pool.Failed = true;
+            }
+            if (pool.Parked.Length == 0 || !ready) {
+                pool.Stopped.store(true, std::memory_order_release);
+            }
+            return;
+        }
+    }
+    std::this_thread::yield();
+}
+
+static void ResolvePool_Work(ResolvePool& pool, u32 index) {
+    ResolveStack stack = SmallArray_Create<ResolveFrame, RESOLVE_INLINE_DEPTH>();
+    while (!pool.Stopped.load(std::memory_order_acquire)) {
+        pool.Running.fetch_add(1, std::memory_order_acq_rel);
+
+        // A task whose statement someone else already got to is done without doing anything
+        u32 task     = 0;
+        bool working = false;
+        if (ResolvePool_TakeOwn(pool, index, task) || ResolvePool_Steal(pool, index, task)) {
+            ResolveStack_Push(stack, pool.Tasks[task], true);
+            working = true;
+        } else {
+            working = ResolvePool_Resume(pool, stack);
+        }
+
+        if (working) {
+            ResolveStatus status = ResolveStack_Run(stack, true, nullptr);
+            if (status == ResolveStatus::Blocked) {
+                std::lock_guard<std::mutex> lock(pool.ParkedLock);
+                Array_Add(pool.Parked, stack);
+                stack = SmallArray_Create<ResolveFrame, RESOLVE_INLINE_DEPTH>();
+            } else if (status == ResolveStatus::Cycle) {
+                std::lock_guard<std::mutex> lock(pool.ParkedLock);
+                pool.Failed = true;
+                pool.Stopped.store(true, std::memory_order_release);
+            }
+        }
+
+        pool.Running.fetch_sub(1, std::memory_order_acq_rel);
+        if (!working) {
+            ResolvePool_Idle(pool);
+        }
+    }
+    SmallArray_Destroy(stack);
+}
+
+bool ResolveAstParallel(Ast* ast, u32 threadCount) {
+    AstScope* scope = Resolve_FindTopLevelScope(ast);
+    threadCount     = threadCount < RESOLVE_MAX_THREADS ? threadCount : RESOLVE_MAX_THREADS;
+    if (scope == nullptr || threadCount <= 1 || scope->Scope().Statements.Length < threadCount) {
+        return ResolveAst(ast);
+    }
+
+    ResolvePool pool = {};
+    pool.Tasks       = scope->Scope().Statements;
+    pool.WorkerCount = threadCount;
+    pool.Parked      = Array_Create<ResolveStack>();
+    u64 taskCount    = pool.Tasks.Length;
+    for (u32 i = 0; i < threadCount; i++) {
+        pool.Workers[i].Range.store(Range_Pack((u32)(taskCount * i / threadCount), (u32)(taskCount * (i + 1) / threadCount)),
+                                    std::memory_order_relaxed);
+    }
+
+    // The first worker runs on this thread
+    Array<std::thread> threads = Array_Create<std::thread>(threadCount - 1);
+    for (u32 i = 1; i < threadCount; i++) {
+        Array_Emplace(threads, ResolvePool_Work, std::ref(pool), i);
+    }
+    ResolvePool_Work(pool, 0);
+    for (u64 i = 0; i < threads.Length; i++) {
+        threads[i].join();
+    }
+    Array_Destroy(threads);
+
+    for (u64 i = 0; i < pool.Parked.Length; i++) {
+        SmallArray_Destroy(pool.Parked[i]);
+    }
+    Array_Destroy(pool.Parked);
+    if (pool.Failed) {
+        return false;
+    }
+
+    // Every top level statement is complete, what is left is the nodes around them
+    return ResolveAst(ast);
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Array.hpp"
+
+// An Array that keeps its first N elements inside itself, and only goes to the heap or 'Owner' once there are more.
+// For short lists that are made and thrown away often, like the types of a procedure's arguments.
+// Copying one copies the inline elements, so it is only as copyable as T is relocatable
+template<typename T, u64 N>
+struct SmallArray {
+    T* Spilled   = nullptr; // Where the elements are once there are more than N, unused until then
+    u64 Length   = 0;
+    u64 Capacity = N;
+    Arena* Owner = nullptr;
+    alignas(T) u8 Inline[N * sizeof(T)];
+
+    T* Data() {
+        return this->Capacity > N ? this->Spilled : (T*)this->Inline;
+    }
+
+    const T* Data() const {
+        return this->Capacity > N ? this->Spilled : (const T*)this->Inline;
+    }
+
+    T& operator[](u64 index) {
+        return this->Data()[index];
+    }
+
+    const T& operator[](u64 index) const {
+        return this->Data()[index];
+    }
+};
+
+template<typename T, u64 N>
+SmallArray<T, N> SmallArray_Create() {
+    return {};
+}
+
+template<typename T, u64 N>
+SmallArray<T, N> SmallArray_Create(Arena& arena) {
+    SmallArray<T, N> array = {};
+    array.Owner            = &arena;
+    return array;
+}
+
+template<typename T, u64 N>
+void SmallArray_Destroy(SmallArray<T, N>& array) {
+    T* data = array.Data();
+    for (u64 i = 0; i < array.Length; i++) {
+        data[i].~T();
+    }
+    if (array.Capacity > N) {
+        Array_FreeStorage(array.Owner, MemoryCategory::Arrays, array.Spilled, array.Capacity);
+    }
+    array.Spilled  = nullptr;
+    array.Length   = 0;
+    array.Capacity = N;
+}
+
+template<typename T, u64 N>
+void SmallArray_Clear(SmallArray<T, N>& array) {
+    T* data = array.Data();
+    for (u64 i = 0; i < array.Length; i++) {
+        data[i].~T();
+    }
+    array.Length = 0;
+}
+
+template<typename T, u64 N>
+void SmallArray_Reserve(SmallArray<T, N>& array, u64 capacity) {
+    if (array.Capacity >= capacity) {
+        return;
+    }
+
+    if (array.Capacity > N) {
+        array.Spilled = Array_ResizeStorage(
+            array.Owner, MemoryCategory::Arrays, array.Spilled, array.Length, array.Capacity, capacity);
+    } else {
+        array.Spilled = Array_AllocateStorage<T>(array.Owner, MemoryCategory::Arrays, capacity);
+        Array_Relocate(array.Spilled, (T*)array.Inline, array.Length);
+    }
+    array.Capacity = capacity;
+}
+
+template<typename T, u64 N, typename... Args>
+T& SmallArray_Emplace(SmallArray<T, N>& array, Args&&... args) {
+    if (array.Length >= array.Capacity) {
+        SmallArray_Reserve(array, array.Capacity * 2);
+    }
+
+    T* data = array.Data();
+    new (&data[array.Length]) T(std::forward<Args>(args)...);
+    return data[array.Length++];
+}
+
+template<typename T, u64 N>
+T& SmallArray_AddMove(SmallArray<T, N>& array, T&& value) {
+    return SmallArray_Emplace(array, std::move(value));
+}
+
+template<typename T, u64 N>
+T& SmallArray_Add(SmallArray<T, N>& array, const T& value) {
+    if (array.Length >= array.Capacity) {
+        // 'value' could be one of the elements that are about to move
+        T copy(value);
+        return SmallArray_Emplace(array, std::move(copy));
+    }
+    return SmallArray_Emplace(array, value);
+}
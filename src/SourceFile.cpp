@@ -0,0 +1,159 @@
+#include "SourceFile.hpp"
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static u64 RoundUp(u64 value, u64 alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+static bool SourceFile_Map(SourceFile& file, const char* path) {
+#if defined(_WIN32)
+    HANDLE handle = CreateFileA(
+        path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    // The view cannot be extended with extra pages, so only map files whose last page has room for the padding
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    u64 fileSize = (u64)size.QuadPart;
+    if (RoundUp(fileSize, systemInfo.dwPageSize) - fileSize < SOURCE_PADDING) {
+        CloseHandle(handle);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (mapping == nullptr) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    file.Source        = String((u8*)view, fileSize);
+    file.Mapped        = true;
+    file.MappingHandle = mapping;
+    file.MappingSize   = fileSize;
+    return true;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    // Pipes, devices and empty files cannot be mapped
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+
+    // Reserve zeroed pages for the file plus its padding, then map the file over the front of them
+    u64 fileSize     = (u64)info.st_size;
+    u64 reservedSize = RoundUp(fileSize + SOURCE_PADDING, (u64)sysconf(_SC_PAGESIZE));
+    void* base       = mmap(nullptr, (size_t)reservedSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return false;
+    }
+
+    void* view = mmap(base, (size_t)fileSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0);
+    close(fd);
+    if (view == MAP_FAILED) {
+        munmap(base, (size_t)reservedSize);
+        return false;
+    }
+
+    madvise(view, (size_t)fileSize, MADV_SEQUENTIAL);
+
+    file.Source        = String((u8*)view, fileSize);
+    file.Mapped        = true;
+    file.MappingHandle = nullptr;
+    file.MappingSize   = reservedSize;
+    return true;
+#endif
+}
+
+static bool SourceFile_Read(SourceFile& file, const char* path) {
+    std::FILE* stream = std::fopen(path, "rb");
+    if (stream == nullptr) {
+        return false;
+    }
+
+    // The size is not known up front for pipes, so just keep growing the buffer
+    u64 capacity = 64 * 1024;
+    u64 length   = 0;
+    u8* data     = (u8*)Alloc(Source, capacity);
+    while (true) {
+        if (length + SOURCE_PADDING >= capacity) {
+            data = (u8*)Memory_Reallocate(MemoryCategory::Source, data, capacity, capacity * 2);
+            capacity *= 2;
+        }
+
+        u64 read = std::fread(data + length, sizeof(u8), capacity - length - SOURCE_PADDING, stream);
+        length += read;
+        if (read == 0) {
+            break;
+        }
+    }
+
+    bool failed = std::ferror(stream) != 0;
+    std::fclose(stream);
+    if (failed) {
+        Dealloc(Source, data, capacity);
+        return false;
+    }
+
+    std::memset(data + length, 0, SOURCE_PADDING);
+    file.Source        = String(data, length);
+    file.Mapped        = false;
+    file.MappingHandle = nullptr;
+    file.MappingSize   = 0;
+    file.BufferSize    = capacity;
+    return true;
+}
+
+bool SourceFile_Open(SourceFile& file, const char* path) {
+    file = {};
+    if (SourceFile_Map(file, path)) {
+        // Counted although only the pages that are read end up resident
+        Memory_Track(MemoryCategory::Source, file.MappingSize);
+        return true;
+    }
+    return SourceFile_Read(file, path);
+}
+
+void SourceFile_Close(SourceFile& file) {
+    if (file.Mapped) {
+#if defined(_WIN32)
+        UnmapViewOfFile(file.Source.Data);
+        CloseHandle((HANDLE)file.MappingHandle);
+#else
+        munmap(file.Source.Data, (size_t)file.MappingSize);
+#endif
+        Memory_Untrack(MemoryCategory::Source, file.MappingSize);
+    } else {
+        Dealloc(Source, file.Source.Data, file.BufferSize);
+    }
+    file = {};
+}
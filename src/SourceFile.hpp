@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "String.hpp"
+#include "Memory.hpp"
+
+// Every loaded source is followed by at least this many readable zero bytes, so the lexer can
+// use '\0' as a sentinel and do block loads past the end without bounds checks
+#define SOURCE_PADDING 64
+
+struct SourceFile {
+    String Source;
+    bool Mapped;
+
+    // Whatever the platform needs to unmap the view again
+    void* MappingHandle;
+    u64 MappingSize;
+
+    u64 BufferSize; // Of the heap buffer when the file could not be mapped
+};
+
+// Maps the file read-only when possible, otherwise falls back to reading it into a heap buffer
+bool SourceFile_Open(SourceFile& file, const char* path);
+void SourceFile_Close(SourceFile& file);
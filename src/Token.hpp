@@ -2,51 +2,57 @@
 
 #include "Defines.hpp"
 #include "String.hpp"
+#include "Array.hpp"
+#include "Interner.hpp"
 
-#define TOKEN_KINDS                                       \
-    TOKEN_KIND(EndOfFile, "EndOfFile")                    \
-    TOKEN_KIND_DATA(Error, "Error", String, ErrorMessage) \
-    TOKEN_KIND_DATA(Identifier, "Name", String, Name)     \
-    TOKEN_KIND_DATA(Integer, "Integer", u64, IntValue)    \
-    TOKEN_KIND_DATA(Float, "Float", f64, FloatValue)      \
-                                                          \
-    TOKEN_KIND(LParen, "(")                               \
-    TOKEN_KIND(RParen, ")")                               \
-    TOKEN_KIND(LBrace, "{")                               \
-    TOKEN_KIND(RBrace, "}")                               \
-    TOKEN_KIND(LBracket, "[")                             \
-    TOKEN_KIND(RBracket, "]")                             \
-    TOKEN_KIND(Colon, ":")                                \
-    TOKEN_KIND(Semicolon, ";")                            \
-    TOKEN_KIND(Comma, ",")                                \
-    TOKEN_KIND(Caret, "^")                                \
-                                                          \
-    TOKEN_KIND(Plus, "+")                                 \
-    TOKEN_KIND(Minus, "-")                                \
-    TOKEN_KIND(Asterisk, "*")                             \
-    TOKEN_KIND(Slash, "/")                                \
-    TOKEN_KIND(Percent, "%")                              \
-    TOKEN_KIND(Equals, "=")                               \
-    TOKEN_KIND(ExclamationMark, "!")                      \
-    TOKEN_KIND(LessThan, "<")                             \
-    TOKEN_KIND(GreaterThan, ">")                          \
-                                                          \
-    TOKEN_KIND(PlusEquals, "+=")                          \
-    TOKEN_KIND(MinusEquals, "-=")                         \
-    TOKEN_KIND(AsteriskEquals, "*=")                      \
-    TOKEN_KIND(SlashEquals, "/=")                         \
-    TOKEN_KIND(PercentEquals, "%=")                       \
-    TOKEN_KIND(EqualsEquals, "==")                        \
-    TOKEN_KIND(ExclamationMarkEquals, "!=")               \
-    TOKEN_KIND(LessThanEquals, "<=")                      \
+// TOKEN_KIND_DATA payloads must fit in 4 bytes and are stored in the token itself,
+// TOKEN_KIND_VALUE payloads live in a side table that the token indexes into
+#define TOKEN_KINDS                                     \
+    TOKEN_KIND(EndOfFile, "EndOfFile")                  \
+    TOKEN_KIND(Error, "Error")                          \
+    TOKEN_KIND_DATA(Identifier, "Name", Symbol, Name)   \
+    TOKEN_KIND_VALUE(Integer, "Integer", u64, IntValue) \
+    TOKEN_KIND_VALUE(Float, "Float", f64, FloatValue)   \
+                                                        \
+    TOKEN_KIND(LParen, "(")                             \
+    TOKEN_KIND(RParen, ")")                             \
+    TOKEN_KIND(LBrace, "{")                             \
+    TOKEN_KIND(RBrace, "}")                             \
+    TOKEN_KIND(LBracket, "[")                           \
+    TOKEN_KIND(RBracket, "]")                           \
+    TOKEN_KIND(Colon, ":")                              \
+    TOKEN_KIND(Semicolon, ";")                          \
+    TOKEN_KIND(Comma, ",")                              \
+    TOKEN_KIND(Caret, "^")                              \
+                                                        \
+    TOKEN_KIND(Plus, "+")                               \
+    TOKEN_KIND(Minus, "-")                              \
+    TOKEN_KIND(Asterisk, "*")                           \
+    TOKEN_KIND(Slash, "/")                              \
+    TOKEN_KIND(Percent, "%")                            \
+    TOKEN_KIND(Equals, "=")                             \
+    TOKEN_KIND(ExclamationMark, "!")                    \
+    TOKEN_KIND(LessThan, "<")                           \
+    TOKEN_KIND(GreaterThan, ">")                        \
+                                                        \
+    TOKEN_KIND(PlusEquals, "+=")                        \
+    TOKEN_KIND(MinusEquals, "-=")                       \
+    TOKEN_KIND(AsteriskEquals, "*=")                    \
+    TOKEN_KIND(SlashEquals, "/=")                       \
+    TOKEN_KIND(PercentEquals, "%=")                     \
+    TOKEN_KIND(EqualsEquals, "==")                      \
+    TOKEN_KIND(ExclamationMarkEquals, "!=")             \
+    TOKEN_KIND(LessThanEquals, "<=")                    \
     TOKEN_KIND(GreaterThanEquals, ">=")
 
 enum struct TokenKind : u8 {
-#define TOKEN_KIND(name, str)                          name,
-#define TOKEN_KIND_DATA(name, str, dataType, dataName) name,
+#define TOKEN_KIND(name, str)                           name,
+#define TOKEN_KIND_DATA(name, str, dataType, dataName)  name,
+#define TOKEN_KIND_VALUE(name, str, dataType, dataName) name,
     TOKEN_KINDS
 #undef TOKEN_KIND
 #undef TOKEN_KIND_DATA
+#undef TOKEN_KIND_VALUE
 };
 
 inline String GetTokenKindName(TokenKind kind) {
@@ -54,64 +60,133 @@ inline String GetTokenKindName(TokenKind kind) {
 #define TOKEN_KIND(name, str) \
     case TokenKind::name:     \
         return str;
-#define TOKEN_KIND_DATA(name, str, dataType, dataName) TOKEN_KIND(name, str)
+#define TOKEN_KIND_DATA(name, str, dataType, dataName)  TOKEN_KIND(name, str)
+#define TOKEN_KIND_VALUE(name, str, dataType, dataName) TOKEN_KIND(name, str)
         TOKEN_KINDS
 #undef TOKEN_KIND
 #undef TOKEN_KIND_DATA
+#undef TOKEN_KIND_VALUE
     }
 
     Error("Unknown token kind!");
 }
 
+union TokenValue {
+#define TOKEN_KIND(name, str)
+#define TOKEN_KIND_DATA(name, str, dataType, dataName)
+#define TOKEN_KIND_VALUE(name, str, dataType, dataName) dataType dataName;
+    TOKEN_KINDS
+#undef TOKEN_KIND
+#undef TOKEN_KIND_DATA
+#undef TOKEN_KIND_VALUE
+};
+
+// Line and column are not stored, they come from the lexer's line table when needed
 struct Token {
     TokenKind Kind;
-    u64 Position;
-    u64 Line;
-    u64 Column;
-    u64 Length;
+    u32 Position;
+    u32 Length;
 
     union {
 #define TOKEN_KIND(name, str)
 #define TOKEN_KIND_DATA(name, str, dataType, dataName) dataType dataName;
+#define TOKEN_KIND_VALUE(name, str, dataType, dataName)
         TOKEN_KINDS
 #undef TOKEN_KIND
 #undef TOKEN_KIND_DATA
+#undef TOKEN_KIND_VALUE
+        u32 ValueIndex;
     } Data;
 };
 
+static_assert(sizeof(Token) <= 16, "Tokens should stay small");
+
 #define TOKEN_KIND(name, str)                        \
     inline bool Token_Is##name(const Token& token) { \
         return token.Kind == TokenKind::name;        \
     }
-#define TOKEN_KIND_DATA(name, str, dataType, dataName) TOKEN_KIND(name, str)
+#define TOKEN_KIND_DATA(name, str, dataType, dataName)  TOKEN_KIND(name, str)
+#define TOKEN_KIND_VALUE(name, str, dataType, dataName) TOKEN_KIND(name, str)
 TOKEN_KINDS
 #undef TOKEN_KIND
 #undef TOKEN_KIND_DATA
+#undef TOKEN_KIND_VALUE
 
-#define TOKEN_KIND(name, str)                                                         \
-    inline Token Token_Create##name(u64 position, u64 line, u64 column, u64 length) { \
-        Token token    = {};                                                          \
-        token.Kind     = TokenKind::name;                                             \
-        token.Position = position;                                                    \
-        token.Line     = line;                                                        \
-        token.Column   = column;                                                      \
-        token.Length   = length;                                                      \
-        return token;                                                                 \
+#define TOKEN_KIND(name, str)                                   \
+    inline Token Token_Create##name(u32 position, u32 length) { \
+        Token token    = {};                                    \
+        token.Kind     = TokenKind::name;                       \
+        token.Position = position;                              \
+        token.Length   = length;                                \
+        return token;                                           \
+    }
+#define TOKEN_KIND_DATA(name, str, dataType, dataName)                               \
+    static_assert(sizeof(dataType) <= sizeof(u32), "Too big, use TOKEN_KIND_VALUE"); \
+    inline Token Token_Create##name(u32 position, u32 length, dataType dataName) {   \
+        Token token         = {};                                                    \
+        token.Kind          = TokenKind::name;                                       \
+        token.Position      = position;                                              \
+        token.Length        = length;                                                \
+        token.Data.dataName = dataName;                                              \
+        return token;                                                                \
     }
-#define TOKEN_KIND_DATA(name, str, dataType, dataName)                                                   \
-    inline Token Token_Create##name(u64 position, u64 line, u64 column, u64 length, dataType dataName) { \
-        Token token         = {};                                                                        \
-        token.Kind          = TokenKind::name;                                                           \
-        token.Position      = position;                                                                  \
-        token.Line          = line;                                                                      \
-        token.Column        = column;                                                                    \
-        token.Length        = length;                                                                    \
-        token.Data.dataName = dataName;                                                                  \
-        return token;                                                                                    \
+#define TOKEN_KIND_VALUE(name, str, dataType, dataName)                                                       \
+    inline Token Token_Create##name(u32 position, u32 length, dataType dataName, Array<TokenValue>& values) { \
+        Token token           = {};                                                                           \
+        token.Kind            = TokenKind::name;                                                              \
+        token.Position        = position;                                                                     \
+        token.Length          = length;                                                                       \
+        token.Data.ValueIndex = (u32)values.Length;                                                           \
+        Array_Add(values, TokenValue {}).dataName = dataName;                                                 \
+        return token;                                                                                         \
+    }                                                                                                         \
+    inline dataType Token_Get##dataName(const Token& token, const Array<TokenValue>& values) {                \
+        ASSERT(token.Kind == TokenKind::name);                                                                \
+        return values[token.Data.ValueIndex].dataName;                                                        \
     }
 TOKEN_KINDS
 #undef TOKEN_KIND
 #undef TOKEN_KIND_DATA
+#undef TOKEN_KIND_VALUE
+
+// How tightly an operator binds, 0 for tokens that are not one. The resolver types binary operators by their class,
+// the comparisons give an int whatever they compare
+#define OPERATOR_PRECEDENCE_COMPARISON 1
+
+inline u64 GetUnaryOperatorPrecedence(const Token& token) {
+    switch (token.Kind) {
+        case TokenKind::Plus:
+        case TokenKind::Minus:
+        case TokenKind::Asterisk:
+        case TokenKind::Caret:
+            return 4;
+
+        default:
+            return 0;
+    }
+}
+
+inline u64 GetBinaryOperatorPrecedence(const Token& token) {
+    switch (token.Kind) {
+        case TokenKind::Asterisk:
+        case TokenKind::Slash:
+        case TokenKind::Percent:
+            return 3;
+
+        case TokenKind::Plus:
+        case TokenKind::Minus:
+            return 2;
+
+        case TokenKind::LessThan:
+        case TokenKind::LessThanEquals:
+        case TokenKind::GreaterThan:
+        case TokenKind::GreaterThanEquals:
+            return OPERATOR_PRECEDENCE_COMPARISON;
+
+        default:
+            return 0;
+    }
+}
 
 #if !defined(KEEP_TOKEN_KINDS)
     #undef TOKEN_KINDS
@@ -0,0 +1,227 @@
+#include "TypeTable.hpp"
+#include "Interner.hpp"
+
+#define TYPE_TABLE_INITIAL_SLOTS 256
+#define TYPE_TABLE_SIGNED_BIT    (1ULL << 63)
+
+TypeTable GlobalTypes = TypeTable_Create();
+
+// What a type is compared by. Its parts are canonical, so they compare by address
+struct TypeKey {
+    AstKind Kind;
+    u64 Value;
+    AstList<AstType*> Parts;
+};
+
+static TypeKey TypeKey_Create(AstKind kind, u64 value, AstList<AstType*> parts = {}) {
+    TypeKey key = {};
+    key.Kind    = kind;
+    key.Value   = value;
+    key.Parts   = parts;
+    return key;
+}
+
+static TypeKey TypeKey_Of(AstType* type) {
+    switch (type->Kind) {
+        case AstKind::TypePointer:
+            return TypeKey_Create(type->Kind, (u64)type->TypePointer().PointerTo);
+        case AstKind::TypeInteger:
+            return TypeKey_Create(type->Kind,
+                                  type->TypeInteger().Size | (type->TypeInteger().Signed ? TYPE_TABLE_SIGNED_BIT : 0));
+        case AstKind::TypeFloat:
+            return TypeKey_Create(type->Kind, type->TypeFloat().Size);
+        case AstKind::TypeProcedure:
+            return TypeKey_Create(type->Kind, (u64)type->TypeProcedure().ReturnType, type->TypeProcedure().Arguments);
+        default:
+            return TypeKey_Create(type->Kind, 0);
+    }
+}
+
+static bool TypeKey_Equal(const TypeKey& a, const TypeKey& b) {
+    if (a.Kind != b.Kind || a.Value != b.Value || a.Parts.Length != b.Parts.Length) {
+        return false;
+    }
+    for (u64 i = 0; i < a.Parts.Length; i++) {
+        if (a.Parts[i] != b.Parts[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+u32 TypeTable_Hash(AstKind kind, u64 value, const void* parts, u64 partsSize) {
+    u64 header[2] = { (u64)kind, value };
+    u32 hash      = Interner_Hash((const u8*)header, sizeof(header));
+    if (partsSize != 0) {
+        hash ^= Interner_Hash((const u8*)parts, partsSize) * 0x9E3779B1u;
+    }
+    return hash;
+}
+
+static u32 TypeKey_Hash(const TypeKey& key) {
+    return TypeTable_Hash(key.Kind, key.Value, key.Parts.Data, key.Parts.Length * sizeof(AstType*));
+}
+
+static AstType* TypeKey_CreateType(TypeTable& table, const TypeKey& key) {
+    AstType* type = nullptr;
+    switch (key.Kind) {
+        case AstKind::TypeType: {
+            type = Ast_CreateTypeType(table.Nodes, nullptr, nullptr, nullptr, {});
+        } break;
+
+        case AstKind::TypeVoid: {
+            type = Ast_CreateTypeVoid(table.Nodes, nullptr, nullptr, nullptr, {});
+        } break;
+
+        case AstKind::TypePointer: {
+            type = Ast_CreateTypePointer(table.Nodes, nullptr, nullptr, nullptr, { (AstType*)key.Value });
+        } break;
+
+        case AstKind::TypeInteger: {
+            AstTypeIntegerData data = { key.Value & ~TYPE_TABLE_SIGNED_BIT, (key.Value & TYPE_TABLE_SIGNED_BIT) != 0 };
+            type                    = Ast_CreateTypeInteger(table.Nodes, nullptr, nullptr, nullptr, data);
+        } break;
+
+        case AstKind::TypeFloat: {
+            type = Ast_CreateTypeFloat(table.Nodes, nullptr, nullptr, nullptr, { key.Value });
+        } break;
+
+        case AstKind::TypeProcedure: {
+            type = Ast_CreateTypeProcedure(table.Nodes, nullptr, nullptr, nullptr, { key.Parts, (AstType*)key.Value });
+            table.Stats.ProcedureSignatures++;
+        } break;
+
+        default:
+            ASSERT(false);
+    }
+
+    type->Completion.store(AstCompletion::Complete, std::memory_order_relaxed);
+    type->Type = table.TypeType != nullptr ? table.TypeType : type;
+    return type;
+}
+
+static TypeTableSlot* TypeTable_AllocateSlots(u64 slotCount) {
+    return (TypeTableSlot*)Memory_AllocateZeroed(MemoryCategory::Types, slotCount * sizeof(TypeTableSlot));
+}
+
+static void TypeTable_Rehash(TypeTable& table, u64 slotCount) {
+    TypeTableSlot* slots = TypeTable_AllocateSlots(slotCount);
+    u64 mask             = slotCount - 1;
+
+    for (u64 i = 0; i < table.SlotCount; i++) {
+        TypeTableSlot slot = table.Slots[i];
+        if (slot.Type == nullptr) {
+            continue;
+        }
+
+        u64 index = slot.Hash & mask;
+        while (slots[index].Type != nullptr) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = slot;
+    }
+
+    Dealloc(Types, table.Slots, table.SlotCount * sizeof(TypeTableSlot));
+    table.Slots     = slots;
+    table.SlotCount = slotCount;
+}
+
+static AstType* TypeTable_Get(TypeTable& table, const TypeKey& key) {
+    u32 hash = TypeKey_Hash(key);
+    u64 mask = table.SlotCount - 1;
+
+    table.Stats.Lookups++;
+
+    u64 probes = 1;
+    for (u64 index = hash & mask;; index = (index + 1) & mask, probes++) {
+        TypeTableSlot& slot = table.Slots[index];
+
+        if (slot.Type == nullptr) {
+            slot.Hash = hash;
+            slot.Type = TypeKey_CreateType(table, key);
+
+            table.Stats.DistinctTypes++;
+            table.Stats.TotalProbes += probes;
+            if (probes > table.Stats.MaxProbeLength) {
+                table.Stats.MaxProbeLength = probes;
+            }
+
+            AstType* type = slot.Type;
+            // Keep the load factor at or under one half
+            if (table.Stats.DistinctTypes * 2 > table.SlotCount) {
+                TypeTable_Rehash(table, table.SlotCount * 2);
+            }
+            return type;
+        }
+
+        if (slot.Hash == hash && TypeKey_Equal(TypeKey_Of(slot.Type), key)) {
+            table.Stats.TotalProbes += probes;
+            if (probes > table.Stats.MaxProbeLength) {
+                table.Stats.MaxProbeLength = probes;
+            }
+            return slot.Type;
+        }
+    }
+}
+
+static void TypeTable_AddBuiltins(TypeTable& table) {
+    // TypeType first, every other type is of type TypeType
+    table.TypeType  = nullptr;
+    table.TypeType  = TypeTable_Get(table, TypeKey_Create(AstKind::TypeType, 0));
+    table.TypeVoid  = TypeTable_Get(table, TypeKey_Create(AstKind::TypeVoid, 0));
+    table.TypeInt   = TypeTable_GetInteger(table, 0, true);
+    table.TypeFloat = TypeTable_GetFloat(table, 0);
+}
+
+TypeTable TypeTable_Create() {
+    TypeTable table = {};
+    table.Nodes     = Arena_Create(MemoryCategory::Types, 64 * 1024);
+    table.Slots     = TypeTable_AllocateSlots(TYPE_TABLE_INITIAL_SLOTS);
+    table.SlotCount = TYPE_TABLE_INITIAL_SLOTS;
+    TypeTable_AddBuiltins(table);
+    return table;
+}
+
+void TypeTable_Destroy(TypeTable& table) {
+    Arena_Destroy(table.Nodes);
+    Dealloc(Types, table.Slots, table.SlotCount * sizeof(TypeTableSlot));
+    table = {};
+}
+
+void TypeTable_Reset(TypeTable& table) {
+    Arena_Reset(table.Nodes);
+    std::memset(table.Slots, 0, table.SlotCount * sizeof(TypeTableSlot));
+    table.Stats = {};
+    TypeTable_AddBuiltins(table);
+}
+
+AstType* TypeTable_GetPointer(TypeTable& table, AstType* pointerTo) {
+    return TypeTable_Get(table, TypeKey_Create(AstKind::TypePointer, (u64)pointerTo));
+}
+
+AstType* TypeTable_GetInteger(TypeTable& table, u64 size, bool isSigned) {
+    return TypeTable_Get(table, TypeKey_Create(AstKind::TypeInteger, size | (isSigned ? TYPE_TABLE_SIGNED_BIT : 0)));
+}
+
+AstType* TypeTable_GetFloat(TypeTable& table, u64 size) {
+    return TypeTable_Get(table, TypeKey_Create(AstKind::TypeFloat, size));
+}
+
+AstType* TypeTable_GetProcedure(TypeTable& table, AstList<AstType*> arguments, AstType* returnType) {
+    return TypeTable_Get(table, TypeKey_Create(AstKind::TypeProcedure, (u64)returnType, arguments));
+}
+
+AstType* TypeTable_GetCanonical(TypeTable& table, AstType* type) {
+    if (type == nullptr) {
+        return nullptr;
+    }
+
+    switch (type->Kind) {
+        case AstKind::TypeName:
+        case AstKind::TypeDeref:
+            return type->Type;
+
+        default:
+            return TypeTable_Get(table, TypeKey_Of(type));
+    }
+}
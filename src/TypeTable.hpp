@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Defines.hpp"
+#include "Arena.hpp"
+#include "Ast.hpp"
+
+// Holds one canonical node for every distinct type, so two types are the same exactly when they are the same node.
+// Types are looked up by their structure, and the types they are made of have to be canonical already.
+// Canonical nodes are complete, have no parents, and their own type is TypeType
+
+struct TypeTableSlot {
+    u32 Hash;
+    AstType* Type; // Null for an empty slot
+};
+
+struct TypeTableStats {
+    u64 DistinctTypes; // Including the 4 built in ones
+    u64 ProcedureSignatures;
+    u64 Lookups;
+    u64 TotalProbes;
+    u64 MaxProbeLength;
+};
+
+struct TypeTable {
+    Arena Nodes;
+    TypeTableSlot* Slots;
+    u64 SlotCount; // Always a power of 2
+
+    AstTypeType* TypeType;
+    AstTypeVoid* TypeVoid;
+    AstTypeInteger* TypeInt;
+    AstTypeFloat* TypeFloat;
+
+    TypeTableStats Stats;
+};
+
+TypeTable TypeTable_Create();
+void TypeTable_Destroy(TypeTable& table);
+
+// Forgets every type but the built in ones, keeping the slots and node pages for the next file
+void TypeTable_Reset(TypeTable& table);
+
+AstType* TypeTable_GetPointer(TypeTable& table, AstType* pointerTo);
+AstType* TypeTable_GetInteger(TypeTable& table, u64 size, bool isSigned);
+AstType* TypeTable_GetFloat(TypeTable& table, u64 size);
+AstType* TypeTable_GetProcedure(TypeTable& table, AstList<AstType*> arguments, AstType* returnType);
+
+// The canonical type a resolved type node stands for, names and derefs already know theirs
+AstType* TypeTable_GetCanonical(TypeTable& table, AstType* type);
+
+// Hash of a type from its kind, a value that is not a type, and its parts.
+// Shared with FlatAst, which keeps its own canonical types
+u32 TypeTable_Hash(AstKind kind, u64 value, const void* parts, u64 partsSize);
+
+// The table the resolver puts every type into
+extern TypeTable GlobalTypes;